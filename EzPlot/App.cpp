@@ -1,6 +1,7 @@
 #include "App.h"
 #include "MainFrame.h"
 #include "GUIConsole.h"
+#include "PyDataModule.h"
 #include <wx/wx.h>
 #include <Python.h>
 #include <windows.h>
@@ -29,7 +30,9 @@ bool App::OnInit() {
 	batch.close();
 
 	// NumPy module is not clearing static variables (bug) so it cant be run twice or with debug
+	PyImport_AppendInittab("ezdata", &PyInit_ezdata); // Native data readers
 	Py_Initialize();
+	PyEval_SaveThread(); // GIL is taken with PyLock from here on, also by the loading thread
 	//Py_SetPath(PythonPath.c_str());
 
 	MainFrame* mainFrame = new MainFrame("EzPlot");
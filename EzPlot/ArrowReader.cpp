@@ -0,0 +1,548 @@
+#include "ArrowReader.h"
+#include "ThreadPool.h"
+#include "LoadProgress.h"
+#include <zstd.h>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+namespace {
+
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	const char Magic[] = "ARROW1";
+	const std::size_t MagicSize = 6;
+	const int MaxDepth = 64; // Nesting of field types, deeper schemas are rejected as damaged
+
+	// Type union ids of the Arrow schema (Schema.fbs):
+	enum : std::uint8_t {
+		TypeNull = 1, TypeInt, TypeFloatingPoint, TypeBinary, TypeUtf8, TypeBool, TypeDecimal, TypeDate, TypeTime,
+		TypeTimestamp, TypeInterval, TypeList, TypeStruct, TypeUnion, TypeFixedSizeBinary, TypeFixedSizeList, TypeMap,
+		TypeDuration, TypeLargeBinary, TypeLargeUtf8, TypeLargeList, TypeRunEndEncoded, TypeBinaryView, TypeUtf8View,
+		TypeListView, TypeLargeListView
+	};
+
+	// Message header union ids (Message.fbs):
+	enum : std::uint8_t { HeaderSchema = 1, HeaderDictionaryBatch, HeaderRecordBatch };
+
+	[[noreturn]] void Damaged() {
+		throw std::runtime_error("Damaged Arrow file");
+	}
+
+	// Arrow and flatbuffers are little endian like all platforms EzPlot runs on:
+	template <typename T>
+	T Load(const char* Pos) {
+		T Value;
+		std::memcpy(&Value, Pos, sizeof(T));
+		return Value;
+	}
+
+	void CheckRange(const char* Pos, std::size_t Size, const char* Begin, const char* End) {
+		if (Pos < Begin or Pos > End or Size > static_cast<std::size_t>(End - Pos)) { Damaged(); }
+	}
+
+	double HalfToDouble(std::uint16_t Half) {
+		int Exponent = (Half >> 10) & 0x1F;
+		int Mantissa = Half & 0x3FF;
+		double Value;
+		if (Exponent == 0) { Value = std::ldexp(Mantissa, -24); }
+		else if (Exponent == 31) { Value = Mantissa ? NaN : std::numeric_limits<double>::infinity(); }
+		else { Value = std::ldexp(Mantissa + 1024, Exponent - 25); }
+		return Half & 0x8000 ? -Value : Value;
+	}
+
+	template <typename T>
+	void ConvertValues(const char* Data, std::size_t Rows, double* Out) {
+		for (std::size_t i = 0; i < Rows; i++) {
+			Out[i] = static_cast<double>(Load<T>(Data + i * sizeof(T)));
+		}
+	}
+
+	// Decode one LZ4 block into [Write, OutEnd), matches may reach back to OutBegin (linked blocks):
+	char* DecodeLZ4Block(const char* In, const char* InEnd, char* OutBegin, char* Write, char* OutEnd) {
+		auto Length = [&](std::size_t Value) {
+			if (Value != 15) { return Value; }
+			unsigned char Byte;
+			do {
+				if (In == InEnd) { Damaged(); }
+				Byte = static_cast<unsigned char>(*In++);
+				Value += Byte;
+			} while (Byte == 255);
+			return Value;
+		};
+		while (In < InEnd) {
+			unsigned char Token = static_cast<unsigned char>(*In++);
+			std::size_t Literals = Length(Token >> 4);
+			if (Literals > static_cast<std::size_t>(InEnd - In) or Literals > static_cast<std::size_t>(OutEnd - Write)) { Damaged(); }
+			std::memcpy(Write, In, Literals);
+			In += Literals;
+			Write += Literals;
+			if (In == InEnd) { break; } // The last sequence has no match
+
+			if (InEnd - In < 2) { Damaged(); }
+			std::size_t Offset = static_cast<unsigned char>(In[0]) | static_cast<unsigned char>(In[1]) << 8;
+			In += 2;
+			std::size_t Match = Length(Token & 15) + 4;
+			if (Offset == 0 or Offset > static_cast<std::size_t>(Write - OutBegin) or Match > static_cast<std::size_t>(OutEnd - Write)) {
+				Damaged();
+			}
+			// Matches may overlap the bytes they produce, so they are copied byte by byte:
+			const char* From = Write - Offset;
+			for (std::size_t i = 0; i < Match; i++) { Write[i] = From[i]; }
+			Write += Match;
+		}
+		return Write;
+	}
+
+	void DecompressLZ4Frame(const char* In, const char* InEnd, char* Out, std::size_t Size) {
+		CheckRange(In, 7, In, InEnd);
+		if (Load<std::uint32_t>(In) != 0x184D2204) { Damaged(); }
+		unsigned char Flags = static_cast<unsigned char>(In[4]);
+		if ((Flags >> 6) != 1) { Damaged(); }
+		bool BlockChecksum = Flags & 0x10;
+		In += 7 + (Flags & 0x08 ? 8 : 0) + (Flags & 0x01 ? 4 : 0); // Header with content size and dictionary id
+		char* Write = Out;
+		while (true) {
+			CheckRange(In, 4, In, InEnd);
+			std::uint32_t BlockSize = Load<std::uint32_t>(In);
+			In += 4;
+			if (BlockSize == 0) { break; }
+			bool Stored = BlockSize & 0x80000000u;
+			BlockSize &= 0x7FFFFFFFu;
+			CheckRange(In, BlockSize + (BlockChecksum ? 4 : 0), In, InEnd);
+			if (Stored) {
+				if (BlockSize > static_cast<std::size_t>(Out + Size - Write)) { Damaged(); }
+				std::memcpy(Write, In, BlockSize);
+				Write += BlockSize;
+			}
+			else { Write = DecodeLZ4Block(In, In + BlockSize, Out, Write, Out + Size); }
+			In += BlockSize + (BlockChecksum ? 4 : 0);
+		}
+		if (Write != Out + Size) { Damaged(); }
+	}
+
+}
+
+// Table of the flatbuffers encoded Arrow metadata. Every access is checked against the bounds
+// of the metadata, so a damaged file raises an error instead of reading outside the mapping.
+class ArrowSource::FlatTable {
+public:
+	FlatTable(const char* Pos, const char* Begin, const char* End) : Pos(Pos), Begin(Begin), End(End) {
+		CheckRange(Pos, 4, Begin, End);
+		VTable = Pos - Load<std::int32_t>(Pos);
+		CheckRange(VTable, 4, Begin, End);
+		VSize = Load<std::uint16_t>(VTable);
+		CheckRange(VTable, VSize, Begin, End);
+	}
+
+	static FlatTable Root(const char* Begin, const char* End) {
+		CheckRange(Begin, 4, Begin, End);
+		return FlatTable(Begin + Load<std::uint32_t>(Begin), Begin, End);
+	}
+
+	bool Has(int Field) const { return FieldPos(Field) != nullptr; }
+
+	template <typename T>
+	T Scalar(int Field, T Default) const {
+		const char* Value = FieldPos(Field);
+		if (Value == nullptr) { return Default; }
+		CheckRange(Value, sizeof(T), Begin, End);
+		return Load<T>(Value);
+	}
+
+	FlatTable Table(int Field) const {
+		const char* Value = FieldPos(Field);
+		if (Value == nullptr) { Damaged(); }
+		return FlatTable(Follow(Value), Begin, End);
+	}
+
+	// Elements of a vector field, Count is 0 if the field is missing:
+	const char* Vector(int Field, std::size_t ElementSize, std::size_t& Count) const {
+		Count = 0;
+		const char* Value = FieldPos(Field);
+		if (Value == nullptr) { return nullptr; }
+		const char* Vector = Follow(Value);
+		CheckRange(Vector, 4, Begin, End);
+		Count = Load<std::uint32_t>(Vector);
+		CheckRange(Vector + 4, Count * ElementSize, Begin, End);
+		return Vector + 4;
+	}
+
+	FlatTable TableAt(int Field, std::size_t Index) const {
+		std::size_t Count;
+		const char* Elements = Vector(Field, 4, Count);
+		if (Index >= Count) { Damaged(); }
+		return FlatTable(Follow(Elements + 4 * Index), Begin, End);
+	}
+
+	std::string String(int Field) const {
+		std::size_t Size;
+		const char* Text = Vector(Field, 1, Size);
+		return Text ? std::string(Text, Size) : std::string();
+	}
+
+private:
+	const char* FieldPos(int Field) const {
+		std::size_t Entry = 4 + 2 * static_cast<std::size_t>(Field);
+		if (Entry + 2 > VSize) { return nullptr; }
+		std::uint16_t Offset = Load<std::uint16_t>(VTable + Entry);
+		return Offset == 0 ? nullptr : Pos + Offset;
+	}
+
+	const char* Follow(const char* Value) const {
+		CheckRange(Value, 4, Begin, End);
+		return Value + Load<std::uint32_t>(Value);
+	}
+
+	const char* Pos;
+	const char* Begin;
+	const char* End;
+	const char* VTable;
+	std::uint16_t VSize;
+};
+
+ArrowSource::ArrowSource(const std::filesystem::path& Path) : File(std::make_shared<MappedFile>(Path)) {
+	const char* Data = File->Data();
+	std::size_t Size = File->Size();
+	bool IsFile = Size >= 2 * MagicSize + 6 and std::memcmp(Data, Magic, MagicSize) == 0
+		and std::memcmp(Data + Size - MagicSize, Magic, MagicSize) == 0;
+	if (IsFile) { ReadFooter(); }
+	else { ReadStream(); }
+}
+
+// Message starting at Offset, its body follows at Body and the next message at Next:
+ArrowSource::FlatTable ArrowSource::ReadMessage(std::uint64_t Offset, std::uint64_t& Body, std::uint64_t& Next) const {
+	const char* Data = File->Data();
+	std::size_t Size = File->Size();
+	if (Offset > Size or Size - Offset < 8) { Damaged(); }
+	// Length of the metadata, since Arrow 0.15 after a continuation marker:
+	std::uint64_t Metadata = Offset + 4;
+	std::uint32_t Length = Load<std::uint32_t>(Data + Offset);
+	if (Length == 0xFFFFFFFFu) {
+		Length = Load<std::uint32_t>(Data + Offset + 4);
+		Metadata += 4;
+	}
+	if (Length == 0 or Length > Size - Metadata) { Damaged(); }
+	FlatTable Message = FlatTable::Root(Data + Metadata, Data + Metadata + Length);
+	Body = Metadata + Length;
+	std::int64_t BodyLength = Message.Scalar<std::int64_t>(3, 0);
+	if (BodyLength < 0 or static_cast<std::uint64_t>(BodyLength) > Size - Body) { Damaged(); }
+	Next = Body + BodyLength;
+	return Message;
+}
+
+// File format: schema and the positions of the record batches are stored in the footer, so only
+// the metadata of the record batches is touched when the file is opened.
+void ArrowSource::ReadFooter() {
+	const char* Data = File->Data();
+	std::size_t Size = File->Size();
+	std::uint32_t Length = Load<std::uint32_t>(Data + Size - MagicSize - 4);
+	if (Length > Size - 2 * MagicSize - 6) { Damaged(); }
+	const char* End = Data + Size - MagicSize - 4;
+	FlatTable Footer = FlatTable::Root(End - Length, End);
+	ReadSchema(Footer.Table(1));
+
+	// Block: int64 offset, int32 metadata length (+ 4 padding), int64 body length
+	std::size_t Count;
+	const char* Blocks = Footer.Vector(3, 24, Count);
+	for (std::size_t i = 0; i < Count; i++) {
+		std::uint64_t Body, Next;
+		FlatTable Message = ReadMessage(Load<std::uint64_t>(Blocks + 24 * i), Body, Next);
+		if (Message.Scalar<std::uint8_t>(1, 0) != HeaderRecordBatch) { Damaged(); }
+		AddBatch(Message.Table(2), Body);
+	}
+}
+
+// Stream format: the messages are walked from the start, the bodies are skipped.
+void ArrowSource::ReadStream() {
+	std::size_t Size = File->Size();
+	std::uint64_t Offset = 0;
+	bool HasSchema = false;
+	while (Size - Offset >= 8) {
+		std::uint32_t Marker = Load<std::uint32_t>(File->Data() + Offset);
+		if (Marker == 0 or (Marker == 0xFFFFFFFFu and Load<std::uint32_t>(File->Data() + Offset + 4) == 0)) { break; }
+		std::uint64_t Body;
+		FlatTable Message = ReadMessage(Offset, Body, Offset);
+		std::uint8_t Header = Message.Scalar<std::uint8_t>(1, 0);
+		if (not HasSchema) {
+			if (Header != HeaderSchema) { throw std::runtime_error("Data file is no Arrow file"); }
+			ReadSchema(Message.Table(2));
+			HasSchema = true;
+		}
+		else if (Header == HeaderRecordBatch) { AddBatch(Message.Table(2), Body); }
+	}
+	if (not HasSchema) { throw std::runtime_error("Data file is no Arrow file"); }
+}
+
+void ArrowSource::ReadSchema(const FlatTable& Schema) {
+	if (Schema.Scalar<std::int16_t>(0, 0) != 0) {
+		throw std::runtime_error("Big endian Arrow files are not supported");
+	}
+	std::size_t Count;
+	Schema.Vector(1, 4, Count);
+	for (std::size_t i = 0; i < Count; i++) {
+		FlatTable Field = Schema.TableAt(1, i);
+		ColNames.push_back(Field.String(0));
+		Fields.push_back(ReadType(Field, 0));
+	}
+	MangleDuplicateNames(ColNames);
+}
+
+ArrowSource::FieldType ArrowSource::ReadType(const FlatTable& Field, int Depth) {
+	if (Depth > MaxDepth) { Damaged(); }
+	FieldType Type;
+	Type.Type = Field.Scalar<std::uint8_t>(2, 0);
+	Type.Dictionary = Field.Has(4);
+	if (Field.Has(3)) {
+		FlatTable Details = Field.Table(3);
+		switch (Type.Type) {
+		case TypeInt:
+			Type.BitWidth = Details.Scalar<std::int32_t>(0, 0);
+			Type.Signed = Details.Scalar<std::uint8_t>(1, 0) != 0;
+			break;
+		case TypeFloatingPoint:
+			Type.BitWidth = 16 << Details.Scalar<std::int16_t>(0, 0); // HALF, SINGLE, DOUBLE
+			break;
+		case TypeDate:
+			Type.BitWidth = Details.Scalar<std::int16_t>(0, 1) == 0 ? 32 : 64; // Days or milliseconds
+			break;
+		case TypeTime:
+			Type.BitWidth = Details.Scalar<std::int32_t>(1, 32);
+			break;
+		case TypeTimestamp:
+		case TypeDuration:
+			Type.BitWidth = 64;
+			break;
+		case TypeUnion:
+			Type.DenseUnion = Details.Scalar<std::int16_t>(0, 0) == 1;
+			break;
+		}
+	}
+	std::size_t Count;
+	Field.Vector(5, 4, Count);
+	for (std::size_t i = 0; i < Count; i++) {
+		Type.Children.push_back(ReadType(Field.TableAt(5, i), Depth + 1));
+	}
+	return Type;
+}
+
+// Field nodes and buffers which a field and its children take in a record batch:
+void ArrowSource::CountLayout(const FieldType& Type, const std::vector<std::int64_t>& Variadic, std::size_t& NextVariadic,
+	std::size_t& Nodes, std::size_t& Buffers) {
+	Nodes++;
+	if (Type.Dictionary) {
+		Buffers += 2; // Validity and indices, the values are in dictionary batches
+		return;
+	}
+	switch (Type.Type) {
+	case TypeNull:
+	case TypeRunEndEncoded:
+		break;
+	case TypeStruct:
+	case TypeFixedSizeList:
+		Buffers += 1;
+		break;
+	case TypeUnion:
+		Buffers += Type.DenseUnion ? 2 : 1;
+		break;
+	case TypeInt: case TypeFloatingPoint: case TypeBool: case TypeDecimal: case TypeDate: case TypeTime:
+	case TypeTimestamp: case TypeInterval: case TypeFixedSizeBinary: case TypeDuration:
+	case TypeList: case TypeLargeList: case TypeMap:
+		Buffers += 2;
+		break;
+	case TypeBinary: case TypeUtf8: case TypeLargeBinary: case TypeLargeUtf8:
+	case TypeListView: case TypeLargeListView:
+		Buffers += 3;
+		break;
+	case TypeBinaryView:
+	case TypeUtf8View:
+		if (NextVariadic >= Variadic.size() or Variadic[NextVariadic] < 0) { Damaged(); }
+		Buffers += 2 + static_cast<std::size_t>(Variadic[NextVariadic++]);
+		break;
+	default:
+		throw std::runtime_error("Unsupported column type in Arrow file");
+	}
+	for (const FieldType& Child : Type.Children) {
+		CountLayout(Child, Variadic, NextVariadic, Nodes, Buffers);
+	}
+}
+
+void ArrowSource::AddBatch(const FlatTable& RecordBatch, std::uint64_t Body) {
+	Batch Part;
+	Part.FirstRow = RowCount;
+	std::int64_t Rows = RecordBatch.Scalar<std::int64_t>(0, 0);
+	if (Rows < 0) { Damaged(); }
+	Part.Rows = static_cast<std::uint64_t>(Rows);
+	if (RecordBatch.Has(3)) { Part.Codec = 1 + RecordBatch.Table(3).Scalar<std::int8_t>(0, 0); } // LZ4_FRAME or ZSTD
+
+	// FieldNode: int64 length, int64 null count. Buffer: int64 offset, int64 length (in the body)
+	std::size_t NodeCount, BufferCount, VariadicCount;
+	const char* Nodes = RecordBatch.Vector(1, 16, NodeCount);
+	const char* Buffers = RecordBatch.Vector(2, 16, BufferCount);
+	const char* VariadicData = RecordBatch.Vector(4, 8, VariadicCount);
+	std::vector<std::int64_t> Variadic(VariadicCount);
+	for (std::size_t i = 0; i < VariadicCount; i++) { Variadic[i] = Load<std::int64_t>(VariadicData + 8 * i); }
+
+	auto ReadBuffer = [&](std::size_t Index) {
+		Buffer Result;
+		std::uint64_t Offset = Load<std::uint64_t>(Buffers + 16 * Index);
+		Result.Length = Load<std::uint64_t>(Buffers + 16 * Index + 8);
+		if (Offset > File->Size() - Body or Result.Length > File->Size() - Body - Offset) { Damaged(); }
+		Result.Offset = Body + Offset;
+		return Result;
+	};
+	std::size_t Node = 0, Next = 0, NextVariadic = 0;
+	for (const FieldType& Type : Fields) {
+		if (Node >= NodeCount) { Damaged(); }
+		Slot Field;
+		Field.Length = Load<std::uint64_t>(Nodes + 16 * Node);
+		Field.NullCount = Load<std::uint64_t>(Nodes + 16 * Node + 8);
+		if (Field.Length != Part.Rows) { Damaged(); }
+		if (Next + 2 <= BufferCount) {
+			Field.Validity = ReadBuffer(Next);
+			Field.Values = ReadBuffer(Next + 1);
+		}
+		CountLayout(Type, Variadic, NextVariadic, Node, Next);
+		if (Node > NodeCount or Next > BufferCount) { Damaged(); }
+		Part.Slots.push_back(Field);
+	}
+	RowCount += Part.Rows;
+	Batches.push_back(std::move(Part));
+}
+
+// Data of a buffer and its (uncompressed) Length, compressed buffers are decompressed into Storage:
+const char* ArrowSource::BufferData(const Batch& Part, const Buffer& Data, std::vector<char>& Storage, std::size_t& Length) const {
+	const char* Begin = File->Data() + Data.Offset;
+	Length = static_cast<std::size_t>(Data.Length);
+	if (Part.Codec == 0 or Data.Length == 0) { return Begin; }
+
+	// Compressed buffers start with the uncompressed length, -1 if they are stored uncompressed:
+	if (Data.Length < 8) { Damaged(); }
+	std::int64_t Uncompressed = Load<std::int64_t>(Begin);
+	if (Uncompressed == -1) {
+		Length -= 8;
+		return Begin + 8;
+	}
+	if (Uncompressed < 0) { Damaged(); }
+	Storage.resize(static_cast<std::size_t>(Uncompressed));
+	Length = Storage.size();
+	if (Part.Codec == 1) { DecompressLZ4Frame(Begin + 8, Begin + Data.Length, Storage.data(), Storage.size()); }
+	else if (Part.Codec == 2) {
+		std::size_t Written = ZSTD_decompress(Storage.data(), Storage.size(), Begin + 8, Data.Length - 8);
+		if (ZSTD_isError(Written) or Written != Storage.size()) { Damaged(); }
+	}
+	else { throw std::runtime_error("Unsupported compression in Arrow file"); }
+	return Storage.data();
+}
+
+// Convert the values of a top level field in one record batch, returns false if the type is not
+// numeric (Out stays NaN). Dates and times are converted to their raw numbers but count as not
+// numeric, so pandas can decide about them like about the date columns of other files.
+bool ArrowSource::Convert(const FieldType& Type, const Batch& Part, const Slot& Field, double* Out) const {
+	bool Temporal = Type.Type == TypeDate or Type.Type == TypeTime or Type.Type == TypeTimestamp or Type.Type == TypeDuration;
+	bool Integer = Type.Type == TypeInt or Temporal;
+	bool Floating = Type.Type == TypeFloatingPoint;
+	if (Type.Dictionary or not (Integer or Floating or Type.Type == TypeBool)) { return false; }
+	std::size_t Rows = static_cast<std::size_t>(Part.Rows);
+
+	std::vector<char> Storage;
+	std::size_t Available;
+	const char* Data = BufferData(Part, Field.Values, Storage, Available);
+	if (Type.Type == TypeBool) {
+		if (Available < (Rows + 7) / 8) { Damaged(); }
+		for (std::size_t i = 0; i < Rows; i++) { Out[i] = (Data[i / 8] >> (i % 8)) & 1; }
+	}
+	else {
+		std::size_t ValueSize = static_cast<std::size_t>(Type.BitWidth / 8);
+		if (ValueSize == 0 or Available / ValueSize < Rows) { Damaged(); }
+		int Bits = Type.BitWidth;
+		if (Floating and Bits == 16) {
+			for (std::size_t i = 0; i < Rows; i++) { Out[i] = HalfToDouble(Load<std::uint16_t>(Data + 2 * i)); }
+		}
+		else if (Floating and Bits == 32) { ConvertValues<float>(Data, Rows, Out); }
+		else if (Floating and Bits == 64) { ConvertValues<double>(Data, Rows, Out); }
+		else if (Floating) { return false; }
+		else if (Bits == 8) { Type.Signed ? ConvertValues<std::int8_t>(Data, Rows, Out) : ConvertValues<std::uint8_t>(Data, Rows, Out); }
+		else if (Bits == 16) { Type.Signed ? ConvertValues<std::int16_t>(Data, Rows, Out) : ConvertValues<std::uint16_t>(Data, Rows, Out); }
+		else if (Bits == 32) { Type.Signed ? ConvertValues<std::int32_t>(Data, Rows, Out) : ConvertValues<std::uint32_t>(Data, Rows, Out); }
+		else if (Bits == 64) { Type.Signed ? ConvertValues<std::int64_t>(Data, Rows, Out) : ConvertValues<std::uint64_t>(Data, Rows, Out); }
+		else { return false; }
+	}
+
+	// Missing values are marked in the validity bitmap:
+	if (Field.NullCount > 0 and Field.Validity.Length > 0) {
+		std::vector<char> ValidityStorage;
+		std::size_t ValidityLength;
+		const char* Validity = BufferData(Part, Field.Validity, ValidityStorage, ValidityLength);
+		if (ValidityLength < (Rows + 7) / 8) { Damaged(); }
+		for (std::size_t i = 0; i < Rows; i++) {
+			if (not ((Validity[i / 8] >> (i % 8)) & 1)) { Out[i] = NaN; }
+		}
+	}
+	return not Temporal;
+}
+
+std::vector<DataColumn> ArrowSource::Columns(const std::vector<std::size_t>& Indices) const {
+	std::vector<DataColumn> Result(Indices.size());
+	for (std::size_t i = 0; i < Indices.size(); i++) {
+		if (Indices[i] >= ColNames.size()) {
+			throw std::out_of_range("Column index out of range");
+		}
+		Result[i].Name = ColNames[Indices[i]];
+	}
+
+	// A float64 column without missing values in a single uncompressed record batch is used in place:
+	std::vector<std::size_t> Copied;
+	for (std::size_t i = 0; i < Indices.size(); i++) {
+		const FieldType& Type = Fields[Indices[i]];
+		bool InPlace = Batches.size() == 1 and Batches[0].Codec == 0 and not Type.Dictionary
+			and Type.Type == TypeFloatingPoint and Type.BitWidth == 64;
+		if (InPlace) {
+			const Slot& Field = Batches[0].Slots[Indices[i]];
+			const char* Data = File->Data() + Field.Values.Offset;
+			InPlace = Field.NullCount == 0 and Field.Length == RowCount and Field.Values.Length / sizeof(double) >= RowCount
+				and reinterpret_cast<std::uintptr_t>(Data) % alignof(double) == 0;
+			if (InPlace) {
+				Result[i].External = reinterpret_cast<const double*>(Data);
+				Result[i].ExternalSize = RowCount;
+				Result[i].Mapping = File;
+				ComputeStats(Result[i]);
+			}
+		}
+		if (not InPlace) {
+			Result[i].Values.resize(RowCount, NaN);
+			Copied.push_back(i);
+		}
+	}
+	if (Copied.empty() or RowCount == 0) { return Result; }
+
+	// Record batches are converted in parallel, each one into its own rows of the columns:
+	std::uint64_t Total = 0;
+	for (const Batch& Part : Batches) {
+		for (std::size_t i : Copied) { Total += Part.Slots[Indices[i]].Values.Length; }
+	}
+	LoadProgress::Current().BeginPass("Reading", Total);
+	std::vector<std::vector<unsigned char>> Numeric(Batches.size(), std::vector<unsigned char>(Indices.size(), 1));
+	std::vector<std::vector<ColumnStats>> Stats(Batches.size(), std::vector<ColumnStats>(Indices.size()));
+	ThreadPool::Shared().ParallelFor(Batches.size(), [&](std::size_t k) {
+		const Batch& Part = Batches[k];
+		std::uint64_t Bytes = 0;
+		for (std::size_t i : Copied) {
+			const Slot& Field = Part.Slots[Indices[i]];
+			double* Out = Result[i].Values.data() + Part.FirstRow;
+			if (not Convert(Fields[Indices[i]], Part, Field, Out)) { Numeric[k][i] = 0; }
+			Stats[k][i].Add(Out, static_cast<std::size_t>(Part.Rows));
+			File->Release(Field.Values.Offset, Field.Values.Offset + Field.Values.Length);
+			Bytes += Field.Values.Length;
+		}
+		LoadProgress::Current().Add(Bytes, Part.Rows);
+	});
+	for (std::size_t k = 0; k < Batches.size(); k++) {
+		for (std::size_t i : Copied) {
+			if (not Numeric[k][i]) { Result[i].Numeric = false; }
+			Result[i].Stats.Merge(Stats[k][i]);
+		}
+	}
+	return Result;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+#include "DataReader.h"
+#include "MappedFile.h"
+
+// Arrow IPC file (Feather v2) or stream on a memory mapped file. Opening reads only the schema
+// and the metadata of the record batches, nothing has to be parsed. Columns converts the
+// buffers of the requested columns to doubles, a float64 column without missing values in a
+// file with a single uncompressed record batch is not even copied but points into the mapping.
+// LZ4 and zstd compressed buffers are decompressed while converting.
+class ArrowSource : public DataSource {
+public:
+	explicit ArrowSource(const std::filesystem::path& Path);
+
+	const std::vector<std::string>& Names() const override { return ColNames; }
+	std::size_t Rows() const { return RowCount; }
+	std::vector<DataColumn> Columns(const std::vector<std::size_t>& Indices) const override;
+
+private:
+	class FlatTable;
+
+	struct FieldType {
+		std::uint8_t Type = 0; // Type union id of the Arrow schema
+		int BitWidth = 0; // Integer, floating point and temporal values
+		bool Signed = true;
+		bool Dictionary = false; // Dictionary encoded, the buffers hold indices
+		bool DenseUnion = false;
+		std::vector<FieldType> Children;
+	};
+
+	struct Buffer {
+		std::uint64_t Offset = 0; // In the file
+		std::uint64_t Length = 0;
+	};
+
+	// Top level field in one record batch:
+	struct Slot {
+		std::uint64_t Length = 0;
+		std::uint64_t NullCount = 0;
+		Buffer Validity;
+		Buffer Values;
+	};
+
+	struct Batch {
+		std::uint64_t FirstRow = 0;
+		std::uint64_t Rows = 0;
+		int Codec = 0; // 0 uncompressed, 1 LZ4 frame, 2 zstd
+		std::vector<Slot> Slots;
+	};
+
+	FlatTable ReadMessage(std::uint64_t Offset, std::uint64_t& Body, std::uint64_t& Next) const;
+	void ReadFooter();
+	void ReadStream();
+	void ReadSchema(const FlatTable& Schema);
+	void AddBatch(const FlatTable& RecordBatch, std::uint64_t Body);
+	static FieldType ReadType(const FlatTable& Field, int Depth);
+	static void CountLayout(const FieldType& Type, const std::vector<std::int64_t>& Variadic, std::size_t& NextVariadic,
+		std::size_t& Nodes, std::size_t& Buffers);
+	const char* BufferData(const Batch& Part, const Buffer& Data, std::vector<char>& Storage, std::size_t& Length) const;
+	bool Convert(const FieldType& Type, const Batch& Part, const Slot& Field, double* Out) const;
+
+	std::shared_ptr<const MappedFile> File;
+	std::vector<std::string> ColNames;
+	std::vector<FieldType> Fields;
+	std::vector<Batch> Batches;
+	std::size_t RowCount = 0;
+};
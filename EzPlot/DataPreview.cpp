@@ -0,0 +1,77 @@
+#include "DataPreview.h"
+#include "PyUtils.h"
+#include <algorithm>
+#include <climits>
+
+DataPreviewTable::DataPreviewTable(PyObject* PreviewRows, const std::string& Path, const std::string& Seperator,
+	const std::string& Decimal, std::size_t Rows, const wxArrayString& Names)
+	: PreviewRows(PreviewRows), Path(Path), Seperator(Seperator), Decimal(Decimal), Rows(Rows), Names(Names) {
+}
+
+int DataPreviewTable::GetNumberRows() {
+	return static_cast<int>(std::min<std::size_t>(Rows, INT_MAX));
+}
+
+int DataPreviewTable::GetNumberCols() {
+	return static_cast<int>(Names.GetCount());
+}
+
+wxString DataPreviewTable::GetValue(int Row, int Col) {
+	if (Row < 0 or Col < 0 or Col >= GetNumberCols()) { return wxEmptyString; }
+	const std::vector<wxString>& Cells = Block(Row / BlockRows * BlockRows);
+	std::size_t Index = (Row % BlockRows) * Names.GetCount() + Col;
+	return Index < Cells.size() ? Cells[Index] : wxString();
+}
+
+bool DataPreviewTable::IsEmptyCell(int Row, int Col) {
+	return GetValue(Row, Col).empty();
+}
+
+wxString DataPreviewTable::GetColLabelValue(int Col) {
+	return Col < GetNumberCols() ? Names[Col] : wxString();
+}
+
+wxString DataPreviewTable::GetRowLabelValue(int Row) {
+	return wxString::Format("%d", Row + 1);
+}
+
+// Cells of the rows [First, First + BlockRows), a block which cannot be read stays empty:
+const std::vector<wxString>& DataPreviewTable::Block(std::size_t First) {
+	auto Found = Blocks.find(First);
+	if (Found != Blocks.end()) {
+		Used.erase(std::find(Used.begin(), Used.end(), First));
+		Used.push_back(First);
+		return Found->second;
+	}
+
+	std::vector<wxString> Cells;
+	{
+		PyLock Lock;
+		PyRef Result(PyObject_CallFunction(PreviewRows, "sssnn", Path.c_str(), Seperator.c_str(), Decimal.c_str(),
+			static_cast<Py_ssize_t>(First), static_cast<Py_ssize_t>(BlockRows)));
+		PyRef RowList(Result ? PySequence_Fast(Result.Get(), "rows must be a sequence") : NULL);
+		for (Py_ssize_t i = 0; RowList and i < PySequence_Fast_GET_SIZE(RowList.Get()); i++) {
+			PyRef Row(PySequence_Fast(PySequence_Fast_GET_ITEM(RowList.Get(), i), "row must be a sequence"));
+			if (!Row) { break; }
+			for (std::size_t k = 0; k < Names.GetCount(); k++) {
+				const char* Text = "";
+				if (k < static_cast<std::size_t>(PySequence_Fast_GET_SIZE(Row.Get()))) {
+					Text = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(Row.Get(), k));
+				}
+				if (!Text) {
+					PyErr_Clear();
+					Text = "";
+				}
+				Cells.push_back(wxString::FromUTF8(Text));
+			}
+		}
+		if (PyErr_Occurred()) { PyErr_Clear(); }
+	}
+
+	if (Used.size() >= KeptBlocks) {
+		Blocks.erase(Used.front());
+		Used.erase(Used.begin());
+	}
+	Used.push_back(First);
+	return Blocks[First] = std::move(Cells);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <wx/grid.h>
+#include <Python.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Virtual table of the preview grid on the Data tab. Cells are not stored in the grid, the rows
+// which are drawn are fetched in blocks from file_picker.PreviewRows and only the last blocks are
+// kept, so scrolling through a file of any length takes constant memory.
+class DataPreviewTable : public wxGridTableBase {
+public:
+	// PreviewRows(path, seperator, decimal, first, count) -> rows of cell texts, borrowed
+	DataPreviewTable(PyObject* PreviewRows, const std::string& Path, const std::string& Seperator,
+		const std::string& Decimal, std::size_t Rows, const wxArrayString& Names);
+
+	int GetNumberRows() override;
+	int GetNumberCols() override;
+	wxString GetValue(int Row, int Col) override;
+	void SetValue(int Row, int Col, const wxString& Value) override {}
+	bool IsEmptyCell(int Row, int Col) override;
+	wxString GetColLabelValue(int Col) override;
+	wxString GetRowLabelValue(int Row) override;
+
+private:
+	const std::vector<wxString>& Block(std::size_t First);
+
+	static const std::size_t BlockRows = 256;
+	static const std::size_t KeptBlocks = 8;
+
+	PyObject* PreviewRows;
+	std::string Path;
+	std::string Seperator;
+	std::string Decimal;
+	std::size_t Rows;
+	wxArrayString Names;
+	std::map<std::size_t, std::vector<wxString>> Blocks; // First row -> cells row by row
+	std::vector<std::size_t> Used; // First rows of the kept blocks, least recently used first
+};
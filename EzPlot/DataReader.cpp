@@ -0,0 +1,1073 @@
+#include "DataReader.h"
+#include "ThreadPool.h"
+#include "LoadProgress.h"
+#include "DataStream.h"
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <bit>
+#include <unordered_set>
+#include <string_view>
+#include <algorithm>
+#include <future>
+#include <map>
+#include <cmath>
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define EZP_SSE2
+#endif
+
+namespace {
+
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	const std::size_t ChunkSize = 1 << 22; // Read files in 4 MiB blocks
+	const std::size_t HeaderChunkSize = 1 << 12;
+	const std::size_t SegmentSize = 1 << 23; // Minimal size of the parallel parsed parts of a file
+	const std::size_t BlockSize = 1 << 20; // Decompressed data parsed by one task
+	const std::size_t ProgressRows = 1 << 16; // Rows between two progress updates
+	const std::size_t StatsBlockSize = 1 << 20; // Values summarized by one task of ComputeStats
+	const std::size_t RangeRows = 1 << 16; // Rows parsed by one task when a row range is parsed
+
+	// Adds the rows and bytes of a row loop to the load progress in batches:
+	class ProgressCounter {
+	public:
+		explicit ProgressCounter(const char* Pos) : Last(Pos) {}
+		void Row(const char* Pos) {
+			if (++Rows == ProgressRows) { Flush(Pos); }
+		}
+		void Flush(const char* Pos) {
+			LoadProgress::Current().Add(Pos - Last, Rows);
+			Last = Pos;
+			Rows = 0;
+		}
+
+	private:
+		const char* Last;
+		std::size_t Rows = 0;
+	};
+
+	// Find the next seperator or line break, 16 bytes at once with SSE2:
+	inline const char* FindFieldEnd(const char* Pos, const char* End, char Seperator) {
+#ifdef EZP_SSE2
+		const __m128i Sep = _mm_set1_epi8(Seperator);
+		const __m128i Lf = _mm_set1_epi8('\n');
+		const __m128i Cr = _mm_set1_epi8('\r');
+		while (End - Pos >= 16) {
+			__m128i Block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Pos));
+			__m128i Hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Block, Sep),
+				_mm_cmpeq_epi8(Block, Lf)), _mm_cmpeq_epi8(Block, Cr));
+			unsigned int Mask = static_cast<unsigned int>(_mm_movemask_epi8(Hits));
+			if (Mask != 0) {
+				return Pos + std::countr_zero(Mask);
+			}
+			Pos += 16;
+		}
+#endif
+		while (Pos < End && *Pos != Seperator && *Pos != '\n' && *Pos != '\r') {
+			Pos++;
+		}
+		return Pos;
+	}
+
+	// Find the next quote or line break, 16 bytes at once with SSE2:
+	inline const char* FindRowStop(const char* Pos, const char* End) {
+#ifdef EZP_SSE2
+		const __m128i Quote = _mm_set1_epi8('"');
+		const __m128i Lf = _mm_set1_epi8('\n');
+		const __m128i Cr = _mm_set1_epi8('\r');
+		while (End - Pos >= 16) {
+			__m128i Block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Pos));
+			__m128i Hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Block, Quote),
+				_mm_cmpeq_epi8(Block, Lf)), _mm_cmpeq_epi8(Block, Cr));
+			unsigned int Mask = static_cast<unsigned int>(_mm_movemask_epi8(Hits));
+			if (Mask != 0) {
+				return Pos + std::countr_zero(Mask);
+			}
+			Pos += 16;
+		}
+#endif
+		while (Pos < End && *Pos != '"' && *Pos != '\n' && *Pos != '\r') {
+			Pos++;
+		}
+		return Pos;
+	}
+
+	// Behind the closing quote of a quoted field, Pos is behind the opening one. Doubled quotes are
+	// part of the field, returns nullptr if the field is not closed before End:
+	const char* SkipQuoted(const char* Pos, const char* End) {
+		while (true) {
+			const char* Quote = static_cast<const char*>(std::memchr(Pos, '"', End - Pos));
+			if (Quote == nullptr) { return nullptr; }
+			Pos = Quote + 1;
+			if (Pos < End and *Pos == '"') {
+				Pos++;
+				continue;
+			}
+			return Pos;
+		}
+	}
+
+	// Skip the rest of a row without splitting it into fields. Pos has to be the start of a field,
+	// line breaks inside quoted fields do not end the row:
+	const char* SkipRow(const char* Pos, const char* End, char Seperator) {
+		const char* Begin = Pos;
+		while (true) {
+			const char* Stop = FindRowStop(Pos, End);
+			if (Stop == End) { return End; }
+			if (*Stop == '"') {
+				Pos = Stop + 1;
+				if (Stop != Begin and Stop[-1] != Seperator) { continue; } // Quote inside of a field
+				Pos = SkipQuoted(Pos, End);
+				if (Pos == nullptr) { return End; }
+				continue;
+			}
+			if (*Stop == '\r' and Stop + 1 < End and Stop[1] == '\n') { Stop++; }
+			return Stop + 1;
+		}
+	}
+
+	// End of the last row in [Begin, End) whose line break is outside of quotes, Begin has to be
+	// the start of a row. Like SplitRow, only a quote at the start of a field opens a quoted field.
+	// Returns Begin if there is no complete row:
+	const char* LastRowEnd(const char* Begin, const char* End, char Seperator) {
+		const char* RowEnd = Begin;
+		for (const char* Pos = Begin;;) {
+			Pos = FindRowStop(Pos, End);
+			if (Pos == End) { return RowEnd; }
+			if (*Pos == '"') {
+				bool FieldStart = Pos == Begin or Pos[-1] == Seperator or Pos[-1] == '\n' or Pos[-1] == '\r';
+				Pos = FieldStart ? SkipQuoted(Pos + 1, End) : Pos + 1; // Quote inside of a field
+				if (Pos == nullptr) { return RowEnd; }
+				continue;
+			}
+			RowEnd = Pos + 1;
+			Pos++;
+		}
+	}
+
+	// Split one complete row into fields and call OnField(Index, Begin, End) for the fields up to
+	// LastField, the rest of the row is skipped. Returns the start of the next row, Blank is set for
+	// empty lines:
+	template <typename Callback>
+	const char* SplitRow(const char* Pos, const char* End, char Seperator, std::string& Unquoted,
+		std::size_t LastField, bool& Blank, Callback&& OnField) {
+		std::size_t Fields = 0;
+		Blank = false;
+		while (true) {
+			const char* FieldBegin;
+			const char* FieldEnd;
+			bool Quoted = Pos < End and *Pos == '"';
+			if (Quoted) {
+				Unquoted.clear();
+				const char* Search = Pos + 1;
+				while (true) {
+					const char* Quote = static_cast<const char*>(std::memchr(Search, '"', End - Search));
+					if (Quote == nullptr) {
+						Unquoted.append(Search, End);
+						Pos = End;
+						break;
+					}
+					Unquoted.append(Search, Quote);
+					if (Quote + 1 < End and Quote[1] == '"') {
+						Unquoted.push_back('"');
+						Search = Quote + 2;
+						continue;
+					}
+					Pos = Quote + 1;
+					break;
+				}
+				const char* Rest = FindFieldEnd(Pos, End, Seperator);
+				Unquoted.append(Pos, Rest);
+				Pos = Rest;
+				FieldBegin = Unquoted.data();
+				FieldEnd = FieldBegin + Unquoted.size();
+			}
+			else {
+				FieldBegin = Pos;
+				Pos = FindFieldEnd(Pos, End, Seperator);
+				FieldEnd = Pos;
+			}
+			if (Fields == 0) { Blank = not Quoted and FieldBegin == FieldEnd; }
+			OnField(Fields, FieldBegin, FieldEnd);
+			Fields++;
+
+			if (Pos == End) { break; }
+			if (*Pos == Seperator) {
+				Pos++;
+				if (Fields > LastField) {
+					Blank = false;
+					return SkipRow(Pos, End, Seperator);
+				}
+				continue;
+			}
+			if (*Pos == '\r' and Pos + 1 < End and Pos[1] == '\n') { Pos++; }
+			Pos++;
+			break;
+		}
+		Blank = Blank and Fields == 1;
+		return Pos;
+	}
+
+}
+
+void ColumnStats::Add(const double* Values, std::size_t Size) {
+	for (std::size_t i = 0; i < Size; i++) {
+		double Value = Values[i];
+		if (std::isnan(Value)) {
+			Missing++;
+			continue;
+		}
+		Count++;
+		Min = std::min(Min, Value);
+		Max = std::max(Max, Value);
+		Sum += Value;
+	}
+}
+
+void ColumnStats::Merge(const ColumnStats& Other) {
+	Count += Other.Count;
+	Missing += Other.Missing;
+	Min = std::min(Min, Other.Min);
+	Max = std::max(Max, Other.Max);
+	Sum += Other.Sum;
+}
+
+void ComputeStats(DataColumn& Column) {
+	std::size_t Size = Column.Size();
+	std::vector<ColumnStats> Parts((Size + StatsBlockSize - 1) / StatsBlockSize);
+	ThreadPool::Shared().ParallelFor(Parts.size(), [&](std::size_t k) {
+		std::size_t Begin = k * StatsBlockSize;
+		Parts[k].Add(Column.Data() + Begin, std::min(StatsBlockSize, Size - Begin));
+	});
+	Column.Stats = ColumnStats();
+	for (const ColumnStats& Part : Parts) { Column.Stats.Merge(Part); }
+}
+
+// Default NA values of pandas.read_csv ("nan", "inf", ... are handled by from_chars):
+bool IsNAToken(const char* Begin, const char* End) {
+	static const std::unordered_set<std::string_view> Tokens = {
+		"#N/A", "#N/A N/A", "#NA", "-1.#IND", "-1.#QNAN", "1.#IND", "1.#QNAN",
+		"<NA>", "N/A", "NA", "NULL", "None", "n/a", "null"
+	};
+	return Tokens.count(std::string_view(Begin, End - Begin)) > 0;
+}
+
+bool ParseNumber(const char* Begin, const char* End, char Decimal, double& Value) {
+	while (Begin < End && (*Begin == ' ' || *Begin == '\t')) { Begin++; }
+	while (End > Begin && (End[-1] == ' ' || End[-1] == '\t')) { End--; }
+	if (Begin == End) {
+		Value = NaN;
+		return true;
+	}
+
+	// from_chars only knows "." as decimal sign, so copy the field with replaced decimal sign:
+	char Buffer[64];
+	bool ForeignPoint = false;
+	if (Decimal != '.' and static_cast<std::size_t>(End - Begin) < sizeof(Buffer)) {
+		std::size_t Length = End - Begin;
+		for (std::size_t i = 0; i < Length; i++) {
+			ForeignPoint = ForeignPoint or Begin[i] == '.';
+			Buffer[i] = Begin[i] == Decimal ? '.' : Begin[i];
+		}
+		Begin = Buffer;
+		End = Buffer + Length;
+	}
+	const char* Number = Begin;
+	if (*Number == '+' and End - Number > 1 and Number[1] != '-') { Number++; }
+
+	auto [Ptr, Error] = std::from_chars(Number, End, Value);
+	if (Ptr == End and not ForeignPoint) {
+		if (Error == std::errc()) { return true; }
+		if (Error == std::errc::result_out_of_range) {
+			Value = std::strtod(std::string(Number, End).c_str(), nullptr);
+			return true;
+		}
+	}
+	Value = NaN;
+	return IsNAToken(Begin, End);
+}
+
+void MangleDuplicateNames(std::vector<std::string>& Names) {
+	std::unordered_set<std::string> Used;
+	for (std::string& Name : Names) {
+		if (Used.count(Name)) {
+			std::string Base = Name;
+			for (int i = 1; Used.count(Name); i++) {
+				Name = Base + "." + std::to_string(i);
+			}
+		}
+		Used.insert(Name);
+	}
+}
+
+CSVParser::CSVParser(char Seperator, char Decimal, bool HeaderOnly)
+	: Seperator(Seperator), Decimal(Decimal), HeaderOnly(HeaderOnly), HeaderRead(false), FirstChunk(true) {
+}
+
+void CSVParser::Feed(const char* Data, std::size_t Size) {
+	Carry.append(Data, Size);
+	if (FirstChunk and Carry.size() >= 3) {
+		// Skip UTF-8 byte order mark:
+		if (Carry.compare(0, 3, "\xEF\xBB\xBF") == 0) { Carry.erase(0, 3); }
+		FirstChunk = false;
+	}
+	std::size_t Used = ParseRows(Carry.data(), Carry.data() + Carry.size(), false);
+	Carry.erase(0, Used);
+}
+
+DataTable CSVParser::Finish() {
+	ParseRows(Carry.data(), Carry.data() + Carry.size(), true);
+	Carry.clear();
+	return std::move(Table);
+}
+
+std::size_t CSVParser::ParseRows(const char* Begin, const char* End, bool Last) {
+	const char* Pos = Begin;
+	while (Pos < End and not (HeaderOnly and HeaderRead)) {
+		const char* Next = ParseRow(Pos, End, Last);
+		if (Next == nullptr) { break; }
+		Pos = Next;
+	}
+	return Pos - Begin;
+}
+
+// Parse one row starting at Pos, returns the start of the next row or nullptr
+// if the row is not complete yet (values of the incomplete row are removed again):
+const char* CSVParser::ParseRow(const char* Pos, const char* End, bool Last) {
+	std::size_t NumCols = Table.Columns.size();
+	std::size_t Field = 0;
+	bool FirstQuoted = false;
+	bool FirstEmpty = false;
+
+	auto Rollback = [&]() {
+		if (not HeaderRead) { HeaderFields.clear(); }
+		for (std::size_t i = 0; i < Field and i < NumCols; i++) {
+			Table.Columns[i].Values.pop_back();
+		}
+		return nullptr;
+	};
+
+	if (not HeaderRead) { HeaderFields.clear(); }
+
+	while (true) {
+		const char* FieldBegin;
+		const char* FieldEnd;
+		bool Quoted = Pos < End and *Pos == '"';
+		if (Quoted) {
+			// Quoted field, "" is an escaped quote:
+			Unquoted.clear();
+			const char* Search = Pos + 1;
+			while (true) {
+				const char* Quote = static_cast<const char*>(std::memchr(Search, '"', End - Search));
+				if (Quote == nullptr) {
+					if (not Last) { return Rollback(); }
+					Unquoted.append(Search, End);
+					Pos = End;
+					break;
+				}
+				Unquoted.append(Search, Quote);
+				if (Quote + 1 == End and not Last) { return Rollback(); }
+				if (Quote + 1 < End and Quote[1] == '"') {
+					Unquoted.push_back('"');
+					Search = Quote + 2;
+					continue;
+				}
+				Pos = Quote + 1;
+				break;
+			}
+			// Text between closing quote and seperator is part of the field as well:
+			const char* Rest = FindFieldEnd(Pos, End, Seperator);
+			Unquoted.append(Pos, Rest);
+			Pos = Rest;
+			FieldBegin = Unquoted.data();
+			FieldEnd = FieldBegin + Unquoted.size();
+		}
+		else {
+			FieldBegin = Pos;
+			Pos = FindFieldEnd(Pos, End, Seperator);
+			FieldEnd = Pos;
+		}
+		if (Pos == End and not Last) { return Rollback(); }
+
+		if (Field == 0) {
+			FirstQuoted = Quoted;
+			FirstEmpty = FieldBegin == FieldEnd;
+		}
+		if (not HeaderRead) {
+			HeaderFields.emplace_back(FieldBegin, FieldEnd);
+		}
+		else if (Field < NumCols) {
+			DataColumn& Column = Table.Columns[Field];
+			double Value;
+			if (not ParseNumber(FieldBegin, FieldEnd, Decimal, Value)) { Column.Numeric = false; }
+			Column.Values.push_back(Value);
+		}
+		Field++;
+
+		if (Pos == End) { break; }
+		if (*Pos == Seperator) {
+			Pos++;
+			continue;
+		}
+		// Line break (\n, \r\n or \r):
+		if (*Pos == '\r' and Pos + 1 < End and Pos[1] == '\n') { Pos++; }
+		Pos++;
+		break;
+	}
+
+	// Skip blank lines:
+	if (Field == 1 and FirstEmpty and not FirstQuoted) {
+		Rollback();
+		return Pos;
+	}
+
+	if (not HeaderRead) {
+		ReadHeader(HeaderFields);
+		return Pos;
+	}
+	for (std::size_t i = Field; i < NumCols; i++) {
+		Table.Columns[i].Values.push_back(NaN);
+	}
+	Table.Rows++;
+	return Pos;
+}
+
+void CSVParser::ReadHeader(const std::vector<std::string>& Names) {
+	std::vector<std::string> ColNames = Names;
+	for (std::size_t i = 0; i < ColNames.size(); i++) {
+		if (ColNames[i].empty()) { ColNames[i] = "Unnamed: " + std::to_string(i); }
+	}
+	MangleDuplicateNames(ColNames);
+	Table.Columns.resize(ColNames.size());
+	for (std::size_t i = 0; i < ColNames.size(); i++) {
+		Table.Columns[i].Name = ColNames[i];
+	}
+	HeaderRead = true;
+}
+
+DataTable ReadCSV(const std::filesystem::path& Path, char Seperator, char Decimal) {
+	DataStream File(Path);
+	LoadProgress& Progress = LoadProgress::Current();
+	Progress.BeginPass("Parsing", File.FileSize());
+	CSVParser Parser(Seperator, Decimal);
+	std::vector<char> Chunk(ChunkSize);
+	std::uint64_t Consumed = 0;
+	while (std::size_t Count = File.Read(Chunk.data(), Chunk.size())) {
+		Parser.Feed(Chunk.data(), Count);
+		Progress.Add(File.Consumed() - Consumed, 0);
+		Consumed = File.Consumed();
+	}
+	return Parser.Finish();
+}
+
+std::vector<std::string> ReadCSVHeader(const std::filesystem::path& Path, char Seperator) {
+	DataStream File(Path);
+
+	// Decimal sign does not matter for the header:
+	CSVParser Parser(Seperator, '.', true);
+	std::vector<char> Chunk(HeaderChunkSize);
+	while (not Parser.HasHeader()) {
+		std::size_t Count = File.Read(Chunk.data(), Chunk.size());
+		if (Count == 0) { break; }
+		Parser.Feed(Chunk.data(), Count);
+	}
+	DataTable Table = Parser.Finish();
+
+	std::vector<std::string> Names;
+	for (DataColumn& Column : Table.Columns) {
+		Names.push_back(std::move(Column.Name));
+	}
+	return Names;
+}
+
+CSVDialect SniffCSV(const std::filesystem::path& Path, char Seperator, char Decimal, std::size_t SampleSize) {
+	const std::size_t MaxRows = 200;
+	DataStream File(Path);
+	std::string Sample(SampleSize, '\0');
+	std::size_t Size = 0;
+	while (Size < SampleSize) {
+		std::size_t Count = File.Read(Sample.data() + Size, SampleSize - Size);
+		if (Count == 0) { break; }
+		Size += Count;
+	}
+	const char* Begin = Sample.data();
+	const char* End = Begin + Size;
+	if (Size >= 3 and std::memcmp(Begin, "\xEF\xBB\xBF", 3) == 0) { Begin += 3; }
+	// Only complete rows, unless the first row is longer than the sample:
+	if (Size == SampleSize and LastRowEnd(Begin, End, Seperator) != Begin) { End = LastRowEnd(Begin, End, Seperator); }
+
+	auto IsNumber = [](const std::string& Field, char Decimal) {
+		double Value;
+		return ParseNumber(Field.data(), Field.data() + Field.size(), Decimal, Value) and not std::isnan(Value);
+	};
+
+	// The current settings are tried first, so they win ties:
+	std::vector<char> Seperators = { Seperator };
+	for (char Candidate : { ',', ';', '\t', '|' }) {
+		if (Candidate != Seperator) { Seperators.push_back(Candidate); }
+	}
+	const char OtherDecimal = Decimal == '.' ? ',' : '.';
+
+	CSVDialect Best;
+	Best.Seperator = Seperator;
+	Best.Decimal = Decimal;
+	std::vector<std::vector<std::string>> BestRows;
+	double BestScore = -1;
+	double SecondScore = -1;
+	double BestConsistency = 0;
+	double DecimalConfidence = 1;
+	std::string Unquoted;
+	for (char Candidate : Seperators) {
+		std::vector<std::vector<std::string>> Rows;
+		bool Quoted = false;
+		bool Blank;
+		for (const char* Pos = Begin; Pos < End and Rows.size() < MaxRows;) {
+			std::vector<std::string> Fields;
+			Pos = SplitRow(Pos, End, Candidate, Unquoted, std::numeric_limits<std::size_t>::max(), Blank,
+				[&](std::size_t, const char* FieldBegin, const char* FieldEnd) {
+					Quoted = Quoted or FieldBegin == Unquoted.data(); // Quoted fields are copied without quotes
+					Fields.emplace_back(FieldBegin, FieldEnd);
+				});
+			if (not Blank) { Rows.push_back(std::move(Fields)); }
+		}
+		if (Rows.empty()) { continue; }
+
+		// Share of the rows with the most common number of fields:
+		std::map<std::size_t, std::size_t> Widths;
+		for (const std::vector<std::string>& Fields : Rows) { Widths[Fields.size()]++; }
+		std::size_t Width = 0;
+		std::size_t Matching = 0;
+		for (auto [Fields, Count] : Widths) {
+			if (Count >= Matching) {
+				Width = Fields;
+				Matching = Count;
+			}
+		}
+		double Consistency = static_cast<double>(Matching) / Rows.size();
+		if (Width < 2) { Consistency *= 0.5; } // A single column fits every seperator
+
+		// Numbers in the data rows with both decimal signs, fields containing the sign count as evidence:
+		std::size_t Filled = 0;
+		std::size_t Numbers[2] = {};
+		std::size_t Evidence[2] = {};
+		for (std::size_t Row = 1; Row < Rows.size(); Row++) {
+			for (const std::string& Field : Rows[Row]) {
+				if (Field.empty() or IsNAToken(Field.data(), Field.data() + Field.size())) { continue; }
+				Filled++;
+				for (int k = 0; k < 2; k++) {
+					char Sign = k == 0 ? Decimal : OtherDecimal;
+					if (IsNumber(Field, Sign)) {
+						Numbers[k]++;
+						if (Field.find(Sign) != std::string::npos) { Evidence[k]++; }
+					}
+				}
+			}
+		}
+		int Chosen = Evidence[1] > Evidence[0] or (Evidence[1] == Evidence[0] and Numbers[1] > Numbers[0]) ? 1 : 0;
+		double NumberShare = Filled == 0 ? 0 : static_cast<double>(Numbers[Chosen]) / Filled;
+		double Score = Consistency * (1 + NumberShare) / 2;
+
+		if (Score > BestScore) {
+			SecondScore = BestScore;
+			BestScore = Score;
+			BestConsistency = Consistency;
+			Best.Seperator = Candidate;
+			Best.Decimal = Chosen == 0 ? Decimal : OtherDecimal;
+			Best.Quoted = Quoted;
+			std::size_t AllEvidence = Evidence[0] + Evidence[1];
+			DecimalConfidence = AllEvidence == 0 ? 1 : static_cast<double>(Evidence[Chosen]) / AllEvidence;
+			BestRows = std::move(Rows);
+		}
+		else if (Score > SecondScore) { SecondScore = Score; }
+	}
+	if (BestRows.empty()) { return Best; }
+
+	// A first row of numbers (and empty fields) only is data:
+	const std::vector<std::string>& First = BestRows[0];
+	Best.Header = std::all_of(First.begin(), First.end(), [](const std::string& Field) { return Field.empty(); })
+		or not std::all_of(First.begin(), First.end(),
+			[&](const std::string& Field) { return Field.empty() or IsNumber(Field, Best.Decimal); });
+
+	// Nearly as good alternatives make the guess unsure:
+	double Margin = SecondScore < 0.9 * BestScore ? 1 : 0.5;
+	Best.Confidence = BestConsistency * DecimalConfidence * Margin;
+	return Best;
+}
+
+std::size_t ReadCSVRows(const std::filesystem::path& Path, char Seperator, char Decimal, std::size_t Begin,
+	const std::vector<std::size_t>& Indices, std::vector<DataColumn>& Columns) {
+	std::ifstream File(Path, std::ios::binary);
+	if (not File.is_open()) {
+		throw std::runtime_error("Unable to open data file");
+	}
+	Columns.assign(Indices.size(), DataColumn());
+
+	// Only the new part of the file is read:
+	File.seekg(0, std::ios::end);
+	std::size_t Size = static_cast<std::size_t>(File.tellg());
+	if (Size <= Begin) { return Begin; }
+	std::string Buffer(Size - Begin, '\0');
+	File.seekg(Begin);
+	File.read(Buffer.data(), Buffer.size());
+	Buffer.resize(static_cast<std::size_t>(File.gcount()));
+	const char* Data = Buffer.data();
+	const char* End = Data + Buffer.size();
+
+	// A row at the end of the data is complete with its line break outside of quotes:
+	auto Complete = [&](const char* Row, const char* Next) {
+		if (Next < End) { return true; }
+		if (Next == Row or (Next[-1] != '\n' and Next[-1] != '\r')) { return false; }
+		return std::count(Row, Next, '"') % 2 == 0;
+	};
+
+	const char* Pos = Data;
+	if (Begin == 0) {
+		if (Buffer.size() >= 3 and std::memcmp(Pos, "\xEF\xBB\xBF", 3) == 0) { Pos += 3; }
+		bool Blank = true;
+		while (Pos < End and Blank) {
+			const char* Next = SkipRow(Pos, End, Seperator);
+			if (not Complete(Pos, Next)) { return 0; } // Header is not written yet
+			Blank = *Pos == '\n' or *Pos == '\r';
+			Pos = Next;
+		}
+		if (Blank) { return 0; }
+	}
+	const char* RowsBegin = Pos;
+	const char* RowsEnd = Pos;
+	while (Pos < End) {
+		const char* Next = SkipRow(Pos, End, Seperator);
+		if (not Complete(Pos, Next)) { break; }
+		Pos = RowsEnd = Next;
+	}
+
+	const std::size_t NoSlot = std::numeric_limits<std::size_t>::max();
+	std::vector<std::size_t> Slots;
+	for (std::size_t i = 0; i < Indices.size(); i++) {
+		if (Indices[i] >= Slots.size()) { Slots.resize(Indices[i] + 1, NoSlot); }
+		Slots[Indices[i]] = i;
+	}
+	const std::size_t LastField = Slots.empty() ? 0 : Slots.size() - 1;
+	std::vector<double> Values(Indices.size());
+	std::string Unquoted;
+	bool Blank;
+	for (Pos = RowsBegin; Pos < RowsEnd;) {
+		std::fill(Values.begin(), Values.end(), NaN);
+		Pos = SplitRow(Pos, RowsEnd, Seperator, Unquoted, LastField, Blank,
+			[&](std::size_t Field, const char* FieldBegin, const char* FieldEnd) {
+				std::size_t Slot = Field < Slots.size() ? Slots[Field] : NoSlot;
+				if (Slot == NoSlot) { return; }
+				if (not ParseNumber(FieldBegin, FieldEnd, Decimal, Values[Slot])) { Columns[Slot].Numeric = false; }
+			});
+		if (Blank) { continue; }
+		for (std::size_t i = 0; i < Values.size(); i++) {
+			Columns[i].Values.push_back(Values[i]);
+		}
+	}
+	return Begin + (RowsEnd - Data);
+}
+
+CSVSource::CSVSource(const std::filesystem::path& Path, char Seperator, char Decimal)
+	: File(std::make_unique<MappedFile>(Path)), Seperator(Seperator), Decimal(Decimal) {
+	BuildIndex();
+}
+
+std::size_t CSVSource::ReadHeader() {
+	const char* Begin = File->Data();
+	const char* End = Begin + File->Size();
+	const char* Pos = Begin;
+	if (File->Size() >= 3 and std::memcmp(Pos, "\xEF\xBB\xBF", 3) == 0) { Pos += 3; }
+
+	std::string Unquoted;
+	bool Blank = true;
+	std::vector<std::string> Header;
+	while (Pos < End and Blank) {
+		Header.clear();
+		Pos = SplitRow(Pos, End, Seperator, Unquoted, std::numeric_limits<std::size_t>::max(), Blank,
+			[&](std::size_t, const char* FieldBegin, const char* FieldEnd) { Header.emplace_back(FieldBegin, FieldEnd); });
+	}
+	for (std::size_t i = 0; i < Header.size(); i++) {
+		if (Header[i].empty()) { Header[i] = "Unnamed: " + std::to_string(i); }
+	}
+	MangleDuplicateNames(Header);
+	ColNames = std::move(Header);
+	return Pos - Begin;
+}
+
+// Number of rows in [Begin, End), or npos if the last row does not end at End. The offset of
+// every MarkRows-th row is added to Marks:
+std::size_t CSVSource::CountRows(std::size_t Begin, std::size_t End, std::vector<std::size_t>& Marks) const {
+	const char* Pos = File->Data() + Begin;
+	const char* Stop = File->Data() + End;
+	std::size_t Rows = 0;
+	ProgressCounter Counter(Pos);
+	while (Pos < Stop) {
+		const char* Row = Pos;
+		Pos = SkipRow(Pos, File->Data() + File->Size(), Seperator);
+		if (*Row != '\n' and *Row != '\r') { // Blank lines are no rows
+			if (Rows % MarkRows == 0) { Marks.push_back(Row - File->Data()); }
+			Rows++;
+			Counter.Row(Pos);
+		}
+	}
+	Counter.Flush(std::min(Pos, Stop));
+	return Pos == Stop ? Rows : std::string::npos;
+}
+
+// Split the data rows into segments for parallel parsing. Segment starts are guessed from
+// the parity of quotes in front of them, every guess is checked by counting the rows of the
+// previous segment with the real tokenizer. Returns false if the guesses did not fit.
+bool CSVSource::SplitSegments(std::size_t Begin) {
+	ThreadPool& Pool = ThreadPool::Shared();
+	const char* Data = File->Data();
+	std::size_t End = File->Size();
+	std::size_t Count = std::min<std::size_t>((End - Begin) / SegmentSize, Pool.Size() * 4);
+	if (Count < 2) { return false; }
+
+	std::vector<std::size_t> Bounds(Count + 1);
+	for (std::size_t k = 0; k <= Count; k++) {
+		Bounds[k] = Begin + (End - Begin) / Count * k;
+	}
+	Bounds[Count] = End;
+
+	std::vector<unsigned char> Parity(Count);
+	Pool.ParallelFor(Count, [&](std::size_t k) {
+		std::size_t Quotes = std::count(Data + Bounds[k], Data + Bounds[k + 1], '"');
+		Parity[k] = Quotes % 2;
+	});
+
+	// First line break outside of quotes in front of every bound:
+	std::vector<std::size_t> Starts(Count + 1);
+	Starts[0] = Begin;
+	Starts[Count] = End;
+	std::vector<bool> Quoted(Count);
+	for (std::size_t k = 1; k < Count; k++) {
+		Quoted[k] = Quoted[k - 1] != (Parity[k - 1] == 1);
+	}
+	Pool.ParallelFor(Count - 1, [&](std::size_t i) {
+		std::size_t k = i + 1;
+		std::size_t Pos = Bounds[k] - 1;
+		bool InQuotes = Quoted[k] != (Data[Pos] == '"');
+		for (; Pos < End; Pos++) {
+			char c = Data[Pos];
+			if (c == '"') { InQuotes = not InQuotes; }
+			else if (not InQuotes and (c == '\n' or c == '\r')) {
+				if (c == '\r' and Pos + 1 < End and Data[Pos + 1] == '\n') { Pos++; }
+				Pos++;
+				break;
+			}
+		}
+		Starts[k] = std::min(Pos, End);
+	});
+
+	std::vector<std::size_t> Rows(Count);
+	std::vector<std::vector<std::size_t>> Marks(Count);
+	Pool.ParallelFor(Count, [&](std::size_t k) {
+		Rows[k] = Starts[k] <= Starts[k + 1] ? CountRows(Starts[k], Starts[k + 1], Marks[k]) : std::string::npos;
+		File->Release(Starts[k], Starts[k + 1]);
+	});
+	if (std::find(Rows.begin(), Rows.end(), std::string::npos) != Rows.end()) { return false; }
+
+	for (std::size_t k = 0; k < Count; k++) {
+		if (Starts[k] == Starts[k + 1]) { continue; }
+		Segments.push_back({ Starts[k], Starts[k + 1], RowCount, Rows[k], std::move(Marks[k]) });
+		RowCount += Rows[k];
+	}
+	return true;
+}
+
+void CSVSource::BuildIndex() {
+	std::size_t Begin = ReadHeader();
+	LoadProgress& Progress = LoadProgress::Current();
+	Progress.BeginPass("Indexing", File->Size() - Begin);
+	if (SplitSegments(Begin)) { return; }
+
+	// Small file or unbalanced quotes, index in one piece:
+	Progress.BeginPass("Indexing", File->Size() - Begin);
+	Segments.clear();
+	std::vector<std::size_t> Marks;
+	RowCount = CountRows(Begin, File->Size(), Marks);
+	Segments.push_back({ Begin, File->Size(), 0, RowCount, std::move(Marks) });
+	File->Release(0, File->Size());
+}
+
+// Start of a data row, the end of the file for RowCount:
+const char* CSVSource::RowStart(std::size_t Row) const {
+	const char* End = File->Data() + File->Size();
+	if (Row >= RowCount) { return End; }
+
+	// Last segment starting in front of the row, the rows behind its nearest mark are skipped:
+	auto Part = std::upper_bound(Segments.begin(), Segments.end(), Row,
+		[](std::size_t Wanted, const Segment& Other) { return Wanted < Other.FirstRow; }) - 1;
+	Row -= Part->FirstRow;
+	const char* Pos = File->Data() + Part->Marks[Row / MarkRows];
+	for (std::size_t Skip = Row % MarkRows; Skip > 0;) {
+		const char* Next = SkipRow(Pos, End, Seperator);
+		if (*Pos != '\n' and *Pos != '\r') { Skip--; }
+		Pos = Next;
+	}
+	return Pos;
+}
+
+std::vector<std::string> CSVSource::Cells(std::size_t FirstRow, std::size_t Count) const {
+	std::vector<std::string> Result;
+	if (FirstRow >= RowCount or ColNames.empty()) { return Result; }
+	Count = std::min(Count, RowCount - FirstRow);
+	Result.resize(Count * ColNames.size());
+
+	const char* Pos = RowStart(FirstRow);
+	const char* End = File->Data() + File->Size();
+	std::string Unquoted;
+	bool Blank;
+	for (std::size_t i = 0; i < Count and Pos < End;) {
+		std::string* Fields = Result.data() + i * ColNames.size();
+		Pos = SplitRow(Pos, End, Seperator, Unquoted, ColNames.size() - 1, Blank,
+			[&](std::size_t Field, const char* FieldBegin, const char* FieldEnd) { Fields[Field].assign(FieldBegin, FieldEnd); });
+		if (Blank) { continue; }
+		i++;
+	}
+	return Result;
+}
+
+DataColumn CSVSource::Column(std::size_t Index) const {
+	return std::move(Columns({ Index })[0]);
+}
+
+std::vector<DataColumn> CSVSource::Columns(const std::vector<std::size_t>& Indices) const {
+	// Slot of every field in the result, fields without a slot are not converted:
+	std::vector<std::size_t> Slots;
+	const std::size_t NoSlot = std::numeric_limits<std::size_t>::max();
+	std::vector<DataColumn> Result(Indices.size());
+	for (std::size_t i = 0; i < Indices.size(); i++) {
+		if (Indices[i] >= ColNames.size()) {
+			throw std::out_of_range("Column index out of range");
+		}
+		if (Indices[i] >= Slots.size()) { Slots.resize(Indices[i] + 1, NoSlot); }
+		Slots[Indices[i]] = i;
+		Result[i].Name = ColNames[Indices[i]];
+		Result[i].Values.resize(RowCount, NaN);
+	}
+	if (RowCount == 0 or Indices.empty()) { return Result; }
+
+	// Segments are parsed in parallel, each one into its own rows of the columns:
+	const std::size_t LastField = Slots.size() - 1;
+	LoadProgress::Current().BeginPass("Parsing", Segments.back().End - Segments.front().Begin);
+	std::vector<std::vector<unsigned char>> Numeric(Segments.size(), std::vector<unsigned char>(Indices.size(), 1));
+	std::vector<std::vector<ColumnStats>> Stats(Segments.size(), std::vector<ColumnStats>(Indices.size()));
+	ThreadPool::Shared().ParallelFor(Segments.size(), [&](std::size_t k) {
+		const Segment& Part = Segments[k];
+		const char* Pos = File->Data() + Part.Begin;
+		const char* End = File->Data() + Part.End;
+		std::string Unquoted;
+		bool Blank;
+		ProgressCounter Counter(Pos);
+		for (std::size_t Row = Part.FirstRow; Row < Part.FirstRow + Part.Rows;) {
+			Pos = SplitRow(Pos, End, Seperator, Unquoted, LastField, Blank,
+				[&](std::size_t Field, const char* FieldBegin, const char* FieldEnd) {
+					std::size_t Slot = Slots[Field];
+					if (Slot == NoSlot) { return; }
+					if (not ParseNumber(FieldBegin, FieldEnd, Decimal, Result[Slot].Values[Row])) { Numeric[k][Slot] = 0; }
+				});
+			if (not Blank) {
+				Row++;
+				Counter.Row(Pos);
+			}
+		}
+		Counter.Flush(End);
+		File->Release(Part.Begin, Part.End);
+		// Summarize the rows of the segment while they are still in the cache:
+		for (std::size_t i = 0; i < Indices.size(); i++) {
+			Stats[k][i].Add(Result[i].Values.data() + Part.FirstRow, Part.Rows);
+		}
+	});
+	for (std::size_t k = 0; k < Segments.size(); k++) {
+		for (std::size_t i = 0; i < Indices.size(); i++) {
+			if (not Numeric[k][i]) { Result[i].Numeric = false; }
+			Result[i].Stats.Merge(Stats[k][i]);
+		}
+	}
+	return Result;
+}
+
+std::vector<DataColumn> CSVSource::Columns(const std::vector<std::size_t>& Indices, std::size_t FirstRow, std::size_t Count) const {
+	FirstRow = std::min(FirstRow, RowCount);
+	Count = std::min(Count, RowCount - FirstRow);
+	std::vector<std::size_t> Slots;
+	const std::size_t NoSlot = std::numeric_limits<std::size_t>::max();
+	std::vector<DataColumn> Result(Indices.size());
+	for (std::size_t i = 0; i < Indices.size(); i++) {
+		if (Indices[i] >= ColNames.size()) {
+			throw std::out_of_range("Column index out of range");
+		}
+		if (Indices[i] >= Slots.size()) { Slots.resize(Indices[i] + 1, NoSlot); }
+		Slots[Indices[i]] = i;
+		Result[i].Name = ColNames[Indices[i]];
+		Result[i].Values.resize(Count, NaN);
+	}
+	if (Count == 0 or Indices.empty()) { return Result; }
+
+	// The range is split into pieces of RangeRows rows which are parsed in parallel, every piece
+	// finds its first row from the nearest mark:
+	const std::size_t LastField = Slots.size() - 1;
+	const char* Data = File->Data();
+	const char* End = Data + File->Size();
+	std::size_t Pieces = (Count + RangeRows - 1) / RangeRows;
+	LoadProgress::Current().BeginPass("Parsing", RowStart(FirstRow + Count) - RowStart(FirstRow));
+	std::vector<std::vector<unsigned char>> Numeric(Pieces, std::vector<unsigned char>(Indices.size(), 1));
+	std::vector<std::vector<ColumnStats>> Stats(Pieces, std::vector<ColumnStats>(Indices.size()));
+	ThreadPool::Shared().ParallelFor(Pieces, [&](std::size_t k) {
+		std::size_t Begin = k * RangeRows;
+		std::size_t Rows = std::min(RangeRows, Count - Begin);
+		const char* First = RowStart(FirstRow + Begin);
+		const char* Pos = First;
+		std::string Unquoted;
+		bool Blank;
+		ProgressCounter Counter(Pos);
+		for (std::size_t Row = Begin; Row < Begin + Rows;) {
+			Pos = SplitRow(Pos, End, Seperator, Unquoted, LastField, Blank,
+				[&](std::size_t Field, const char* FieldBegin, const char* FieldEnd) {
+					std::size_t Slot = Slots[Field];
+					if (Slot == NoSlot) { return; }
+					if (not ParseNumber(FieldBegin, FieldEnd, Decimal, Result[Slot].Values[Row])) { Numeric[k][Slot] = 0; }
+				});
+			if (not Blank) {
+				Row++;
+				Counter.Row(Pos);
+			}
+		}
+		Counter.Flush(Pos);
+		// The parsed text is not needed again, only the values of the range are kept in memory:
+		File->Release(First - Data, Pos - Data);
+		for (std::size_t i = 0; i < Indices.size(); i++) {
+			Stats[k][i].Add(Result[i].Values.data() + Begin, Rows);
+		}
+	});
+	for (std::size_t k = 0; k < Pieces; k++) {
+		for (std::size_t i = 0; i < Indices.size(); i++) {
+			if (not Numeric[k][i]) { Result[i].Numeric = false; }
+			Result[i].Stats.Merge(Stats[k][i]);
+		}
+	}
+	return Result;
+}
+
+CompressedCSVSource::CompressedCSVSource(const std::filesystem::path& Path, char Seperator, char Decimal)
+	: Path(Path), Seperator(Seperator), Decimal(Decimal), ColNames(ReadCSVHeader(Path, Seperator)) {
+}
+
+std::vector<DataColumn> CompressedCSVSource::Columns(const std::vector<std::size_t>& Indices) const {
+	std::vector<std::size_t> Slots;
+	const std::size_t NoSlot = std::numeric_limits<std::size_t>::max();
+	std::vector<DataColumn> Result(Indices.size());
+	for (std::size_t i = 0; i < Indices.size(); i++) {
+		if (Indices[i] >= ColNames.size()) {
+			throw std::out_of_range("Column index out of range");
+		}
+		if (Indices[i] >= Slots.size()) { Slots.resize(Indices[i] + 1, NoSlot); }
+		Slots[Indices[i]] = i;
+		Result[i].Name = ColNames[Indices[i]];
+	}
+	if (Indices.empty()) { return Result; }
+
+	struct Block {
+		std::string Text; // Whole rows
+		std::vector<std::vector<double>> Values;
+		std::vector<unsigned char> Numeric;
+		std::vector<ColumnStats> Stats;
+		std::size_t Rows = 0;
+	};
+
+	DataStream File(Path);
+	ThreadPool& Pool = ThreadPool::Shared();
+	LoadProgress& Progress = LoadProgress::Current();
+	Progress.BeginPass("Parsing", File.FileSize());
+
+	// Decompress blocks of whole rows, the BOM, leading blank lines and the header are dropped first:
+	std::string Carry;
+	bool HeaderSkipped = false;
+	bool Finished = false;
+	auto SkipHeader = [&](bool Last) {
+		const char* Begin = Carry.data();
+		const char* End = Begin + Carry.size();
+		const char* Pos = Begin;
+		if (Carry.size() < 3 and not Last) { return false; }
+		if (Carry.size() >= 3 and std::memcmp(Pos, "\xEF\xBB\xBF", 3) == 0) { Pos += 3; }
+		while (Pos < End) {
+			if (not Last and LastRowEnd(Pos, End, Seperator) == Pos) { return false; }
+			bool Blank = *Pos == '\n' or *Pos == '\r';
+			Pos = SkipRow(Pos, End, Seperator);
+			if (not Blank) { break; }
+		}
+		Carry.erase(0, Pos - Begin);
+		return true;
+	};
+	auto ReadBlocks = [&]() {
+		std::vector<Block> Blocks;
+		while (not Finished and Blocks.size() < Pool.Size()) {
+			std::size_t Size = Carry.size();
+			Carry.resize(Size + BlockSize);
+			Carry.resize(Size + File.Read(Carry.data() + Size, BlockSize));
+			Finished = Carry.size() == Size;
+			if (not HeaderSkipped) {
+				HeaderSkipped = SkipHeader(Finished);
+				if (not HeaderSkipped) { continue; }
+			}
+
+			std::size_t Cut = Finished ? Carry.size() : LastRowEnd(Carry.data(), Carry.data() + Carry.size(), Seperator) - Carry.data();
+			if (Cut == 0) { continue; }
+			Blocks.emplace_back();
+			Blocks.back().Text.assign(Carry, 0, Cut);
+			Carry.erase(0, Cut);
+		}
+		return Blocks;
+	};
+
+	// Parse the blocks in parallel while the next ones are decompressed:
+	const std::size_t LastField = Slots.size() - 1;
+	std::vector<Block> Blocks = ReadBlocks();
+	std::uint64_t Consumed = 0;
+	while (not Blocks.empty()) {
+		std::uint64_t Read = File.Consumed();
+		std::future<std::vector<Block>> Next = std::async(std::launch::async, ReadBlocks);
+		Pool.ParallelFor(Blocks.size(), [&](std::size_t k) {
+			Block& Part = Blocks[k];
+			Part.Values.resize(Indices.size());
+			Part.Numeric.assign(Indices.size(), 1);
+			const char* Pos = Part.Text.data();
+			const char* End = Pos + Part.Text.size();
+			std::string Unquoted;
+			bool Blank;
+			while (Pos < End) {
+				for (std::vector<double>& Values : Part.Values) { Values.push_back(NaN); }
+				Pos = SplitRow(Pos, End, Seperator, Unquoted, LastField, Blank,
+					[&](std::size_t Field, const char* FieldBegin, const char* FieldEnd) {
+						std::size_t Slot = Slots[Field];
+						if (Slot == NoSlot) { return; }
+						if (not ParseNumber(FieldBegin, FieldEnd, Decimal, Part.Values[Slot].back())) { Part.Numeric[Slot] = 0; }
+					});
+				if (Blank) {
+					for (std::vector<double>& Values : Part.Values) { Values.pop_back(); }
+				}
+				else { Part.Rows++; }
+			}
+			Part.Stats.resize(Indices.size());
+			for (std::size_t i = 0; i < Indices.size(); i++) { Part.Stats[i].Add(Part.Values[i].data(), Part.Rows); }
+		});
+
+		std::size_t Rows = 0;
+		for (Block& Part : Blocks) {
+			for (std::size_t i = 0; i < Indices.size(); i++) {
+				Result[i].Values.insert(Result[i].Values.end(), Part.Values[i].begin(), Part.Values[i].end());
+				if (not Part.Numeric[i]) { Result[i].Numeric = false; }
+				Result[i].Stats.Merge(Part.Stats[i]);
+			}
+			Rows += Part.Rows;
+		}
+		Progress.Add(Read - Consumed, Rows);
+		Consumed = Read;
+		Blocks = Next.get();
+	}
+	return Result;
+}
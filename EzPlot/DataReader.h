@@ -0,0 +1,175 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <cstddef>
+#include <memory>
+#include <limits>
+#include "MappedFile.h"
+
+// Summary of the values of a column, NaN values (missing or no number) are only counted:
+struct ColumnStats {
+	std::size_t Count = 0;
+	std::size_t Missing = 0;
+	double Min = std::numeric_limits<double>::infinity();
+	double Max = -std::numeric_limits<double>::infinity();
+	double Sum = 0;
+
+	void Add(const double* Values, std::size_t Size);
+	void Merge(const ColumnStats& Other);
+};
+
+// Column of a parsed data table, fields which are no numbers are stored as NaN:
+struct DataColumn {
+	std::string Name;
+	std::vector<double> Values;
+	bool Numeric = true;
+	ColumnStats Stats; // Collected by the sources while parsing
+	// Values which are used in place in a mapped file instead of Values (Arrow files),
+	// Mapping keeps the file mapped as long as the column exists:
+	const double* External = nullptr;
+	std::size_t ExternalSize = 0;
+	std::shared_ptr<const MappedFile> Mapping;
+
+	const double* Data() const { return External ? External : Values.data(); }
+	std::size_t Size() const { return External ? ExternalSize : Values.size(); }
+};
+
+struct DataTable {
+	std::vector<DataColumn> Columns;
+	std::size_t Rows = 0;
+};
+
+// Data file whose columns are parsed on request:
+class DataSource {
+public:
+	virtual ~DataSource() = default;
+	virtual const std::vector<std::string>& Names() const = 0;
+	// Parse the requested columns in one pass:
+	virtual std::vector<DataColumn> Columns(const std::vector<std::size_t>& Indices) const = 0;
+};
+
+// Streaming CSV tokenizer. The file is fed in chunks, every complete row is parsed
+// directly into the columns and an incomplete row at the end of a chunk is kept back.
+class CSVParser {
+public:
+	CSVParser(char Seperator, char Decimal, bool HeaderOnly = false);
+	void Feed(const char* Data, std::size_t Size);
+	DataTable Finish();
+	bool HasHeader() const { return HeaderRead; }
+
+private:
+	std::size_t ParseRows(const char* Begin, const char* End, bool Last);
+	const char* ParseRow(const char* Pos, const char* End, bool Last);
+	void ReadHeader(const std::vector<std::string>& Names);
+
+	char Seperator;
+	char Decimal;
+	bool HeaderOnly;
+	bool HeaderRead;
+	bool FirstChunk;
+	std::string Carry;
+	std::string Unquoted;
+	std::vector<std::string> HeaderFields;
+	DataTable Table;
+};
+
+// Parse a whole CSV file, gzip and zstd compressed files are decompressed while they are read:
+DataTable ReadCSV(const std::filesystem::path& Path, char Seperator, char Decimal);
+
+// Columnar view on a memory mapped CSV file. The row offsets are indexed once when the
+// source is opened, columns are parsed separately when they are requested. Large files are
+// split into segments of whole rows which are indexed and parsed in parallel.
+class CSVSource : public DataSource {
+public:
+	CSVSource(const std::filesystem::path& Path, char Seperator, char Decimal);
+
+	const std::vector<std::string>& Names() const override { return ColNames; }
+	std::size_t Rows() const { return RowCount; }
+	DataColumn Column(std::size_t Index) const;
+	// Fields behind the last requested column are skipped:
+	std::vector<DataColumn> Columns(const std::vector<std::size_t>& Indices) const override;
+	// Only the rows [FirstRow, FirstRow + Count), so a file larger than the memory is parsed in parts:
+	std::vector<DataColumn> Columns(const std::vector<std::size_t>& Indices, std::size_t FirstRow, std::size_t Count) const;
+	// Text of the fields of up to Count rows from FirstRow on, Names().size() fields per row (empty
+	// if a row is shorter). Rows are found by the offsets of every MarkRows-th row noted while
+	// indexing, so any part of the file is read without parsing the rows in front of it:
+	std::vector<std::string> Cells(std::size_t FirstRow, std::size_t Count) const;
+
+	static const std::size_t MarkRows = 1 << 12;
+
+private:
+	struct Segment {
+		std::size_t Begin; // File offsets, both at row boundaries
+		std::size_t End;
+		std::size_t FirstRow;
+		std::size_t Rows;
+		std::vector<std::size_t> Marks; // File offsets of the rows 0, MarkRows, 2 MarkRows, ... of the segment
+	};
+
+	void BuildIndex();
+	std::size_t ReadHeader();
+	std::size_t CountRows(std::size_t Begin, std::size_t End, std::vector<std::size_t>& Marks) const;
+	const char* RowStart(std::size_t Row) const;
+	bool SplitSegments(std::size_t Begin);
+
+	std::unique_ptr<MappedFile> File;
+	char Seperator;
+	char Decimal;
+	std::vector<std::string> ColNames;
+	std::vector<Segment> Segments;
+	std::size_t RowCount = 0;
+};
+
+// Columnar view on a gzip or zstd compressed CSV file. The file cannot be mapped, so every
+// Columns call streams it through the decompressor again. Decompressed blocks of whole rows are
+// parsed in parallel while the next blocks are decompressed.
+class CompressedCSVSource : public DataSource {
+public:
+	CompressedCSVSource(const std::filesystem::path& Path, char Seperator, char Decimal);
+
+	const std::vector<std::string>& Names() const override { return ColNames; }
+	std::vector<DataColumn> Columns(const std::vector<std::size_t>& Indices) const override;
+
+private:
+	std::filesystem::path Path;
+	char Seperator;
+	char Decimal;
+	std::vector<std::string> ColNames;
+};
+
+// Parse the rows of a growing CSV file from the file offset Begin on into the requested columns
+// (Begin 0 skips the header). Rows which are not completely written yet are left for the next
+// call, the returned offset is the end of the last parsed row:
+std::size_t ReadCSVRows(const std::filesystem::path& Path, char Seperator, char Decimal, std::size_t Begin,
+	const std::vector<std::size_t>& Indices, std::vector<DataColumn>& Columns);
+
+// Dialect of a CSV file as guessed by SniffCSV:
+struct CSVDialect {
+	char Seperator = ',';
+	char Decimal = '.';
+	bool Quoted = false; // Some fields are enclosed in quotes
+	bool Header = true; // First row holds column names and no data
+	double Confidence = 0; // 0 (guessed) ... 1 (sure)
+};
+
+// Guess the dialect from the rows in the first SampleSize bytes (decompressed). Every seperator
+// candidate is scored by how constant the number of fields is and how many fields are numbers
+// with the best decimal sign. Seperator and Decimal are kept if the sample does not decide:
+CSVDialect SniffCSV(const std::filesystem::path& Path, char Seperator, char Decimal, std::size_t SampleSize = 1 << 14);
+
+// Column names of a CSV file, only the first row is read:
+std::vector<std::string> ReadCSVHeader(const std::filesystem::path& Path, char Seperator);
+
+// Fill the statistics of a column from its values in parallel, for sources which do not collect
+// them while parsing:
+void ComputeStats(DataColumn& Column);
+
+// Parse a single field as number, returns false if the field is not numeric (Value is NaN then):
+bool ParseNumber(const char* Begin, const char* End, char Decimal, double& Value);
+
+// True for the default missing value markers of pandas ("NA", "#N/A", "NULL", ...):
+bool IsNAToken(const char* Begin, const char* End);
+
+// Rename duplicated column names like pandas does ("a", "a" -> "a", "a.1"):
+void MangleDuplicateNames(std::vector<std::string>& Names);
@@ -0,0 +1,139 @@
+#include "DataStream.h"
+#include <zlib.h>
+#include <zstd.h>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+namespace {
+
+	const std::size_t InputSize = 1 << 18; // Compressed bytes read from the file at once
+
+	enum class Compression { None, Gzip, Zstd };
+
+	Compression DetectCompression(std::ifstream& File) {
+		unsigned char Magic[4] = {};
+		File.read(reinterpret_cast<char*>(Magic), sizeof(Magic));
+		std::streamsize Count = File.gcount();
+		File.clear();
+		File.seekg(0);
+		if (Count >= 2 and Magic[0] == 0x1F and Magic[1] == 0x8B) { return Compression::Gzip; }
+		if (Count >= 4 and Magic[0] == 0x28 and Magic[1] == 0xB5 and Magic[2] == 0x2F and Magic[3] == 0xFD) {
+			return Compression::Zstd;
+		}
+		return Compression::None;
+	}
+
+}
+
+// Decompressor state, the compressed input is buffered here. A file may consist of several
+// gzip members or zstd frames which are decompressed one after another.
+struct DataStream::Decoder {
+	Compression Type;
+	z_stream Zip = {};
+	ZSTD_DStream* Zstd = nullptr;
+	std::vector<char> Input = std::vector<char>(InputSize);
+	std::size_t InputPos = 0;
+	std::size_t InputEnd = 0;
+	bool FrameEnded = true; // No member or frame is open, so the data may end here
+	bool InputEnded = false;
+
+	explicit Decoder(Compression Type) : Type(Type) {
+		if (Type == Compression::Gzip and inflateInit2(&Zip, 16 + MAX_WBITS) != Z_OK) {
+			throw std::runtime_error("Unable to decompress data file");
+		}
+		if (Type == Compression::Zstd and (Zstd = ZSTD_createDStream()) == nullptr) {
+			throw std::runtime_error("Unable to decompress data file");
+		}
+	}
+
+	~Decoder() {
+		if (Type == Compression::Gzip) { inflateEnd(&Zip); }
+		if (Zstd != nullptr) { ZSTD_freeDStream(Zstd); }
+	}
+
+	// Decompress from the buffered input into [Out, Out + Size), returns the bytes written:
+	std::size_t Decode(char* Out, std::size_t Size) {
+		std::size_t Written = 0;
+		std::size_t Used = 0;
+		if (Type == Compression::Gzip) {
+			Zip.next_in = reinterpret_cast<Bytef*>(Input.data() + InputPos);
+			Zip.avail_in = static_cast<uInt>(InputEnd - InputPos);
+			Zip.next_out = reinterpret_cast<Bytef*>(Out);
+			Zip.avail_out = static_cast<uInt>(std::min<std::size_t>(Size, 1u << 30));
+			uInt Space = Zip.avail_out;
+			int Status = inflate(&Zip, Z_NO_FLUSH);
+			if (Status != Z_OK and Status != Z_STREAM_END and Status != Z_BUF_ERROR) {
+				throw std::runtime_error("Damaged compressed data file");
+			}
+			Used = (InputEnd - InputPos) - Zip.avail_in;
+			Written = Space - Zip.avail_out;
+			if (Used > 0 or Written > 0) { FrameEnded = false; }
+			if (Status == Z_STREAM_END) {
+				inflateReset(&Zip);
+				FrameEnded = true;
+			}
+		}
+		else {
+			ZSTD_inBuffer In = { Input.data() + InputPos, InputEnd - InputPos, 0 };
+			ZSTD_outBuffer Output = { Out, Size, 0 };
+			std::size_t Status = ZSTD_decompressStream(Zstd, &Output, &In);
+			if (ZSTD_isError(Status)) {
+				throw std::runtime_error("Damaged compressed data file");
+			}
+			Used = In.pos;
+			Written = Output.pos;
+			if (Used > 0 or Written > 0) { FrameEnded = Status == 0; }
+		}
+		InputPos += Used;
+		return Written;
+	}
+};
+
+DataStream::DataStream(const std::filesystem::path& Path) : File(Path, std::ios::binary) {
+	if (not File.is_open()) {
+		throw std::runtime_error("Unable to open data file");
+	}
+	Size = std::filesystem::file_size(Path);
+	Compression Type = DetectCompression(File);
+	if (Type != Compression::None) { Codec = std::make_unique<Decoder>(Type); }
+}
+
+DataStream::~DataStream() = default;
+
+bool DataStream::IsCompressed(const std::filesystem::path& Path) {
+	std::ifstream File(Path, std::ios::binary);
+	return File.is_open() and DetectCompression(File) != Compression::None;
+}
+
+std::size_t DataStream::ReadFile(char* Buffer, std::size_t Count) {
+	File.read(Buffer, static_cast<std::streamsize>(Count));
+	std::size_t Read = static_cast<std::size_t>(File.gcount());
+	Position += Read;
+	return Read;
+}
+
+std::size_t DataStream::Read(char* Buffer, std::size_t Count) {
+	if (not Codec) { return ReadFile(Buffer, Count); }
+
+	Decoder& State = *Codec;
+	std::size_t Written = 0;
+	while (Written < Count) {
+		if (State.InputPos == State.InputEnd and not State.InputEnded) {
+			State.InputPos = 0;
+			State.InputEnd = ReadFile(State.Input.data(), State.Input.size());
+			State.InputEnded = State.InputEnd == 0;
+		}
+		if (State.InputEnded and State.FrameEnded) { break; }
+
+		// The decoder may still hold output after all input is used up:
+		std::size_t Before = State.InputPos;
+		std::size_t Produced = State.Decode(Buffer + Written, Count - Written);
+		if (Produced == 0 and State.InputPos == Before) {
+			throw std::runtime_error(State.InputEnded ? "Compressed data file is incomplete" : "Damaged compressed data file");
+		}
+		Written += Produced;
+	}
+	return Written;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Sequential reader of a data file. gzip (.gz) and zstd (.zst) compressed files are recognized
+// by their magic number and decompressed block by block while they are read, so the
+// uncompressed file is never stored anywhere.
+class DataStream {
+public:
+	explicit DataStream(const std::filesystem::path& Path);
+	~DataStream();
+	DataStream(const DataStream&) = delete;
+	DataStream& operator=(const DataStream&) = delete;
+
+	// Fill Buffer with up to Size bytes of (uncompressed) data, returns 0 at the end of the data:
+	std::size_t Read(char* Buffer, std::size_t Size);
+
+	bool Compressed() const { return Codec != nullptr; }
+	// Size of the file and the part of it read so far, both as stored (compressed):
+	std::uint64_t FileSize() const { return Size; }
+	std::uint64_t Consumed() const { return Position; }
+
+	static bool IsCompressed(const std::filesystem::path& Path);
+
+private:
+	struct Decoder;
+
+	std::size_t ReadFile(char* Buffer, std::size_t Count);
+
+	std::ifstream File;
+	std::unique_ptr<Decoder> Codec;
+	std::uint64_t Size = 0;
+	std::uint64_t Position = 0;
+};
@@ -0,0 +1,29 @@
+#include "LoadProgress.h"
+
+LoadProgress& LoadProgress::Current() {
+	static LoadProgress Progress;
+	return Progress;
+}
+
+void LoadProgress::Reset() {
+	Cancelled = false;
+	BeginPass("Loading", 0);
+}
+
+void LoadProgress::BeginPass(const char* Stage, std::uint64_t Total) {
+	Check();
+	CurrentStage = Stage;
+	TotalBytes = Total;
+	BytesDone = 0;
+	RowsDone = 0;
+}
+
+void LoadProgress::Add(std::uint64_t Bytes, std::uint64_t Rows) {
+	BytesDone += Bytes;
+	RowsDone += Rows;
+	Check();
+}
+
+void LoadProgress::Check() const {
+	if (Cancelled) { throw LoadCancelled(); }
+}
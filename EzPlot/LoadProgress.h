@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+// Thrown by the data readers when the running load was cancelled:
+class LoadCancelled : public std::runtime_error {
+public:
+	LoadCancelled() : std::runtime_error("Loading cancelled") {}
+};
+
+// Progress of the data file which is loaded at the moment. The readers add parsed bytes and
+// rows from any thread, the GUI polls them and can cancel the load. Every pass over the file
+// (indexing, parsing) starts counting from zero again.
+class LoadProgress {
+public:
+	// Progress of the one load running in the background
+	static LoadProgress& Current();
+
+	void Reset();
+	void BeginPass(const char* Stage, std::uint64_t TotalBytes);
+	// Count processed bytes and rows, throws LoadCancelled if the load was cancelled:
+	void Add(std::uint64_t Bytes, std::uint64_t Rows);
+	void Check() const;
+	void Cancel() { Cancelled = true; }
+
+	bool IsCancelled() const { return Cancelled; }
+	const char* Stage() const { return CurrentStage; }
+	std::uint64_t Bytes() const { return BytesDone; }
+	std::uint64_t Total() const { return TotalBytes; }
+	std::uint64_t Rows() const { return RowsDone; }
+
+private:
+	std::atomic<const char*> CurrentStage = "Loading";
+	std::atomic<std::uint64_t> BytesDone = 0;
+	std::atomic<std::uint64_t> TotalBytes = 0;
+	std::atomic<std::uint64_t> RowsDone = 0;
+	std::atomic<bool> Cancelled = false;
+};
@@ -2,6 +2,11 @@
 #include "GUIConsole.h"
 #include "PyUtils.h"
 #include "PGEditors.h"
+#include "LoadProgress.h"
+#include "DataReader.h"
+#include "DataPreview.h"
+#include "SettingValue.h"
+#include "PlotChanges.h"
 #include <iostream>
 #include <map>
 #include <string>
@@ -18,18 +23,21 @@
 #include <wx/valnum.h>
 #include <wx/propgrid/propgrid.h>
 #include <wx/propgrid/advprops.h>
+#include <wx/spinctrl.h>
 #include <winuser.h>
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include <windows.h>
 #include <stdlib.h> 
 #include <math.h>
-#include <any>
 #include <tuple>
 #include <optional>
 #include <algorithm>
 #include <limits>
+#include <cctype>
 #include <filesystem>
+#include <memory>
+#include <charconv>
 #include <wx/activityindicator.h>
 //#include <xlnt/xlnt.hpp>
 
@@ -45,8 +53,18 @@ EVT_PG_CHANGED(wxID_ANY, MainFrame::OnPropertyGridChanged)
 EVT_PG_CHANGING(wxID_ANY, MainFrame::OnPropertyGridChanging)
 END_EVENT_TABLE()
 
+// Number of a CSV setting, the default if the settings file holds no number in the range:
+static int SettingNumber(const std::string& Text, int Default, int Min, int Max) {
+	int Value = 0;
+	auto [End, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+	if (Error != std::errc() or End != Text.data() + Text.size() or Value < Min or Value > Max) { return Default; }
+	return Value;
+}
+
 MainFrame::MainFrame(const wxString& title) : wxFrame(NULL, -1, title, wxPoint(-1, -1)) {
 
+	PyLock Lock;
+
 	SetIcon(wxICON(MainIcon));
 
 	char* appdata = getenv("LOCALAPPDATA");
@@ -57,11 +75,14 @@ MainFrame::MainFrame(const wxString& title) : wxFrame(NULL, -1, title, wxPoint(-
 
 	// Add PyFitfunctions path to python path
 	PyObject* sys_path = PySys_GetObject("path");
-	PyList_Append(sys_path, PyUnicode_FromWideChar(PathToAppData.c_str(), wcslen(PathToAppData.c_str())));
+	PyRef AppDataDir(PyUnicode_FromWideChar(PathToAppData.c_str(), wcslen(PathToAppData.c_str())));
+	PyList_Append(sys_path, AppDataDir.Get());
 
 	// Pre-import python modules:
 	print_module = PyImport_ImportModule("python_modules.cprint");
 	fp_module = PyImport_ImportModule("python_modules.file_picker");
+	cache_module = PyImport_ImportModule("python_modules.data_cache");
+	fit_cache_module = PyImport_ImportModule("python_modules.fit_cache");
 	plot_module = PyImport_ImportModule("python_modules.plot");
 
 	std::wstring PyFuncsPath = PathToAppData + L"PyFitfunctions.py";
@@ -71,9 +92,30 @@ MainFrame::MainFrame(const wxString& title) : wxFrame(NULL, -1, title, wxPoint(-
 	fitfunctions_module = PyImport_ImportModule("PyFitfunctions");
 
 	CPlot = PyObject_GetAttrString(plot_module, "CPlot");
-	GetColNames = PyObject_GetAttrString(fp_module, "GetColNames");
+	LoadFile = PyObject_GetAttrString(fp_module, "LoadFile");
+	PreviewRowCount = PyObject_GetAttrString(fp_module, "PreviewRowCount");
+	PreviewRows = PyObject_GetAttrString(fp_module, "PreviewRows");
+	PrepareData = PyObject_GetAttrString(plot_module, "PrepareData");
+	DataLimits = PyObject_GetAttrString(plot_module, "DataLimits");
+	SetCacheLimit = PyObject_GetAttrString(cache_module, "SetCacheLimit");
+	SetOutOfCoreBudget = PyObject_GetAttrString(cache_module, "SetOutOfCoreBudget");
+	SetFitCacheFile = PyObject_GetAttrString(fit_cache_module, "SetProjectFile");
 	catcher = PyObject_GetAttrString(print_module, "catchOutErr");
 	ShowPlot = PyObject_GetAttrString(plot_module, "ShowPlot");
+	Restyle = PyObject_GetAttrString(plot_module, "Restyle");
+	PumpFigures = PyObject_GetAttrString(plot_module, "PumpFigures");
+	CloseFigures = PyObject_GetAttrString(plot_module, "CloseFigures");
+
+	// The figures are shown without blocking the Python thread, it processes their window events
+	// between the jobs and closes them before it ends:
+	Plotter.SetIdle([this]() {
+		PyRef Res(PyObject_CallObject(PumpFigures, NULL));
+		if (!Res) { PyErr_Clear(); }
+	}, std::chrono::milliseconds(20));
+	Plotter.SetLast([this]() {
+		PyRef Res(PyObject_CallObject(CloseFigures, NULL));
+		if (!Res) { PyErr_Clear(); }
+	});
 
 	// Read Lines from Fitfunctions file:
 	std::vector<std::wstring> Lines;
@@ -122,15 +164,24 @@ MainFrame::MainFrame(const wxString& title) : wxFrame(NULL, -1, title, wxPoint(-
 	}
 
 	// Store CSV Settings data in the dictionary:
-	for (int i = 0; i < CSVLines.size(); i++) {
+	for (std::size_t i = 0; i + 1 < CSVLines.size(); i += 2) {
 		CSVSettings[CSVLines[i]] = CSVLines[i + 1];
-		i = i + 1;
 	}
 
 	if (CSVSettings.empty()) {
 		CSVSettings["Seperator"] = ",";
 		CSVSettings["Decimal"] = ".";
 	}
+	// Missing or damaged numbers get their defaults:
+	CSVSettings["Cache Limit"] = std::to_string(SettingNumber(CSVSettings["Cache Limit"], 1024, 0, 65536));
+	CSVSettings["Out-of-core Budget"] = std::to_string(SettingNumber(CSVSettings["Out-of-core Budget"], 0, 0, 65536));
+	if (CSVSettings.find("Fit Cache") == CSVSettings.end()) {
+		CSVSettings["Fit Cache"] = "0";
+	}
+	DataSeperator = CSVSettings["Seperator"];
+	DataDecimal = CSVSettings["Decimal"];
+	ApplyCacheLimit();
+	ApplyOutOfCoreBudget();
 
 	// creating MainPanel and Tabs:
 	MainPanel = new wxPanel(this, wxID_ANY);
@@ -144,12 +195,23 @@ MainFrame::MainFrame(const wxString& title) : wxFrame(NULL, -1, title, wxPoint(-
 		wxFileSelectorDefaultWildcardStr);
 	FilePicker->SetMinSize(wxSize(900, -1));
 	FilePicker->Bind(wxEVT_FILEPICKER_CHANGED, &MainFrame::OnFilePicked, this);
+	DialectText = new wxStaticText(DataTab, wxID_ANY, wxEmptyString);
 
-	/*
+	// Preview of the picked data file, its table fetches only the rows which are shown:
+	PreviewGrid = new wxGrid(DataTab, wxID_ANY);
+	PreviewGrid->SetMinSize(wxSize(900, 250));
+	PreviewGrid->Hide();
+
+	// Shown while a data file is loaded in the background:
 	LoadingIcon = new wxActivityIndicator(DataTab);
 	LoadingIcon->SetMinSize(wxSize(50, 50));
-	LoadingIcon->Start();
-	*/
+	LoadingText = new wxStaticText(DataTab, wxID_ANY, wxEmptyString);
+	LoadingText->SetMinSize(wxSize(300, -1));
+	CancelLoadingButton = new wxButton(DataTab, wxID_ANY, "Cancel");
+	CancelLoadingButton->Bind(wxEVT_BUTTON, &MainFrame::OnCancelLoadingClicked, this);
+	LoadingTimer.SetOwner(this);
+	Bind(wxEVT_TIMER, &MainFrame::OnLoadingTimer, this, LoadingTimer.GetId());
+	Bind(wxEVT_THREAD, &MainFrame::OnPlotDone, this);
 
 	CreateSettingsTab();
 	CreateOutputTab();
@@ -158,18 +220,22 @@ MainFrame::MainFrame(const wxString& title) : wxFrame(NULL, -1, title, wxPoint(-
 	Tabs->AddPage(SettingsTab, L"Settings");
 	Tabs->AddPage(OutputTab, L"Fit Parameters");
 
-	/*
+	// Space is kept when hidden, so the window does not need to grow while loading:
 	LoadingSizer = new wxBoxSizer(wxHORIZONTAL);
-	LoadingSizer->Add(425, 0);
-	LoadingSizer->Add(LoadingIcon);
-	*/
+	LoadingSizer->Add(250, 0);
+	LoadingSizer->Add(LoadingIcon, 0, wxALIGN_CENTER_VERTICAL | wxRESERVE_SPACE_EVEN_IF_HIDDEN);
+	LoadingSizer->Add(LoadingText, 0, wxALIGN_CENTER_VERTICAL | wxLEFT | wxRESERVE_SPACE_EVEN_IF_HIDDEN, 10);
+	LoadingSizer->Add(CancelLoadingButton, 0, wxALIGN_CENTER_VERTICAL | wxLEFT | wxRESERVE_SPACE_EVEN_IF_HIDDEN, 10);
+	ShowLoading(false);
 
 	// Set up the (vertical) sizer for the contents on DataTab:
 	DataSizer = new wxBoxSizer(wxVERTICAL);
 	DataSizer->Add(0, 40);
 	DataSizer->Add(FilePicker, 0, wxALL, 10);
+	DataSizer->Add(DialectText, 0, wxLEFT | wxRIGHT, 10);
 	DataSizer->Add(DataPanel, 0, wxALL, 10);
-	//DataSizer->Add(LoadingSizer, 0, wxALL, 10);
+	DataSizer->Add(LoadingSizer, 0, wxALL, 10);
+	DataSizer->Add(PreviewGrid, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
 	DataTab->SetSizer(DataSizer);
 
 	// Set up the sizer for the Tabs on MainPanel:
@@ -258,6 +324,12 @@ std::string ToRawString(const std::string& input)
 	return output;
 }
 
+MainFrame::~MainFrame() {
+	// The loader uses this frame, readers stop at their next progress update:
+	CancelLoading();
+	if (Loader.joinable()) { Loader.join(); }
+}
+
 void MainFrame::CreateSettingsTab() {
 
 	Colors.Add("black");
@@ -322,6 +394,16 @@ void MainFrame::CreateSettingsTab() {
 	PlotProjection->SetHelpString("Create a polar plot?");
 	PlotProjection->SetAttribute(L"Hint", "False");
 
+	PlotLiveUpdate = PlotSettingsGrid->Append(new wxBoolProperty("Live Update", wxPG_LABEL));
+	PlotLiveUpdate->SetValueToUnspecified();
+	PlotLiveUpdate->SetHelpString("Redraw the plot while the data file grows?");
+	PlotLiveUpdate->SetAttribute(L"Hint", "False");
+
+	PlotSinglePrecision = PlotSettingsGrid->Append(new wxBoolProperty("Single Precision", wxPG_LABEL));
+	PlotSinglePrecision->SetValueToUnspecified();
+	PlotSinglePrecision->SetHelpString("Keep the data as float32 to halve the memory of huge files? Fits are still calculated in float64.");
+	PlotSinglePrecision->SetAttribute(L"Hint", "False");
+
 	PlotSettingsGrid->Append(new wxPropertyCategory("Legend"));
 
 	/*
@@ -1515,68 +1597,193 @@ void MainFrame::OnFilePicked(wxFileDirPickerEvent& event) {
 	ProcessPickedFile();
 }
 
-void MainFrame::ProcessPickedFile() {
+// Print the Python error of a failed load to the output catcher, a cancelled load is no error:
+static void ReportLoadError() {
+	if (LoadProgress::Current().IsCancelled()) { PyErr_Clear(); }
+	else { PyErr_Print(); }
+}
+
+// Guessed dialects below are not used, the CSV settings are taken instead:
+static const double MinDialectConfidence = 0.6;
+
+// Arrow IPC (Feather) files are mapped by ezdata, they have no dialect:
+static bool IsArrowFile(const std::string& Path) {
+	std::string Extension = std::filesystem::path(Path).extension().string();
+	std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](unsigned char c) { return std::tolower(c); });
+	return Extension == ".arrow" or Extension == ".feather" or Extension == ".ipc" or Extension == ".arrows";
+}
+
+void MainFrame::ProcessPickedFile(std::function<void(bool)> Loaded, bool KeepDialect) {
 
 	// Stop if is not a table file:
 	wxString wxPath = FilePicker->GetPath();
 
 	if (wxPath == "") {
+		CancelLoading();
 		if (ListsCreated) {
 			XChoice->Clear();
 			XErrChoice->Clear();
 			YChoice->Clear();
 			YErrChoice->Clear();
-			XList->Clear();
-			XErrList->Clear();
-			YList->Clear();
-			YErrList->Clear();
 		}
+		ClearDataLists();
+		PreviewGrid->Hide();
+		if (Loaded) { Loaded(false); }
 		return;
 	}
 
-	const char* Path = wxPath.mb_str();
-	if (std::strstr(Path, ".xlsx") == nullptr && std::strstr(Path, ".csv") == nullptr) {
-		wxMessageBox("File is not a \".xslx\" or \".csv\" file.");
+	std::string Path(wxPath.mb_str());
+	if (std::strstr(Path.c_str(), ".xlsx") == nullptr && std::strstr(Path.c_str(), ".csv") == nullptr && not IsArrowFile(Path)) {
+		wxMessageBox("File is not a \".xslx\", \".csv\", \".csv.gz\", \".csv.zst\" or Arrow (\".arrow\", \".feather\") file.");
+		if (Loaded) { Loaded(false); }
 		return;
 	}
 
 	// Stop if table file does not exist:
 	if (not std::filesystem::exists(Path)) {
 		wxMessageBox("File does not exist.");
+		if (Loaded) { Loaded(false); }
 		return;
 	}
 
 	// If no plot name set, change plot name to file name:
 	FileName = FilePicker->GetFileName().GetName();
 
-	// Get column names of picked file:
-	const char* Seperator = CSVSettings["Seperator"].c_str();
-	const char* Decimal = CSVSettings["Decimal"].c_str();
-	PyObject* Args = Py_BuildValue("(sss)", Path, Seperator, Decimal);
-	PyObject* ColNames = PyObject_CallObject(GetColNames, Args);
-	vector<const char*> cRes = listTupleToVector_String(ColNames);
+	// Seperator and decimal sign of a CSV file are guessed from its first rows, unless they are
+	// kept (restored from the project or set in the CSV settings):
+	bool IsCSV = std::strstr(Path.c_str(), ".xlsx") == nullptr and not IsArrowFile(Path);
+	bool Sniff = IsCSV and not KeepDialect;
+	auto Dialect = std::make_shared<CSVDialect>();
+	Dialect->Seperator = (KeepDialect ? DataSeperator : CSVSettings["Seperator"])[0];
+	Dialect->Decimal = (KeepDialect ? DataDecimal : CSVSettings["Decimal"])[0];
+
+	// Get column names and index the picked file on the loading thread:
+	auto Names = std::make_shared<std::vector<std::string>>();
+	auto Rows = std::make_shared<std::size_t>(0);
+	LoadInBackground([this, Path, Sniff, Dialect, Names, Rows]() {
+		if (Sniff) {
+			try {
+				CSVDialect Guess = SniffCSV(Path, Dialect->Seperator, Dialect->Decimal);
+				if (Guess.Confidence >= MinDialectConfidence) { *Dialect = Guess; }
+				else { Dialect->Confidence = Guess.Confidence; }
+			}
+			catch (const std::exception&) {} // Loading the file reports the error
+		}
+		std::string Seperator(1, Dialect->Seperator);
+		std::string Decimal(1, Dialect->Decimal);
+		PyLock Lock;
+		PyRef Args(Py_BuildValue("(sss)", Path.c_str(), Seperator.c_str(), Decimal.c_str()));
+		PyRef ColNames(PyObject_CallObject(LoadFile, Args.Get()));
+		if (!ColNames) {
+			ReportLoadError();
+			return false;
+		}
+		for (const char* Name : listTupleToVector_String(ColNames.Get())) {
+			Names->push_back(Name);
+		}
+
+		// The preview is left out if its rows cannot be counted:
+		PyRef RowCount(PyObject_CallObject(PreviewRowCount, Args.Get()));
+		if (RowCount) { *Rows = PyLong_AsSize_t(RowCount.Get()); }
+		if (PyErr_Occurred()) {
+			*Rows = 0;
+			PyErr_Clear();
+		}
+		return true;
+	}, [this, Path, Names, Rows, Loaded, IsCSV, Sniff, Dialect](bool Success) {
+		if (Success) {
+			DataSeperator = std::string(1, Dialect->Seperator);
+			DataDecimal = std::string(1, Dialect->Decimal);
+			if (not IsCSV) { DialectText->SetLabel(wxEmptyString); }
+			else if (not Sniff) { ShowDialect(wxEmptyString); }
+			else if (Dialect->Confidence < MinDialectConfidence) {
+				ShowDialect(wxString::Format("CSV settings, detection only %.0f %% sure", 100 * Dialect->Confidence));
+			}
+			else {
+				wxString Note = wxString::Format("detected, %.0f %% sure", 100 * Dialect->Confidence);
+				if (not Dialect->Header) { Note += ", first row looks like data but is used as column names"; }
+				ShowDialect(Note);
+			}
+			ShowColumnNames(*Names);
+			SyncDataEntries();
+			ShowPreview(Path, *Rows);
+		}
+		if (Loaded) { Loaded(Success); }
+	});
+}
+
+void MainFrame::ShowDialect(const wxString& Note) {
+	wxString Seperator = DataSeperator == "\t" ? wxString("Tab") : wxString("\"" + DataSeperator + "\"");
+	wxString Text = "Seperator " + Seperator + ", decimal sign \"" + wxString(DataDecimal) + "\"";
+	if (not Note.empty()) { Text += " (" + Note + ")"; }
+	DialectText->SetLabel(Text);
+	DataTab->Layout();
+}
 
-	Py_DECREF(ColNames);
+// Entries of the picked file follow its dialect, entries of columns it does not have anymore
+// (the seperator was corrected) are removed. Entries of other files are not touched.
+void MainFrame::SyncDataEntries() {
+	if (not ListsCreated) { return; }
+	std::wstring Path = FilePicker->GetPath().ToStdWstring();
+	bool Removed = false;
+	for (std::size_t i = DataEntries.size(); i-- > 0;) {
+		DataEntry& Entry = DataEntries[i];
+		if (Entry.Path != Path) { continue; }
+		Entry.Seperator = DataSeperator;
+		Entry.Decimal = DataDecimal;
+		if (DataNames.Index(XList->GetString(i)) == wxNOT_FOUND or DataNames.Index(Entry.YColumn) == wxNOT_FOUND) {
+			DeleteDataEntry(i);
+			Removed = true;
+		}
+	}
+	if (Removed) { UpdateSettingsData(); }
+}
+
+void MainFrame::DeleteDataEntry(unsigned int Index) {
+	XErrList->Delete(Index);
+	XList->Delete(Index);
+	YErrList->Delete(Index);
+	YList->Delete(Index);
+	DataEntries.erase(DataEntries.begin() + Index);
+}
+
+void MainFrame::ClearDataLists() {
+	if (ListsCreated) {
+		XList->Clear();
+		XErrList->Clear();
+		YList->Clear();
+		YErrList->Clear();
+	}
+	DataEntries.clear();
+}
+
+void MainFrame::ShowPreview(const std::string& Path, std::size_t Rows) {
+	PreviewGrid->SetTable(new DataPreviewTable(PreviewRows, Path, DataSeperator, DataDecimal, Rows, DataNames), true);
+	PreviewGrid->EnableEditing(false);
+	PreviewGrid->SetRowLabelSize(80); // Autosizing would measure the label of every row
+	PreviewGrid->Show(Rows > 0);
+	PreviewGrid->ForceRefresh();
+	DataTab->Layout();
+}
+
+void MainFrame::ShowColumnNames(const std::vector<std::string>& Names) {
 
 	// Add DataNames
-	for (int i = 0; i < cRes.size(); i++) {
-		DataNames.Add(cRes[i]);
+	DataNames.Clear();
+	for (const std::string& Name : Names) {
+		DataNames.Add(wxString::FromUTF8(Name));
 	}
 
 	if (DataPanelHidden) {
 		DataPanel->Show();
 		DataPanelHidden = false;
 	}
-	// if List already created only update content
+	// if List already created only update content, the data lists keep the entries of every file
 	if (ListsCreated) {
 		XChoice->Clear();
 		XErrChoice->Clear();
 		YChoice->Clear();
 		YErrChoice->Clear();
-		XList->Clear();
-		XErrList->Clear();
-		YList->Clear();
-		YErrList->Clear();
 
 		DataNames.Insert("", 0); // empty field at beginning
 		XChoice->Append(DataNames);
@@ -1702,6 +1909,107 @@ void MainFrame::ProcessPickedFile() {
 
 }
 
+void MainFrame::LoadInBackground(std::function<bool()> Load, std::function<void(bool)> Done) {
+
+	// A new load replaces the running one, it starts when the cancelled one has stopped:
+	CancelLoading();
+	LoadingDone = Done;
+	PendingLoad = Load;
+	if (ListsCreated) { PlotButton->Disable(); }
+	ShowLoading(true);
+	LoadingTimer.Start(100);
+	if (not Loader.joinable()) { StartLoading(); }
+}
+
+void MainFrame::StartLoading() {
+	LoadProgress::Current().Reset();
+	std::function<bool()> Load = std::move(PendingLoad);
+	PendingLoad = nullptr;
+	unsigned long Job = ++LoadingJob;
+	Loader = std::thread([this, Load, Job]() {
+		bool Loaded = Load();
+		CallAfter([this, Job, Loaded]() { LoaderStopped(Job, Loaded); });
+	});
+}
+
+void MainFrame::LoaderStopped(unsigned long Job, bool Loaded) {
+	// Posted as the last step of the loader, so joining does not wait:
+	Loader.join();
+	if (Job == LoadingJob) {
+		FinishLoading(Loaded);
+		return;
+	}
+
+	// Result of a cancelled load is dropped, a load waiting for it starts now:
+	LoadProgress::Current().Reset();
+	if (PendingLoad) { StartLoading(); }
+	else if (ListsCreated and not Plotting) { PlotButton->Enable(); }
+}
+
+void MainFrame::FinishLoading(bool Loaded) {
+	LoadingTimer.Stop();
+	ShowLoading(false);
+	if (ListsCreated and not Plotting) { PlotButton->Enable(); }
+
+	// Readers throw as long as the flag is set, so it is reset for the next load:
+	bool Cancelled = LoadProgress::Current().IsCancelled();
+	LoadProgress::Current().Reset();
+	std::function<void(bool)> Done = std::move(LoadingDone);
+	LoadingDone = nullptr;
+
+	if (not Loaded and not Cancelled) {
+		wxMessageBox(
+			"Data file could not be read. \n"
+			"Check if CSV seperator and decimal signs are correct.");
+	}
+	if (Done) { Done(Loaded and not Cancelled); }
+}
+
+void MainFrame::CancelLoading() {
+	// Stop the running load without waiting for it, its result is dropped in LoaderStopped:
+	PendingLoad = nullptr;
+	if (not Loader.joinable()) { return; }
+	LoadProgress::Current().Cancel();
+	LoadingJob++;
+	LoadingTimer.Stop();
+	ShowLoading(false);
+	if (ListsCreated and not Plotting) { PlotButton->Enable(); }
+	LoadingDone = nullptr;
+}
+
+void MainFrame::ShowLoading(bool Show) {
+	if (Show) {
+		LoadingText->SetLabel("Loading ...");
+		LoadingIcon->Start();
+		CancelLoadingButton->Enable();
+	}
+	else {
+		LoadingIcon->Stop();
+	}
+	LoadingIcon->Show(Show);
+	LoadingText->Show(Show);
+	CancelLoadingButton->Show(Show);
+	DataTab->Layout();
+}
+
+void MainFrame::OnCancelLoadingClicked(wxCommandEvent& event) {
+	// The GUI goes on at once, the readers stop at their next progress update:
+	std::function<void(bool)> Done = std::move(LoadingDone);
+	CancelLoading();
+	if (Done) { Done(false); }
+}
+
+void MainFrame::OnLoadingTimer(wxTimerEvent& event) {
+	LoadProgress& Progress = LoadProgress::Current();
+	if (Progress.IsCancelled()) { return; }
+
+	const double MB = 1024.0 * 1024.0;
+	wxString Text = wxString::Format("%s: %.1f", Progress.Stage(), Progress.Bytes() / MB);
+	if (Progress.Total() > 0) { Text += wxString::Format(" of %.1f", Progress.Total() / MB); }
+	Text += wxString::Format(" MB, %llu rows", static_cast<unsigned long long>(Progress.Rows()));
+	LoadingText->SetLabel(Text);
+}
+
 void MainFrame::OnNew(wxCommandEvent& event) {
 	ClearAll();
 }
@@ -1712,13 +2020,16 @@ void MainFrame::ClearAll() {
 		FilePicker->SetPath("Data table file");
 		FileName = "";
 		DataPanelHidden = true;
-		XList->Clear();
-		XErrList->Clear();
-		YList->Clear();
-		YErrList->Clear();
 	}
+	ProjectPath.clear();
+	ApplyFitCacheFile();
+	ClearDataLists();
+	PreviewGrid->Hide();
 
 	OutputText->SetValue("");
+	DialectText->SetLabel(wxEmptyString);
+	DataSeperator = CSVSettings["Seperator"];
+	DataDecimal = CSVSettings["Decimal"];
 
 
 	for (wxPropertyGridIterator it = FitSettingsGrid->GetIterator(wxPG_ITERATE_DEFAULT); !it.AtEnd(); it++)
@@ -1763,6 +2074,8 @@ void MainFrame::OnOpen(wxCommandEvent& event) {
 		return;     // the user changed idea...
 
 	ClearAll();
+	ProjectPath = openFileDialog.GetPath().ToStdWstring();
+	ApplyFitCacheFile();
 
 	// Read Lines from file:
 	std::vector<std::wstring> Lines;
@@ -1777,27 +2090,56 @@ void MainFrame::OnOpen(wxCommandEvent& event) {
 		myfile.close();
 	}
 
+	// Dialect of the data file is stored at the end, older projects let it be guessed:
+	std::size_t Count = Lines.size();
+	bool KeepDialect = Count >= 4 and Lines[Count - 4] == L"Seperator" and Lines[Count - 2] == L"Decimal"
+		and Lines[Count - 3].size() == 1 and Lines[Count - 1].size() == 1;
+	if (KeepDialect) {
+		DataSeperator = wxString(Lines[Count - 3]).ToStdString();
+		DataDecimal = wxString(Lines[Count - 1]).ToStdString();
+	}
+
+	// Data lists and settings are restored when the data file is loaded:
 	FilePicker->SetPath(Lines[0]);
-	ProcessPickedFile();
+	ProcessPickedFile([this, Lines](bool Loaded) { RestoreProject(Lines, Loaded); }, KeepDialect);
 	if (Lines[0] == "") { FilePicker->SetPath("Data table file"); }
+}
+
+void MainFrame::RestoreProject(const std::vector<std::wstring>& Lines, bool Loaded) {
 
 	unsigned int XSize = std::stoi(Lines[1]);
 	unsigned int XErrSize = std::stoi(Lines[2]);
 	unsigned int YSize = std::stoi(Lines[3]);
 	unsigned int YErrSize = std::stoi(Lines[4]);
 
-	if (ListsCreated and Lines[0] != "" and std::filesystem::exists(Lines[0])) {
-		for (unsigned int i = 0; i < XSize; i++) {
-			XList->Append(Lines[5 + i]);
+	// Data file of every entry, older projects have all entries from the file in the first line:
+	std::vector<DataEntry> Entries;
+	for (std::size_t Line = Lines.size(); Line-- > 0;) {
+		if (Lines[Line] != L"Entries" or Line + 1 >= Lines.size()) { continue; }
+		std::size_t Count = wcstoul(Lines[Line + 1].c_str(), nullptr, 10);
+		if (Count != YSize or Line + 2 + 4 * Count > Lines.size()) { break; }
+		for (std::size_t i = 0; i < Count; i++) {
+			const std::wstring* Entry = &Lines[Line + 2 + 4 * i];
+			Entries.push_back({ Entry[0], wxString(Entry[1]).ToStdString(), wxString(Entry[2]).ToStdString(), Entry[3] });
 		}
-		for (unsigned int i = 0; i < XErrSize; i++) {
-			XErrList->Append(Lines[5 + i + XSize]);
+		break;
+	}
+	if (Entries.size() != YSize) {
+		Entries.clear();
+		for (unsigned int i = 0; i < YSize; i++) {
+			Entries.push_back({ Lines[0], DataSeperator, DataDecimal, Lines[5 + i + XSize + XErrSize] });
 		}
+	}
+
+	// Entries of missing data files are left out:
+	if (Loaded and ListsCreated and XSize == YSize and XErrSize == YSize and YErrSize == YSize) {
 		for (unsigned int i = 0; i < YSize; i++) {
+			if (Entries[i].Path == L"" or not std::filesystem::exists(Entries[i].Path)) { continue; }
+			XList->Append(Lines[5 + i]);
+			XErrList->Append(Lines[5 + i + XSize]);
 			YList->Append(Lines[5 + i + XSize + XErrSize]);
-		}
-		for (unsigned int i = 0; i < YErrSize; i++) {
 			YErrList->Append(Lines[5 + i + XSize + XErrSize + YSize]);
+			DataEntries.push_back(Entries[i]);
 		}
 	}
 
@@ -1854,6 +2196,9 @@ void MainFrame::OnSave(wxCommandEvent& event) {
 		std::filesystem::create_directories(PathToAppData);
 	}
 
+	// Data files of the entries copied into the project folder:
+	std::map<std::wstring, std::wstring> CopiedFiles;
+
 	if (saveFileDialog.GetFilterIndex() == 1) { // png file
 		std::wstring PlotFilePath = PathToAppData + L"plot.png";
 		if (std::filesystem::exists(PlotFilePath)) {
@@ -1865,11 +2210,20 @@ void MainFrame::OnSave(wxCommandEvent& event) {
 
 		// Create Project folder and copy plot files into it:
 		std::filesystem::create_directories(Path);
+		std::wstring Folder = Path;
 		Path = Path + LR"(\)" + saveFileDialog.GetFilename().ToStdWstring();
 		std::wstring TableFilePath = FilePicker->GetPath().ToStdWstring();
 		if (std::filesystem::exists(TableFilePath)) {
 			std::wstring FileType = TableFilePath.substr(TableFilePath.size() - 4);
 			std::filesystem::copy_file(TableFilePath, Path + FileType);
+			CopiedFiles[TableFilePath] = Path + FileType;
+		}
+		// Other data files of the entries keep their names:
+		for (const DataEntry& Entry : DataEntries) {
+			if (CopiedFiles.count(Entry.Path) or not std::filesystem::exists(Entry.Path)) { continue; }
+			std::wstring Copy = Folder + LR"(\)" + std::filesystem::path(Entry.Path).filename().wstring();
+			std::filesystem::copy_file(Entry.Path, Copy, std::filesystem::copy_options::skip_existing);
+			CopiedFiles[Entry.Path] = Copy;
 		}
 		std::wstring PlotFilePath = PathToAppData + L"plot.png";
 		if (std::filesystem::exists(PlotFilePath)) {
@@ -1884,6 +2238,7 @@ void MainFrame::OnSave(wxCommandEvent& event) {
 
 	ofstream SaveFile;
 	SaveFile.open(Path);
+	ProjectPath = Path;
 
 	if (saveFileDialog.GetFilterIndex() == 2) {
 		std::wstring TableFilePath = FilePicker->GetPath().ToStdWstring();
@@ -1943,7 +2298,24 @@ void MainFrame::OnSave(wxCommandEvent& event) {
 		SaveFile << prop->GetValueAsString() << "\n";
 	}
 
+	// Data file of every entry, older projects take all entries from the file in the first line:
+	SaveFile << "Entries" << "\n";
+	SaveFile << DataEntries.size() << "\n";
+	for (const DataEntry& Entry : DataEntries) {
+		SaveFile << wxString(CopiedFiles.count(Entry.Path) ? CopiedFiles[Entry.Path] : Entry.Path) << "\n";
+		SaveFile << Entry.Seperator << "\n";
+		SaveFile << Entry.Decimal << "\n";
+		SaveFile << wxString(Entry.YColumn) << "\n";
+	}
+
+	// Dialect of the data file, so it is not guessed again when the project is opened:
+	SaveFile << "Seperator" << "\n";
+	SaveFile << DataSeperator << "\n";
+	SaveFile << "Decimal" << "\n";
+	SaveFile << DataDecimal << "\n";
+
 	SaveFile.close();
+	ApplyFitCacheFile();
 	
 }
 
@@ -1974,9 +2346,13 @@ void MainFrame::OpenCSVSettings() {
 
 	wxStaticText* SeperatorLabel = new wxStaticText(CSVSettingsPanel, wxID_ANY, L"Seperator:");
 	wxStaticText* DecimalLabel = new wxStaticText(CSVSettingsPanel, wxID_ANY, L"Decimal:");
+	wxStaticText* CacheLimitLabel = new wxStaticText(CSVSettingsPanel, wxID_ANY, L"Cache (MB):");
+	wxStaticText* OutOfCoreBudgetLabel = new wxStaticText(CSVSettingsPanel, wxID_ANY, L"Out-of-core (MB):");
 
 	SeperatorLabel->SetMinSize(wxSize(50, 50));
 	DecimalLabel->SetMinSize(wxSize(50, 50));
+	CacheLimitLabel->SetMinSize(wxSize(50, 50));
+	OutOfCoreBudgetLabel->SetMinSize(wxSize(50, 50));
 
 	wxArrayString Seperators;
 	Seperators.Add(",");
@@ -1996,6 +2372,26 @@ void MainFrame::OpenCSVSettings() {
 	DecimalChoice->SetStringSelection(CSVSettings["Decimal"]);
 	DecimalChoice->Bind(wxEVT_CHOICE, &MainFrame::OnDecimalSelected, this);
 
+	// Memory cap for parsed data tables kept in the cache:
+	CacheLimitCtrl = new wxSpinCtrl(CSVSettingsPanel, wxID_ANY, wxEmptyString, wxPoint(-1, -1),
+		wxSize(-1, -1), wxSP_ARROW_KEYS, 0, 65536, SettingNumber(CSVSettings["Cache Limit"], 1024, 0, 65536));
+	CacheLimitCtrl->SetHelpText("Memory used to keep parsed data files for faster replotting.");
+	CacheLimitCtrl->Bind(wxEVT_SPINCTRL, &MainFrame::OnCacheLimitChanged, this);
+
+	// Memory for streaming data files which are kept on disk, 0 reads them into memory:
+	OutOfCoreBudgetCtrl = new wxSpinCtrl(CSVSettingsPanel, wxID_ANY, wxEmptyString, wxPoint(-1, -1),
+		wxSize(-1, -1), wxSP_ARROW_KEYS, 0, 65536, SettingNumber(CSVSettings["Out-of-core Budget"], 0, 0, 65536));
+	OutOfCoreBudgetCtrl->SetHelpText("Memory used to plot and fit data files which are larger than the RAM. "
+		"Their columns stay on disk and are read in parts, 0 reads the whole file into memory.");
+	OutOfCoreBudgetCtrl->Bind(wxEVT_SPINCTRL, &MainFrame::OnOutOfCoreBudgetChanged, this);
+
+	// Fit results are always cached in memory, this keeps them in a file next to the project:
+	FitCacheCheck = new wxCheckBox(CSVSettingsPanel, wxID_ANY, L"Store fit results next to the project");
+	FitCacheCheck->SetValue(CSVSettings["Fit Cache"] == "1");
+	FitCacheCheck->SetHelpText("Fits which were calculated before with the same data and settings are "
+		"taken from \"<project>.ezfit\" instead of fitting again, also after EzPlot was restarted.");
+	FitCacheCheck->Bind(wxEVT_CHECKBOX, &MainFrame::OnFitCacheClicked, this);
+
 	wxBoxSizer* SeperatorSizer = new wxBoxSizer(wxHORIZONTAL);
 	SeperatorSizer->Add(SeperatorLabel, 0, wxRIGHT, 20);
 	SeperatorSizer->Add(SeperatorChoice, 0);
@@ -2004,10 +2400,21 @@ void MainFrame::OpenCSVSettings() {
 	DecimalSizer->Add(DecimalLabel, 0, wxRIGHT, 20);
 	DecimalSizer->Add(DecimalChoice, 0);
 
+	wxBoxSizer* CacheLimitSizer = new wxBoxSizer(wxHORIZONTAL);
+	CacheLimitSizer->Add(CacheLimitLabel, 0, wxRIGHT, 20);
+	CacheLimitSizer->Add(CacheLimitCtrl, 0);
+
+	wxBoxSizer* OutOfCoreBudgetSizer = new wxBoxSizer(wxHORIZONTAL);
+	OutOfCoreBudgetSizer->Add(OutOfCoreBudgetLabel, 0, wxRIGHT, 20);
+	OutOfCoreBudgetSizer->Add(OutOfCoreBudgetCtrl, 0);
+
 	// Set up the sizer for the contents on CSVSettingsPanel:
 	wxBoxSizer* CSVPanelSizer = new wxBoxSizer(wxVERTICAL);
 	CSVPanelSizer->Add(SeperatorSizer, 0, wxEXPAND | wxALL, 10);
 	CSVPanelSizer->Add(DecimalSizer, 0, wxEXPAND | wxALL, 10);
+	CSVPanelSizer->Add(CacheLimitSizer, 0, wxEXPAND | wxALL, 10);
+	CSVPanelSizer->Add(OutOfCoreBudgetSizer, 0, wxEXPAND | wxALL, 10);
+	CSVPanelSizer->Add(FitCacheCheck, 0, wxEXPAND | wxALL, 10);
 	CSVSettingsPanel->SetSizer(CSVPanelSizer);
 
 	// Set up the sizer for the contents on CSVSettingsFrame:
@@ -2015,7 +2422,7 @@ void MainFrame::OpenCSVSettings() {
 	CSVSettingsFrameSizer->Add(CSVSettingsPanel, 1, wxEXPAND);
 	CSVSettingsFrame->SetSizerAndFit(CSVSettingsFrameSizer);
 
-	CSVSettingsFrame->SetMinSize(wxSize(250, 150));
+	CSVSettingsFrame->SetMinSize(wxSize(250, 200));
 
 	CSVSettingsFrame->Show();
 
@@ -2146,11 +2553,61 @@ void MainFrame::OnPlotWindowClose(wxCloseEvent& event) {
 void MainFrame::OnSeperatorSelected(wxCommandEvent& event) {
 	CSVSettings["Seperator"] = SeperatorChoice->GetStringSelection().ToStdString();
 	SaveCSVSettings();
+
+	// Correct the guess for the loaded CSV file, its column names change with the seperator:
+	if (not DialectText->GetLabel().empty()) {
+		DataSeperator = CSVSettings["Seperator"];
+		ProcessPickedFile(nullptr, true);
+	}
 }
 
 void MainFrame::OnDecimalSelected(wxCommandEvent& event) {
 	CSVSettings["Decimal"] = DecimalChoice->GetStringSelection().ToStdString();
 	SaveCSVSettings();
+
+	if (not DialectText->GetLabel().empty()) {
+		DataDecimal = CSVSettings["Decimal"];
+		ShowDialect(wxEmptyString);
+		SyncDataEntries();
+	}
+}
+
+void MainFrame::OnCacheLimitChanged(wxSpinEvent& event) {
+	CSVSettings["Cache Limit"] = std::to_string(CacheLimitCtrl->GetValue());
+	ApplyCacheLimit();
+	SaveCSVSettings();
+}
+
+void MainFrame::ApplyCacheLimit() {
+	PyLock Lock;
+	PyRef Res(PyObject_CallFunction(SetCacheLimit, "i", SettingNumber(CSVSettings["Cache Limit"], 1024, 0, 65536)));
+}
+
+void MainFrame::OnOutOfCoreBudgetChanged(wxSpinEvent& event) {
+	CSVSettings["Out-of-core Budget"] = std::to_string(OutOfCoreBudgetCtrl->GetValue());
+	ApplyOutOfCoreBudget();
+	SaveCSVSettings();
+}
+
+void MainFrame::ApplyOutOfCoreBudget() {
+	PyLock Lock;
+	PyRef Res(PyObject_CallFunction(SetOutOfCoreBudget, "i", SettingNumber(CSVSettings["Out-of-core Budget"], 0, 0, 65536)));
+}
+
+void MainFrame::OnFitCacheClicked(wxCommandEvent& event) {
+	CSVSettings["Fit Cache"] = FitCacheCheck->GetValue() ? "1" : "0";
+	ApplyFitCacheFile();
+	SaveCSVSettings();
+}
+
+void MainFrame::ApplyFitCacheFile() {
+	// Runs on the Python thread, which is the only one using the fit cache:
+	std::wstring Path = CSVSettings["Fit Cache"] == "1" ? ProjectPath : std::wstring();
+	Plotter.Post([this, Path]() {
+		PyRef PyPath(PyUnicode_FromWideChar(Path.c_str(), Path.size()));
+		PyRef Res(PyPath ? PyObject_CallFunctionObjArgs(SetFitCacheFile, PyPath.Get(), NULL) : NULL);
+		if (!Res) { PyErr_Print(); }
+	});
 }
 
 void MainFrame::SaveCSVSettings() {
@@ -2166,6 +2623,12 @@ void MainFrame::SaveCSVSettings() {
 	CSVSettingsFile << CSVSettings["Seperator"] << "\n";
 	CSVSettingsFile << "Decimal" << "\n";
 	CSVSettingsFile << CSVSettings["Decimal"] << "\n";
+	CSVSettingsFile << "Cache Limit" << "\n";
+	CSVSettingsFile << CSVSettings["Cache Limit"] << "\n";
+	CSVSettingsFile << "Out-of-core Budget" << "\n";
+	CSVSettingsFile << CSVSettings["Out-of-core Budget"] << "\n";
+	CSVSettingsFile << "Fit Cache" << "\n";
+	CSVSettingsFile << CSVSettings["Fit Cache"] << "\n";
 }
 
 void MainFrame::OnFuncSelected(wxCommandEvent& event) {
@@ -2269,7 +2732,16 @@ void MainFrame::OnSaveFuncClicked(wxCommandEvent& event) {
 	FunctionsPyFile.close();
 
 	// Reload python functions:
-	fitfunctions_module = PyImport_ReloadModule(fitfunctions_module);
+	{
+		PyLock Lock;
+		PyObject* Reloaded = PyImport_ReloadModule(fitfunctions_module);
+		if (Reloaded) {
+			Py_DECREF(fitfunctions_module);
+			fitfunctions_module = Reloaded;
+			LastPlot.DataInfos.clear(); // Functions of the same name may have changed, refit them
+		}
+		else { PyErr_Print(); }
+	}
 
 	// Update Function Choice Widgets:
 	FitFunctions.Add(L"[new]");
@@ -2533,12 +3005,24 @@ void MainFrame::OnAddClicked(wxCommandEvent& event) {
 		YErrSelected = "[NULL]";
 	}
 
-	int SameY = YList->FindString(YSelected);
+	// Entries remember the file they were added from, picking another file adds to the lists:
+	DataEntry Entry = { FilePicker->GetPath().ToStdWstring(), DataSeperator, DataDecimal, YSelected.ToStdWstring() };
+	int SameY = wxNOT_FOUND;
+	for (std::size_t i = 0; i < DataEntries.size(); i++) {
+		if (DataEntries[i].Path == Entry.Path and DataEntries[i].YColumn == Entry.YColumn) { SameY = static_cast<int>(i); }
+	}
 	if (SameY == wxNOT_FOUND) {
+		// Same column of another file is labelled with the file name:
+		wxString YLabel = YSelected;
+		wxString DataFile = FilePicker->GetFileName().GetFullName();
+		for (int n = 1; YList->FindString(YLabel) != wxNOT_FOUND; n++) {
+			YLabel = YSelected + " (" + DataFile + (n > 1 ? wxString::Format(" %d", n) : wxString()) + ")";
+		}
 		XList->Append(XSelected);
 		XErrList->Append(XErrSelected);
-		YList->Append(YSelected);
+		YList->Append(YLabel);
 		YErrList->Append(YErrSelected);
+		DataEntries.push_back(Entry);
 	}
 	else { // if Y-Data already added only replace Error
 		XErrList->SetString(SameY, XErrSelected);
@@ -2551,8 +3035,13 @@ void MainFrame::OnAddClicked(wxCommandEvent& event) {
 
 std::string MainFrame::GetPythonOutput() {
 	PyErr_Print(); 
-	PyObject* output = PyObject_GetAttrString(catcher, "value"); 
-	return _PyUnicode_AsString(output);
+	PyRef output(PyObject_GetAttrString(catcher, "value"));
+	const char* Text = output ? PyUnicode_AsUTF8(output.Get()) : NULL;
+	if (!Text) {
+		PyErr_Clear();
+		return "";
+	}
+	return Text;
 }
 
 void MainFrame::PrintPythonOutput() {
@@ -2562,7 +3051,8 @@ void MainFrame::PrintPythonOutput() {
 }
 
 void MainFrame::ClearPythonOutput() {
-	PyObject_SetAttrString(catcher, "value", Py_BuildValue("s",""));
+	PyRef Empty(PyUnicode_FromString(""));
+	PyObject_SetAttrString(catcher, "value", Empty.Get());
 }
 
 int compare_int(int* a, int* b)
@@ -2587,21 +3077,20 @@ void MainFrame::OnRemoveClicked(wxCommandEvent& event) {
 		wxString XSelectedErr = XErrChoice->GetStringSelection();
 		wxString YSelected = YChoice->GetStringSelection();
 		wxString YSelectedErr = YErrChoice->GetStringSelection();
+		std::wstring Path = FilePicker->GetPath().ToStdWstring();
 		int Count = YList->GetCount();
 		wxString XItem;
 		wxString XItemErr;
 		wxString YItem;
 		wxString YItemErr;
 		for (int i = Count - 1; i >= 0; i--) {
+			if (DataEntries[i].Path != Path) { continue; } // Choices are columns of the picked file
 			XItem = XList->GetString(i);
 			XItemErr = XErrList->GetString(i);
-			YItem = YList->GetString(i);
+			YItem = DataEntries[i].YColumn;
 			YItemErr = YErrList->GetString(i);
 			if ((XSelected != "" && XItem == XSelected) && (YSelected != "" && YItem == YSelected)) {
-				XErrList->Delete(i);
-				XList->Delete(i);
-				YErrList->Delete(i);
-				YList->Delete(i);
+				DeleteDataEntry(i);
 			}
 			else {
 				if ((XSelected == "") && (XSelectedErr != "" && XItemErr == XSelectedErr)) {
@@ -2648,10 +3137,7 @@ void MainFrame::OnRemoveClicked(wxCommandEvent& event) {
 
 		for (int i = sxCount - 1; i >= 0; i--) {
 
-			XErrList->Delete(xSelections[i]);
-			XList->Delete(xSelections[i]);
-			YErrList->Delete(xSelections[i]);
-			YList->Delete(xSelections[i]);
+			DeleteDataEntry(xSelections[i]);
 		}
 	}
 
@@ -2659,233 +3145,6 @@ void MainFrame::OnRemoveClicked(wxCommandEvent& event) {
 
 }
 
-/*
-bool MainFrame::SettingsChanged(std::unordered_map<std::string, std::any> Settings1,
-	std::unordered_map<std::string, std::any> Settings2) {
-
-	bool SettingsChanged = false;
-	for (auto element : Settings1) {
-		if (element.second.type() == typeid(int)) {
-			if (std::any_cast<int>(element.second) != std::any_cast<int>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(long)) {
-			if (std::any_cast<long>(element.second) != std::any_cast<long>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(float)) {
-			if (std::any_cast<float>(element.second) != std::any_cast<float>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(double)) {
-			if (std::any_cast<double>(element.second) != std::any_cast<double>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(bool)) {
-			if (std::any_cast<bool>(element.second) != std::any_cast<bool>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(const char*)) {
-			if (std::any_cast<const char*>(element.second) 
-				!= std::any_cast<const char*>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(const wchar_t*)) {
-			if (std::any_cast<const wchar_t*>(element.second) 
-				!= std::any_cast<const wchar_t*>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::string)) {
-			if (std::any_cast<std::string>(element.second) 
-				!= std::any_cast<std::string>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::wstring)) {
-			if (std::any_cast<wstring>(element.second) 
-				!= std::any_cast<wstring>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-
-		else if (element.second.type() == typeid(std::vector<int>)) {
-			if (std::any_cast<std::vector<int>>(element.second) 
-				!= std::any_cast<std::vector<int>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<long>)) {
-			if (std::any_cast<std::vector<long>>(element.second) 
-				!= std::any_cast<std::vector<long>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<double>)) {
-			if (std::any_cast<std::vector<double>>(element.second) 
-				!= std::any_cast<std::vector<double>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<bool>)) {
-			if (std::any_cast<std::vector<bool>>(element.second) 
-				!= std::any_cast<std::vector<bool>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<const char*>)) {
-			if (std::any_cast<std::vector<const char*>>(element.second) 
-				!= std::any_cast<std::vector<const char*>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<std::string>)) {
-			if (std::any_cast<std::vector<std::string>>(element.second) 
-				!= std::any_cast<std::vector<std::string>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<std::wstring>)) {
-			if (std::any_cast<std::vector<std::wstring>>(element.second) 
-				!= std::any_cast<std::vector<std::wstring>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<std::tuple<double, double>>)) {
-			if (std::any_cast<std::vector<std::tuple<double, double>>>(element.second) 
-				!= std::any_cast<std::vector<std::tuple<double, double>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<std::tuple<std::string, std::string>>)) {
-			if (std::any_cast<std::vector<std::tuple<std::string, std::string>>>(element.second) 
-				!= std::any_cast<std::vector<std::tuple<std::string,
-				std::string>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<std::vector<double>>)) {
-			if (std::any_cast<std::vector<std::vector<double>>>(element.second) 
-				!= std::any_cast<std::vector<std::vector<double>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector <std::vector<std::tuple<double, double>>>)) {
-			if (std::any_cast<std::vector <std::vector<std::tuple<double, double>>>>(element.second)
-				!= std::any_cast<std::vector <std::vector<std::tuple<double,
-				double>>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::vector<std::vector<std::vector<double>>>)) {
-			if (std::any_cast<std::vector<std::vector<std::vector<double>>>>(element.second) 
-				!= std::any_cast<std::vector<std::vector<std::vector<double>>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::tuple<double, double>)) {
-			if (std::any_cast<std::tuple<double, double>>(element.second) 
-				!= std::any_cast<std::tuple<double, double>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::tuple<std::string, std::string>)) {
-			if (std::any_cast<std::tuple<std::string, std::string>>(element.second) 
-				!= std::any_cast<std::tuple<std::string, std::string>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::unordered_map<std::string, std::string>)) {
-			if (std::any_cast<std::unordered_map<std::string, std::string>>(element.second) 
-				!= std::any_cast<std::unordered_map<std::string, std::string>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::unordered_map<std::string, std::wstring>)) {
-			if (std::any_cast<std::unordered_map<std::string, std::wstring>>(element.second) 
-				!= std::any_cast<std::unordered_map<std::string, std::wstring>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::unordered_map<std::wstring, std::wstring>)) {
-			if (std::any_cast<std::unordered_map<std::wstring, std::wstring>>(element.second) 
-				!= std::any_cast<std::unordered_map<std::wstring, std::wstring>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::unordered_map<std::string,
-			std::vector<std::string>>)) {
-			if (std::any_cast<std::unordered_map<std::string,
-				std::vector<std::string>>>(element.second) 
-				!= std::any_cast<std::unordered_map<std::string,
-				std::vector<std::string>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::unordered_map<std::string,
-			std::vector<std::wstring>>)) {
-			if (std::any_cast<std::unordered_map<std::string,
-				std::vector<std::wstring>>>(element.second) != std::any_cast<std::unordered_map<std::string,
-				std::vector<std::wstring>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::unordered_map<std::wstring,
-			std::vector<std::wstring>>)) {
-			if (std::any_cast<std::unordered_map<std::wstring,
-				std::vector<std::wstring>>>(element.second) != std::any_cast<std::unordered_map<std::wstring,
-				std::vector<std::wstring>>>(Settings2[element.first])) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-		else if (element.second.type() == typeid(std::nullopt_t)) {
-			if (Settings2[element.first].type() != typeid(std::nullopt_t)) {
-				SettingsChanged = true;
-				break;
-			}
-		}
-	}
-
-	return SettingsChanged;
-}
-
-*/
-
 void MainFrame::OnPlotClicked(wxCommandEvent& event) {
 	
 	/*
@@ -2894,333 +3153,137 @@ void MainFrame::OnPlotClicked(wxCommandEvent& event) {
 	}
 	*/
 
-	// If plot window already exist close previous plot window:
-	HWND PlotWindow = FindWindowA(NULL, "Figure 1");
-	if (PlotWindow != NULL) {
-		PostMessage(PlotWindow, WM_CLOSE, 0, 0);
-		return;
-	}
-	CreatePlot();
+	// Parse the plotted columns on the loading thread, the plot is drawn on the Python thread then:
+	SettingsMap DataInfos = GetDataInfos();
+	LoadInBackground([this, DataInfos]() {
+		PyLock Lock;
+		PyRef PyDataInfos(SettingsToPy(DataInfos));
+		PyRef Data(PyDataInfos ? PyObject_CallFunctionObjArgs(PrepareData, PyDataInfos.Get(), NULL) : NULL);
+		if (!Data) {
+			ReportLoadError();
+			return false;
+		}
+		return true;
+	}, [this, DataInfos](bool Loaded) {
+		if (not Loaded) { return; }
+		ShowDataLimits(DataInfos);
+		CreatePlot();
+	});
 }
 
-void MainFrame::CreatePlot() {
-
-	ClearPythonOutput();
-
-	PyObject* PyDataInfos = ToPyObject(GetDataInfos());
-	PyObject* PyPlotSettings = ToPyObject(GetPlotSettings());
-	PyObject* PyFitFunctions = GetFitFunctions();
-	PyObject* PyFitSettings = ToPyObject(GetFitSettings());
-	PyObject* FitArgs = PyTuple_Pack(4, PyDataInfos, PyPlotSettings, PyFitFunctions, PyFitSettings);
-	PyObject* OutErr = PyObject_CallObject(CPlot, FitArgs);
-
-	//PyObject* args = PyTuple_Pack(4, PyDataInfos, PyPlotSettings, PyFitFunctions, PyFitSettings);
-	//PyObject* result = PyObject_CallObject(CPlot, args);
-	long cRes = PyLong_AsLong(OutErr);
-
-	OutputText->SetValue(GetPythonOutput());
-	PrintPythonOutput();
-
-	PyObject_CallObject(ShowPlot, NULL);
-
-	//Py_DECREF(CPlot);
-
-	if (cRes != 1) {
-		wxMessageBox(
-			"Something went wrong. \n"
-			"Possibly an error with latex coding in labels. \n"
-			"Try to change the axis or legend labels. \n"
-			"Also check if CSV seperator and decimal signs are correct.");
+// Show the range of the plotted columns as hints of the empty axis and fit limits, it is known
+// from the statistics collected while parsing:
+void MainFrame::ShowDataLimits(const SettingsMap& DataInfos) {
+	PyLock Lock;
+	PyRef PyDataInfos(SettingsToPy(DataInfos));
+	PyRef Limits(PyDataInfos ? PyObject_CallFunctionObjArgs(DataLimits, PyDataInfos.Get(), NULL) : NULL);
+	if (!Limits) {
+		PyErr_Clear();
 		return;
 	}
-}
 
-template <typename T>
-PyObject* VectorToPyList(const std::vector<T>& cpp_vec, PyObject* (*ConvertToPy)(const T&)) {
-	assert(cpython_asserts());
-	PyObject* r = PyList_New(cpp_vec.size());
-	if (!r) {
-		goto except;
-	}
-	for (std::size_t i = 0; i < cpp_vec.size(); ++i) {
-		PyObject* item = (*ConvertToPy)(cpp_vec[i]);
-		if (!item || PyErr_Occurred() || PyList_SetItem(r, i, item)) {
-			goto except;
-		}
+	std::vector<wxString> Hints;
+	for (Py_ssize_t i = 0; i < PyTuple_Size(Limits.Get()); i++) {
+		PyObject* Limit = PyTuple_GetItem(Limits.Get(), i);
+		Hints.push_back(Limit == Py_None ? wxString() : wxString::Format("%g", PyFloat_AsDouble(Limit)));
 	}
-	assert(!PyErr_Occurred());
-	assert(r);
-	goto finally;
-except:
-	assert(PyErr_Occurred());
-	// Clean up list
-	if (r) {
-		// No PyList_Clear().
-		for (Py_ssize_t i = 0; i < PyList_GET_SIZE(r); ++i) {
-			Py_XDECREF(PyList_GET_ITEM(r, i));
-		}
-		Py_DECREF(r);
-		r = NULL;
-	}
-	finally:
-	return r;
-}
-
-PyObject* IntToPy(const int& Val) {
-	return PyLong_FromLong(Val);
-}
-
-PyObject* LongToPy(const long& Val) {
-	return PyLong_FromLong(Val);
-}
-
-PyObject* DoubleToPy(const double& Val) {
-	return PyFloat_FromDouble(Val);
-}
-
-PyObject* StringToPy(const std::string& str) {
-	return PyUnicode_DecodeRawUnicodeEscape(str.c_str(), str.size(), "error");
-}
-
-PyObject* WStringToPy(const std::wstring& str) {
-	return PyUnicode_FromWideChar(str.c_str(), wcslen(str.c_str()));
-}
-
-PyObject* StringToPyByte(const std::string& str) {
-	return PyBytes_FromStringAndSize(str.c_str(), str.size());
-}
-
-PyObject* WCharToPy(const wchar_t* str) {
-	return PyUnicode_FromWideChar(str, wcslen(str));
-}
-
-PyObject* BoolToPy(const bool& Val) {
-	return PyBool_FromLong(Val);
-}
+	if (Hints.size() != 4) { return; }
 
-PyObject* SingleValToPy(const std::any& Val) {
-	PyObject* PyVal = Py_None;
-	if (Val.type() == typeid(int)) {
-		PyVal = PyLong_FromLong(std::any_cast<int>(Val));
-	}
-	else if (Val.type() == typeid(long)) {
-		PyVal = PyLong_FromLong(std::any_cast<long>(Val));
-	}
-	else if (Val.type() == typeid(double)) {
-		PyVal = PyFloat_FromDouble(std::any_cast<double>(Val));
-	}
-	else if (Val.type() == typeid(bool)) {
-		PyVal = PyBool_FromLong(std::any_cast<bool>(Val));
-	}
-	else if (Val.type() == typeid(std::string)) {
-		PyVal = StringToPy(std::any_cast<std::string>(Val));
-	}
-	else if (Val.type() == typeid(std::wstring)) {
-		PyVal = WStringToPy(std::any_cast<std::wstring>(Val));
-	}
-	else if (Val.type() == typeid(const char*)) {
-		PyVal = StringToPy(std::any_cast<const char*>(Val));
-	}
-	else if (Val.type() == typeid(const wchar_t*)) {
-		PyVal = WCharToPy(std::any_cast<const wchar_t*>(Val));
+	PlotXMin->SetAttribute(L"Hint", Hints[0]);
+	PlotXMax->SetAttribute(L"Hint", Hints[1]);
+	PlotYMin->SetAttribute(L"Hint", Hints[2]);
+	PlotYMax->SetAttribute(L"Hint", Hints[3]);
+	FitXMin->SetAttribute(L"Hint", Hints[0]);
+	FitXMax->SetAttribute(L"Hint", Hints[1]);
+	for (long i = 1; i <= FitCount->GetValue().GetLong(); i++) {
+		wxPGProperty* MinProp = FitSettingsGrid->GetProperty("Fit X-Minimum.Fit " + std::to_string(i));
+		wxPGProperty* MaxProp = FitSettingsGrid->GetProperty("Fit X-Maximum.Fit " + std::to_string(i));
+		if (MinProp) { MinProp->SetAttribute(L"Hint", Hints[0]); }
+		if (MaxProp) { MaxProp->SetAttribute(L"Hint", Hints[1]); }
 	}
-	return PyVal;
-}
-
-PyObject* TwoDoublesTupleToPy(const std::tuple<double, double>&Val) {
-	PyObject* PyTup = PyTuple_New(2);
-	PyObject* Double1 = PyFloat_FromDouble(std::get<0>(Val));
-	PyObject* Double2 = PyFloat_FromDouble(std::get<1>(Val));
-	PyTuple_SetItem(PyTup, 0, Double1);
-	PyTuple_SetItem(PyTup, 1, Double2);
-	return PyTup;
-}
-
-PyObject* TwoStringsTupleToPy(const std::tuple<std::string, std::string>& Val) {
-	PyObject* PyTup = PyTuple_New(2);
-	PyObject* Str1 = PyUnicode_FromString(std::get<0>(Val).c_str());
-	PyObject* Str2 = PyUnicode_FromString(std::get<1>(Val).c_str());
-	PyTuple_SetItem(PyTup, 0, Str1);
-	PyTuple_SetItem(PyTup, 1, Str2);
-	return PyTup;
-}
-
-PyObject* TwoAnysTupleToPy(const std::tuple<std::any, std::any>& Val) {
-	PyObject* PyTup = PyTuple_New(2);
-	PyObject* Val1 = SingleValToPy(std::get<0>(Val));
-	PyObject* Val2 = SingleValToPy(std::get<1>(Val));
-	PyTuple_SetItem(PyTup, 0, Val1);
-	PyTuple_SetItem(PyTup, 1, Val2);
-	return PyTup;
-}
-
-PyObject* VectorOfDoublesToPy(const std::vector<double>& Val) {
-	return VectorToPyList(Val, DoubleToPy);
-}
-
-PyObject* VectorOfVectorOfDoublesToPy(const std::vector<std::vector<double>>& Val) {
-	return VectorToPyList(Val, VectorOfDoublesToPy);
-}
-
-PyObject* VectorOfTwoDoublesTuplesToPy(const std::vector<std::tuple<double, double>>& Val) {
-	return VectorToPyList(Val, TwoDoublesTupleToPy);
-}
-
-PyObject* VectorOfStringsToPy(const std::vector<std::string>& Val) {
-	return VectorToPyList(Val, StringToPy);
-}
-
-PyObject* VectorOfWStringsToPy(const std::vector<std::wstring>& Val) {
-	return VectorToPyList(Val, WStringToPy);
+	PlotSettingsGrid->Refresh();
+	FitSettingsGrid->Refresh();
 }
 
-template <typename K, typename V>
-PyObject* MapToPyDict(const std::unordered_map<K, V>& cpp_map,
-	PyObject* (*KeyConvertToPy)(const K&), PyObject* (*ValConvertToPy)(const V&)) {
-	PyObject* key = NULL;
-	PyObject* val = NULL;
-	PyObject* r = PyDict_New();
+void MainFrame::CreatePlot() {
 
-	if (!r) {
-		goto except;
-	}
-	for (auto& iter : cpp_map) {
-		key = (*KeyConvertToPy)(iter.first);
-		if (!key || PyErr_Occurred()) {
-			goto except;
-		}
-		val = (*ValConvertToPy)(iter.second);
-		if (!val || PyErr_Occurred()) {
-			goto except;
+	// The settings are read from the widgets here, fitting and drawing runs on the Python thread
+	// and OnPlotDone gets the result:
+	SettingsMap DataInfos = GetDataInfos();
+	SettingsMap PlotSettings = GetPlotSettings();
+	SettingsMap FitSettings = GetFitSettings();
+	std::vector<std::string> FitFunctions = GetFitFunctionNames();
+	// Only the fits whose settings changed since the last plot are fitted again, the others are
+	// drawn with their last result. Changes of the fit line styles and the legend only restyle
+	// the open figure:
+	PlotState Next{ DataInfos, PlotSettings, FitSettings, FitFunctions };
+	PlotChanges Changes = ClassifyChanges(LastPlot, Next);
+	LastPlot = std::move(Next);
+	SettingValue Refits;
+	if (Changes.Update == PlotUpdate::Refit) { Refits = Changes.Refits; }
+	else if (Changes.Update != PlotUpdate::Full) { Refits = std::vector<long>(); }
+	bool Restyling = Changes.Update == PlotUpdate::Restyle;
+	Plotting = true;
+	PlotButton->Disable();
+
+	Plotter.Post([this, DataInfos, PlotSettings, FitSettings, FitFunctions, Refits, Restyling]() {
+		ClearPythonOutput();
+
+		PyRef PyDataInfos(SettingsToPy(DataInfos));
+		PyRef PyPlotSettings(SettingsToPy(PlotSettings));
+		PyRef PyFitFunctions(GetFitFunctions(FitFunctions));
+		PyRef PyFitSettings(SettingsToPy(FitSettings));
+		PyRef PyRefits(SettingToPy(Refits));
+		long cRes = 0;
+		bool Restyled = false;
+		if (PyDataInfos and PyPlotSettings and PyFitFunctions and PyFitSettings and PyRefits) {
+			if (Restyling) {
+				// False if the figure was closed since, it is drawn again with the last fit results then:
+				PyRef Result(PyObject_CallFunctionObjArgs(Restyle, PyDataInfos.Get(), PyPlotSettings.Get(),
+					PyFitSettings.Get(), NULL));
+				if (!Result) { PyErr_Print(); }
+				Restyled = Result and PyObject_IsTrue(Result.Get()) == 1;
+			}
+			if (Restyled) { cRes = 1; }
+			else {
+				PyRef FitArgs(PyTuple_Pack(5, PyDataInfos.Get(), PyPlotSettings.Get(), PyFitFunctions.Get(),
+					PyFitSettings.Get(), PyRefits.Get()));
+				PyRef OutErr(FitArgs ? PyObject_CallObject(CPlot, FitArgs.Get()) : NULL);
+				cRes = OutErr ? PyLong_AsLong(OutErr.Get()) : 0;
+			}
 		}
-		if (PyDict_SetItem(r, key, val)) {
-			goto except;
+		else {
+			// A setting could not be converted, print why instead of plotting without it:
+			PyErr_Print();
 		}
-	}
-	assert(!PyErr_Occurred());
-	assert(r);
-	goto finally;
-except:
-	assert(PyErr_Occurred());
-	// Clean up dict
-	if (r) {
-		PyDict_Clear(r);
-		Py_DECREF(r);
-	}
-	r = NULL;
-	finally:
-	return r;
-}
 
-PyObject* AnyExceptDicToPy(const std::any& Val) {
-	// Any except dictionary to Python object
+		wxThreadEvent* Done = new wxThreadEvent();
+		Done->SetString(GetPythonOutput());
+		Done->SetInt(cRes == 1);
+		Done->SetExtraLong(Restyled); // The fit output of the last plot stays valid
+		PrintPythonOutput();
+		wxQueueEvent(this, Done);
 
-	PyObject* PyVal = Py_None;
-	PyVal = SingleValToPy(Val);
-	if (PyVal == Py_None) {
-		if (Val.type() == typeid(std::vector<int>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<int>>(Val), &IntToPy);
-		}
-		else if (Val.type() == typeid(std::vector<double>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<double>>(Val), &DoubleToPy);
-		}
-		else if (Val.type() == typeid(std::vector<std::string>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<std::string>>(Val), &StringToPy);
-		}
-		else if (Val.type() == typeid(std::vector<std::wstring>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<std::wstring>>(Val), &WStringToPy);
-		}
-		else if (Val.type() == typeid(std::vector<bool>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<bool>>(Val), &BoolToPy);
-		}
-		else if (Val.type() == typeid(std::vector<std::tuple<double, double>>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<std::tuple<double, double>>>(Val),
-				&TwoDoublesTupleToPy);
-		}
-		else if (Val.type() == typeid(std::vector<std::tuple<std::any, std::any>>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<std::tuple<std::any, std::any>>>(Val),
-				&TwoAnysTupleToPy);
-		}
-		else if (Val.type() == typeid(std::vector<std::tuple<std::string, std::string>>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<std::tuple<std::string, std::string>>>(Val),
-				&TwoStringsTupleToPy);
-		}
-		else if (Val.type() == typeid(std::vector<std::vector<double>>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<std::vector<double>>>(Val),
-				&VectorOfDoublesToPy);
-		}
-		else if (Val.type() == typeid(std::vector <std::vector<std::tuple<double, double>>>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector <std::vector<std::tuple<double, double>>>>(Val),
-				&VectorOfTwoDoublesTuplesToPy);
-		}
-		else if (Val.type() == typeid(std::vector<std::vector<std::vector<double>>>)) {
-			PyVal = VectorToPyList(std::any_cast<std::vector<std::vector<std::vector<double>>>>(Val),
-				&VectorOfVectorOfDoublesToPy);
-		}
-		else if (Val.type() == typeid(std::tuple<double, double>)) {
-			PyVal = TwoDoublesTupleToPy(std::any_cast<std::tuple<double, double>>(Val));
-		}
-		else if (Val.type() == typeid(std::tuple<std::string, std::string>)) {
-			PyVal = TwoStringsTupleToPy(std::any_cast<std::tuple<std::string, std::string>>(Val));
-		}
-		else if (Val.type() == typeid(std::tuple<std::any, std::any>)) {
-			PyVal = TwoAnysTupleToPy(std::any_cast<std::tuple<std::any, std::any>>(Val));
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::string, std::string>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::string, std::string>>(Val),
-				&StringToPy, &StringToPy);
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::string, std::wstring>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::string, std::wstring>>(Val),
-				&StringToPy, &WStringToPy);
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::wstring, std::string>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::wstring, std::string>>(Val),
-				&WStringToPy, &StringToPy);
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::wstring, std::wstring>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::wstring, std::wstring>>(Val),
-				&WStringToPy, &WStringToPy);
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::string, std::vector<std::string>>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::string, std::vector<std::string>>>(Val),
-				&StringToPy, &VectorOfStringsToPy);
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::string, std::vector<std::wstring>>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::string, std::vector<std::wstring>>>(Val),
-				&StringToPy, &VectorOfWStringsToPy);
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::wstring, std::vector<std::string>>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::wstring, std::vector<std::string>>>(Val),
-				&WStringToPy, &VectorOfStringsToPy);
-		}
-		else if (Val.type() == typeid(std::unordered_map<std::wstring, std::vector<std::wstring>>)) {
-			PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::wstring, std::vector<std::wstring>>>(Val),
-				&WStringToPy, &VectorOfWStringsToPy);
-		}
-		else if (Val.type() == typeid(std::nullopt_t)) {
-			PyVal = Py_None;
-		}
-	}
-	return PyVal;
+		// Returns at once, the figure stays open while the next jobs run:
+		PyRef Shown(PyObject_CallObject(ShowPlot, NULL));
+		if (!Shown) { PyErr_Print(); }
+	});
 }
 
-PyObject* MainFrame::ToPyObject(std::any Val) {
+void MainFrame::OnPlotDone(wxThreadEvent& event) {
+	Plotting = false;
+	if (not event.GetExtraLong()) { OutputText->SetValue(event.GetString()); }
+	if (ListsCreated and not Loader.joinable()) { PlotButton->Enable(); }
 
-	PyObject* PyVal;
-	if (Val.type() == typeid(std::unordered_map<std::string, std::any>)) {
-		PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::string, std::any>>(Val),
-			&StringToPy, &AnyExceptDicToPy);
-	}
-	else if (Val.type() == typeid(std::unordered_map<std::wstring, std::any>)) {
-		PyVal = MapToPyDict(std::any_cast<std::unordered_map<std::wstring, std::any>>(Val),
-			&WStringToPy, &AnyExceptDicToPy);
-	}
-	else {
-		PyVal = AnyExceptDicToPy(Val);
+	if (not event.GetInt()) {
+		// The fits of the failed plot may be missing, the next plot fits everything again:
+		LastPlot.DataInfos.clear();
+		wxMessageBox(
+			"Something went wrong. \n"
+			"Possibly an error with latex coding in labels. \n"
+			"Try to change the axis or legend labels. \n"
+			"Also check if CSV seperator and decimal signs are correct.");
 	}
-
-	return PyVal;
 }
 
 std::string GetPlotAreaString(std::string Val) {
@@ -3252,8 +3315,8 @@ std::string GetMarkerStyle(std::string Val) {
 	return Marker;
 }
 
-std::unordered_map<std::string, std::any> MainFrame::GetDataInfos() {
-	std::unordered_map<std::string, std::any> DataInfos;
+SettingsMap MainFrame::GetDataInfos() {
+	SettingsMap DataInfos;
 	std::wstring Path = FilePicker->GetPath().ToStdWstring();
 	DataInfos["Path"] = Path;
 
@@ -3265,27 +3328,38 @@ std::unordered_map<std::string, std::any> MainFrame::GetDataInfos() {
 	for (unsigned int i = 0; i < XErrList->GetCount(); i++) {
 		xErrorColumns.push_back(XErrList->GetString(i).ToStdWstring());
 	}
-	std::vector<std::wstring> yColumns;
-	for (unsigned int i = 0; i < YList->GetCount(); i++) {
-		yColumns.push_back(YList->GetString(i).ToStdWstring());
-	}
 	std::vector<std::wstring> yErrorColumns;
 	for (unsigned int i = 0; i < YErrList->GetCount(); i++) {
 		yErrorColumns.push_back(YErrList->GetString(i).ToStdWstring());
 	}
+
+	// y list shows labels, the column names and data files are kept with the entries:
+	std::vector<std::wstring> yColumns;
+	std::vector<std::wstring> Paths;
+	std::vector<std::string> Seperators;
+	std::vector<std::string> Decimals;
+	for (const DataEntry& Entry : DataEntries) {
+		yColumns.push_back(Entry.YColumn);
+		Paths.push_back(Entry.Path);
+		Seperators.push_back(Entry.Seperator);
+		Decimals.push_back(Entry.Decimal);
+	}
 	DataInfos["xColumns"] = xColumns;
 	DataInfos["yColumns"] = yColumns;
 	DataInfos["xErrorColumns"] = xErrorColumns;
 	DataInfos["yErrorColumns"] = yErrorColumns;
-	DataInfos["Seperator"] = CSVSettings["Seperator"];
-	DataInfos["Decimal"] = CSVSettings["Decimal"];
+	DataInfos["Seperator"] = DataSeperator;
+	DataInfos["Decimal"] = DataDecimal;
+	DataInfos["Paths"] = Paths;
+	DataInfos["Seperators"] = Seperators;
+	DataInfos["Decimals"] = Decimals;
 
 	return DataInfos;
 }
 
-std::unordered_map<std::string, std::any> MainFrame::GetPlotSettings() {
+SettingsMap MainFrame::GetPlotSettings() {
 
-	std::unordered_map<std::string, std::any> PlotSettings;
+	SettingsMap PlotSettings;
 
 	std::vector <std::vector<std::tuple<double, double>>> Zooms;
 	for (unsigned int i = 1; i <= ZoomXMin->GetChildCount(); i++) {
@@ -3420,32 +3494,32 @@ std::unordered_map<std::string, std::any> MainFrame::GetPlotSettings() {
 	}
 
 	if (not MarkerColors.empty()) { PlotSettings["mColors"] = MarkerColors; }
-	else { PlotSettings["mColors"] = std::nullopt; }
+	else { PlotSettings["mColors"] = std::monostate(); }
 	if (not MarkerSizes.empty()) { PlotSettings["mSizes"] = MarkerSizes; }
-	else { PlotSettings["mSizes"] = std::nullopt; }
+	else { PlotSettings["mSizes"] = std::monostate(); }
 	if (not MarkerStyles.empty()) { PlotSettings["mStyles"] = MarkerStyles; }
-	else { PlotSettings["mStyles"] = std::nullopt; }
+	else { PlotSettings["mStyles"] = std::monostate(); }
 	if (not MarkerOrders.empty()) { PlotSettings["mOrders"] = MarkerOrders; }
-	else { PlotSettings["mOrders"] = std::nullopt; }
+	else { PlotSettings["mOrders"] = std::monostate(); }
 	if (not MarkerAlphas.empty()) { PlotSettings["mAlphas"] = MarkerAlphas; }
-	else { PlotSettings["mAlphas"] = std::nullopt; }
+	else { PlotSettings["mAlphas"] = std::monostate(); }
 	if (not MarkerConnects.empty()) { PlotSettings["mConnects"] = MarkerConnects; }
-	else { PlotSettings["mConnects"] = std::nullopt; }
+	else { PlotSettings["mConnects"] = std::monostate(); }
 	if (not ErrorWidths.empty()) { PlotSettings["ErrWidths"] = ErrorWidths; }
-	else { PlotSettings["ErrWidths"] = std::nullopt; }
+	else { PlotSettings["ErrWidths"] = std::monostate(); }
 	if (not ErrorCapsizes.empty()) { PlotSettings["ErrCapsizes"] = ErrorCapsizes; }
-	else { PlotSettings["ErrCapsizes"] = std::nullopt; }
+	else { PlotSettings["ErrCapsizes"] = std::monostate(); }
 
-	if (PlotXLabel->IsValueUnspecified()) { PlotSettings["LabelX"] = std::nullopt; }
+	if (PlotXLabel->IsValueUnspecified()) { PlotSettings["LabelX"] = std::monostate(); }
 	else { PlotSettings["LabelX"] = PlotXLabel->GetValueAsString().ToStdWstring(); }
-	if (PlotXLabel->IsValueUnspecified()) { PlotSettings["LabelY"] = std::nullopt; }
+	if (PlotXLabel->IsValueUnspecified()) { PlotSettings["LabelY"] = std::monostate(); }
 	else { PlotSettings["LabelY"] = PlotYLabel->GetValueAsString().ToStdWstring(); }
 
-	if (PlotLabelsize->IsValueUnspecified()) { PlotSettings["LabelSize"] = std::nullopt; }
+	if (PlotLabelsize->IsValueUnspecified()) { PlotSettings["LabelSize"] = std::monostate(); }
 	else { PlotSettings["LabelSize"] = PlotLabelsize->GetValue().GetDouble(); }
 
 	if (PlotXMin->IsValueUnspecified() or PlotXMax->IsValueUnspecified()) {
-		PlotSettings["xLimit"] = std::nullopt;
+		PlotSettings["xLimit"] = std::monostate();
 	}
 	else {
 		PlotSettings["xLimit"] = std::make_tuple<double, double>(PlotXMin->GetValue().GetDouble(),
@@ -3453,17 +3527,17 @@ std::unordered_map<std::string, std::any> MainFrame::GetPlotSettings() {
 	}
 
 	if (PlotYMin->IsValueUnspecified() or PlotYMax->IsValueUnspecified()) {
-		PlotSettings["yLimit"] = std::nullopt;
+		PlotSettings["yLimit"] = std::monostate();
 	}
 	else {
 		PlotSettings["yLimit"] = std::make_tuple<double, double>(PlotYMin->GetValue().GetDouble(),
 			PlotYMax->GetValue().GetDouble());
 	}
 
-	if (PlotWidth->IsValueUnspecified()) { PlotSettings["FigWidth"] = std::nullopt; }
+	if (PlotWidth->IsValueUnspecified()) { PlotSettings["FigWidth"] = std::monostate(); }
 	else { PlotSettings["FigWidth"] = PlotWidth->GetValue().GetDouble(); }
 
-	if (PlotHeight->IsValueUnspecified()) { PlotSettings["FigHeight"] = std::nullopt; }
+	if (PlotHeight->IsValueUnspecified()) { PlotSettings["FigHeight"] = std::monostate(); }
 	else { PlotSettings["FigHeight"] = PlotHeight->GetValue().GetDouble(); }
 
 	if (ZoomHelpLines->IsValueUnspecified()) { PlotSettings["ZoomHelpLines"] = true; }
@@ -3472,25 +3546,31 @@ std::unordered_map<std::string, std::any> MainFrame::GetPlotSettings() {
 	if (PlotProjection->IsValueUnspecified()) { PlotSettings["Projection"] = false; }
 	else { PlotSettings["Projection"] = PlotProjection->GetValue().GetBool(); }
 
-	if (PlotLegendRelX->IsValueUnspecified()) { PlotSettings["LegendRelX"] = std::nullopt; }
+	if (PlotLiveUpdate->IsValueUnspecified()) { PlotSettings["LiveUpdate"] = false; }
+	else { PlotSettings["LiveUpdate"] = PlotLiveUpdate->GetValue().GetBool(); }
+
+	if (PlotSinglePrecision->IsValueUnspecified()) { PlotSettings["SinglePrecision"] = false; }
+	else { PlotSettings["SinglePrecision"] = PlotSinglePrecision->GetValue().GetBool(); }
+
+	if (PlotLegendRelX->IsValueUnspecified()) { PlotSettings["LegendRelX"] = std::monostate(); }
 	else { PlotSettings["LegendRelX"] = PlotLegendRelX->GetValue().GetDouble(); }
 
-	if (PlotLegendRelY->IsValueUnspecified()) { PlotSettings["LegendRelY"] = std::nullopt; }
+	if (PlotLegendRelY->IsValueUnspecified()) { PlotSettings["LegendRelY"] = std::monostate(); }
 	else { PlotSettings["LegendRelY"] = PlotLegendRelY->GetValue().GetDouble(); }
 
-	if (PlotLegendFontsize->IsValueUnspecified()) { PlotSettings["LegendFontsize"] = std::nullopt; }
+	if (PlotLegendFontsize->IsValueUnspecified()) { PlotSettings["LegendFontsize"] = std::monostate(); }
 	else { PlotSettings["LegendFontsize"] = PlotLegendFontsize->GetValue().GetDouble(); }
 
-	if (PlotLegendHandlelength->IsValueUnspecified()) { PlotSettings["LegendHandlelength"] = std::nullopt; }
+	if (PlotLegendHandlelength->IsValueUnspecified()) { PlotSettings["LegendHandlelength"] = std::monostate(); }
 	else { PlotSettings["LegendHandlelength"] = PlotLegendHandlelength->GetValue().GetDouble(); }
 
-	if (PlotLegendMarkerscale->IsValueUnspecified()) { PlotSettings["LegendMarkerscale"] = std::nullopt; }
+	if (PlotLegendMarkerscale->IsValueUnspecified()) { PlotSettings["LegendMarkerscale"] = std::monostate(); }
 	else { PlotSettings["LegendMarkerscale"] = PlotLegendMarkerscale->GetValue().GetDouble(); }
 
-	if (PlotLogScaleX->IsValueUnspecified()) { PlotSettings["LogScaleX"] = std::nullopt; }
+	if (PlotLogScaleX->IsValueUnspecified()) { PlotSettings["LogScaleX"] = std::monostate(); }
 	else { PlotSettings["LogScaleX"] = PlotLogScaleX->GetValue().GetBool(); }
 
-	if (PlotLogScaleY->IsValueUnspecified()) { PlotSettings["LogScaleY"] = std::nullopt; }
+	if (PlotLogScaleY->IsValueUnspecified()) { PlotSettings["LogScaleY"] = std::monostate(); }
 	else { PlotSettings["LogScaleY"] = PlotLogScaleY->GetValue().GetBool(); }
 
 	if (PlotLogBaseX->IsValueUnspecified()) { PlotSettings["LogScaleBaseX"] = std::exp(1); }
@@ -3499,58 +3579,58 @@ std::unordered_map<std::string, std::any> MainFrame::GetPlotSettings() {
 	if (PlotLogBaseY->IsValueUnspecified()) { PlotSettings["LogScaleBaseY"] = std::exp(1); }
 	else { PlotSettings["LogScaleBaseY"] = PlotLogBaseY->GetValue().GetDouble(); }
 
-	if (PlotXSci->IsValueUnspecified()) { PlotSettings["SciStyleX"] = std::nullopt; }
+	if (PlotXSci->IsValueUnspecified()) { PlotSettings["SciStyleX"] = std::monostate(); }
 	else { PlotSettings["SciStyleX"] = PlotXSci->GetValue().GetBool(); }
 
-	if (PlotYSci->IsValueUnspecified()) { PlotSettings["SciStyleY"] = std::nullopt; }
+	if (PlotYSci->IsValueUnspecified()) { PlotSettings["SciStyleY"] = std::monostate(); }
 	else { PlotSettings["SciStyleY"] = PlotYSci->GetValue().GetBool(); }
 
-	if (ZoomXSci->IsValueUnspecified()) { PlotSettings["SciStyleXZoom"] = std::nullopt; }
+	if (ZoomXSci->IsValueUnspecified()) { PlotSettings["SciStyleXZoom"] = std::monostate(); }
 	else { PlotSettings["SciStyleXZoom"] = ZoomXSci->GetValue().GetBool(); }
 
-	if (ZoomYSci->IsValueUnspecified()) { PlotSettings["SciStyleYZoom"] = std::nullopt; }
+	if (ZoomYSci->IsValueUnspecified()) { PlotSettings["SciStyleYZoom"] = std::monostate(); }
 	else { PlotSettings["SciStyleYZoom"] = ZoomYSci->GetValue().GetBool(); }
 
-	if (PlotTickLabelsize->IsValueUnspecified()) { PlotSettings["TickLabelSize"] = std::nullopt; }
+	if (PlotTickLabelsize->IsValueUnspecified()) { PlotSettings["TickLabelSize"] = std::monostate(); }
 	else { PlotSettings["TickLabelSize"] = PlotTickLabelsize->GetValue().GetDouble(); }
 
-	if (PlotTickDirection->IsValueUnspecified()) { PlotSettings["TickDirection"] = std::nullopt; }
-	else { PlotSettings["TickDirection"] = PlotTickDirection->GetValueAsString(); }
+	if (PlotTickDirection->IsValueUnspecified()) { PlotSettings["TickDirection"] = std::monostate(); }
+	else { PlotSettings["TickDirection"] = PlotTickDirection->GetValueAsString().ToStdString(); }
 
-	if (PlotMajorTickLength->IsValueUnspecified()) { PlotSettings["MajorTickLength"] = std::nullopt; }
+	if (PlotMajorTickLength->IsValueUnspecified()) { PlotSettings["MajorTickLength"] = std::monostate(); }
 	else { PlotSettings["MajorTickLength"] = PlotMajorTickLength->GetValue().GetDouble(); }
 
-	if (PlotMajorTickWidth->IsValueUnspecified()) { PlotSettings["MajorTickWidth"] = std::nullopt; }
+	if (PlotMajorTickWidth->IsValueUnspecified()) { PlotSettings["MajorTickWidth"] = std::monostate(); }
 	else { PlotSettings["MajorTickWidth"] = PlotMajorTickWidth->GetValue().GetDouble(); }
 
-	if (PlotMajorTicksPeriodX->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodX"] = std::nullopt; }
+	if (PlotMajorTicksPeriodX->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodX"] = std::monostate(); }
 	else { PlotSettings["MajorTicksPeriodX"] = PlotMajorTicksPeriodX->GetValue().GetDouble(); }
 
-	if (PlotMajorTicksPeriodY->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodY"] = std::nullopt; }
+	if (PlotMajorTicksPeriodY->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodY"] = std::monostate(); }
 	else { PlotSettings["MajorTicksPeriodY"] = PlotMajorTicksPeriodY->GetValue().GetDouble(); }
 
-	if (ZoomXPeriod->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodXZoom"] = std::nullopt; }
+	if (ZoomXPeriod->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodXZoom"] = std::monostate(); }
 	else { PlotSettings["MajorTicksPeriodXZoom"] = ZoomXPeriod->GetValue().GetDouble(); }
 
-	if (ZoomYPeriod->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodYZoom"] = std::nullopt; }
+	if (ZoomYPeriod->IsValueUnspecified()) { PlotSettings["MajorTicksPeriodYZoom"] = std::monostate(); }
 	else { PlotSettings["MajorTicksPeriodYZoom"] = ZoomYPeriod->GetValue().GetDouble(); }
 
-	if (PlotMinorTicksX->IsValueUnspecified()) { PlotSettings["MinorTicksX"] = std::nullopt; }
+	if (PlotMinorTicksX->IsValueUnspecified()) { PlotSettings["MinorTicksX"] = std::monostate(); }
 	else { PlotSettings["MinorTicksX"] = PlotMinorTicksX->GetValue().GetBool(); }
 
-	if (PlotMinorTicksY->IsValueUnspecified()) { PlotSettings["MinorTicksY"] = std::nullopt; }
+	if (PlotMinorTicksY->IsValueUnspecified()) { PlotSettings["MinorTicksY"] = std::monostate(); }
 	else { PlotSettings["MinorTicksY"] = PlotMinorTicksY->GetValue().GetBool(); }
 
-	if (PlotMinorTicksPeriodX->IsValueUnspecified()) { PlotSettings["MinorTicksPeriodX"] = std::nullopt; }
+	if (PlotMinorTicksPeriodX->IsValueUnspecified()) { PlotSettings["MinorTicksPeriodX"] = std::monostate(); }
 	else { PlotSettings["MinorTicksPeriodX"] = PlotMinorTicksPeriodX->GetValue().GetDouble(); }
 
-	if (PlotMinorTicksPeriodY->IsValueUnspecified()) { PlotSettings["MinorTicksPeriodY"] = std::nullopt; }
+	if (PlotMinorTicksPeriodY->IsValueUnspecified()) { PlotSettings["MinorTicksPeriodY"] = std::monostate(); }
 	else { PlotSettings["MinorTicksPeriodY"] = PlotMinorTicksPeriodY->GetValue().GetDouble(); }
 
-	if (PlotMinorTickLength->IsValueUnspecified()) { PlotSettings["MinorTickLength"] = std::nullopt; }
+	if (PlotMinorTickLength->IsValueUnspecified()) { PlotSettings["MinorTickLength"] = std::monostate(); }
 	else { PlotSettings["MinorTickLength"] = PlotMinorTickLength->GetValue().GetDouble(); }
 
-	if (PlotMinorTickWidth->IsValueUnspecified()) { PlotSettings["MinorTickWidth"] = std::nullopt; }
+	if (PlotMinorTickWidth->IsValueUnspecified()) { PlotSettings["MinorTickWidth"] = std::monostate(); }
 	else { PlotSettings["MinorTickWidth"] = PlotMinorTickWidth->GetValue().GetDouble(); }
 
 	std::vector<double> EmptyVec = {};
@@ -3562,33 +3642,42 @@ std::unordered_map<std::string, std::any> MainFrame::GetPlotSettings() {
 	return PlotSettings;
 }
 
-PyObject* MainFrame::GetFitFunctions() {
+// One name if all fits use the same function, else the function of every fit:
+std::vector<std::string> MainFrame::GetFitFunctionNames() {
+	std::vector<std::string> Names;
 	long NumberOfFits = FitCount->GetValue().GetLong();
-	PyObject* PyFitFunctions = PyList_New(NumberOfFits);
 	for (long i = 0; i < NumberOfFits; i++) {
 		wxPGProperty* FuncProp = FitSettingsGrid->GetProperty("Fitfunction.Fit " + std::to_string(i + 1));
-		if (NumberOfFits == 1 or not FitFuncs->IsValueUnspecified()) { FuncProp = FitFuncs; }
-		std::string FitFunc = FuncProp->GetValueAsString().ToStdString();
-		PyObject* PyFitFunction = PyObject_GetAttrString(fitfunctions_module, FitFunc.c_str());
-		if (NumberOfFits == 1 or not FitFuncs->IsValueUnspecified()) { 
-			return PyFitFunction; 
+		if (NumberOfFits == 1 or not FitFuncs->IsValueUnspecified()) {
+			return { FitFuncs->GetValueAsString().ToStdString() };
 		}
-		PyList_SetItem(PyFitFunctions, i, PyFitFunction);
-		//Py_DECREF(PyFitFunction);
+		Names.push_back(FuncProp->GetValueAsString().ToStdString());
 	}
+	return Names;
+}
 
-	return PyFitFunctions;
+PyObject* MainFrame::GetFitFunctions(const std::vector<std::string>& Names) {
+	if (Names.size() == 1) { return PyObject_GetAttrString(fitfunctions_module, Names[0].c_str()); }
+	PyRef PyFitFunctions(PyList_New(Names.size()));
+	if (!PyFitFunctions) { return NULL; }
+	for (std::size_t i = 0; i < Names.size(); i++) {
+		PyObject* PyFitFunction = PyObject_GetAttrString(fitfunctions_module, Names[i].c_str());
+		if (!PyFitFunction) { return NULL; }
+		PyList_SET_ITEM(PyFitFunctions.Get(), i, PyFitFunction);
+	}
+
+	return PyFitFunctions.Release();
 }
 
-std::unordered_map<std::string, std::any> MainFrame::GetFitSettings() {
-	std::unordered_map<std::string, std::any> FitSettings;
+SettingsMap MainFrame::GetFitSettings() {
+	SettingsMap FitSettings;
 
 	FitSettings["LatexFuncs"] = LatexFuncs;
 	FitSettings["LatexParams"] = LatexParams;
 
 	std::vector<std::vector<double>> sParamsVecVec;
 	std::vector<long> DataNos;
-	std::vector<std::tuple<std::any, std::any>> AreaVec;
+	std::vector<std::tuple<std::optional<double>, std::optional<double>>> AreaVec;
 	std::vector<std::string> FitColors;
 	std::vector<std::string> FitNames;
 	std::vector<std::tuple<double, double>> ExAreaVec;
@@ -3648,21 +3737,11 @@ std::unordered_map<std::string, std::any> MainFrame::GetFitSettings() {
 		if (not FitXMax->IsValueUnspecified()) { MaxProp = FitXMax; }
 
 		if (MinProp and MaxProp) {
-			if (MinProp->IsValueUnspecified() and not MaxProp->IsValueUnspecified()) {
-				AreaVec.push_back(std::make_tuple<std::any, std::any>(std::nullopt,
-					MaxProp->GetValue().GetDouble()));
-			}
-			else if (not MinProp->IsValueUnspecified() and MaxProp->IsValueUnspecified()) {
-				AreaVec.push_back(std::make_tuple<std::any, std::any>(MinProp->GetValue().GetDouble(),
-					std::nullopt));
-			}
-			else if (not MinProp->IsValueUnspecified() and not MaxProp->IsValueUnspecified()) {
-				AreaVec.push_back(std::make_tuple<std::any, std::any>(MinProp->GetValue().GetDouble(),
-					MaxProp->GetValue().GetDouble()));
-			}
-			else if (MinProp->IsValueUnspecified() and MaxProp->IsValueUnspecified()) {
-				AreaVec.push_back(std::make_tuple<std::any, std::any>(std::nullopt, std::nullopt));
-			}
+			std::optional<double> Min;
+			std::optional<double> Max;
+			if (not MinProp->IsValueUnspecified()) { Min = MinProp->GetValue().GetDouble(); }
+			if (not MaxProp->IsValueUnspecified()) { Max = MaxProp->GetValue().GetDouble(); }
+			AreaVec.push_back(std::make_tuple(Min, Max));
 		}
 
 		if (not FitColor->IsValueUnspecified()) {
@@ -3896,34 +3975,34 @@ std::unordered_map<std::string, std::any> MainFrame::GetFitSettings() {
 	FitSettings["NumFits"] = NumberOfFits;
 
 	if (not sParamsVecVec.empty()) { FitSettings["sParams"] = sParamsVecVec; }
-	else { FitSettings["sParams"] = std::nullopt; }
+	else { FitSettings["sParams"] = std::monostate(); }
 
 	if (not DataNos.empty()) { FitSettings["DataNo"] = DataNos; }
-	else if (FitData->IsValueUnspecified()) { FitSettings["DataNo"] = std::nullopt; }
+	else if (FitData->IsValueUnspecified()) { FitSettings["DataNo"] = std::monostate(); }
 
 	if (not AreaVec.empty()) { FitSettings["Area"] = AreaVec; }
-	else { FitSettings["Area"] = std::nullopt; }
+	else { FitSettings["Area"] = std::monostate(); }
 
 	if (not FitColors.empty()) { FitSettings["Color"] = FitColors; }
-	else if (FitColor->IsValueUnspecified()) { FitSettings["Color"] = std::nullopt; }
+	else if (FitColor->IsValueUnspecified()) { FitSettings["Color"] = std::monostate(); }
 
 	if (not FitNames.empty()) { FitSettings["Name"] = FitNames; }
-	else if (FitName->IsValueUnspecified()) { FitSettings["Name"] = std::nullopt; }
+	else if (FitName->IsValueUnspecified()) { FitSettings["Name"] = std::monostate(); }
 
 	if (not ExAreaVec.empty()) { FitSettings["ExArea"] = ExAreaVec; }
-	else { FitSettings["ExArea"] = std::nullopt; }
+	else { FitSettings["ExArea"] = std::monostate(); }
 
 	if (not FitNames.empty()) { FitSettings["Name"] = FitNames; }
-	else if (FitName->IsValueUnspecified()) { FitSettings["Name"] = std::nullopt; }
+	else if (FitName->IsValueUnspecified()) { FitSettings["Name"] = std::monostate(); }
 
 	if (not pAreas.empty()) { FitSettings["pArea"] = pAreas; }
-	else { FitSettings["pArea"] = std::nullopt; }
+	else { FitSettings["pArea"] = std::monostate(); }
 	
 	if (not FitLines.empty()) { FitSettings["Line"] = FitLines; }
-	else if (FitLine->IsValueUnspecified()) { FitSettings["Line"] = std::nullopt; }
+	else if (FitLine->IsValueUnspecified()) { FitSettings["Line"] = std::monostate(); }
 
 	if (not PResVec.empty()) { FitSettings["pRes"] = PResVec; }
-	else if (FitPRes->IsValueUnspecified()) { FitSettings["pRes"] = std::nullopt; }
+	else if (FitPRes->IsValueUnspecified()) { FitSettings["pRes"] = std::monostate(); }
 
 	if (not FitBoundsVecVecVec.empty()) {
 		for (size_t i = 0; i < FitBoundsVecVecVec.size(); i++) {
@@ -3932,40 +4011,40 @@ std::unordered_map<std::string, std::any> MainFrame::GetFitSettings() {
 		FitSettings["Bounds"] = FitBoundsVecVecVec;
 	}
 	else { 
-		FitSettings["Bounds"] = std::nullopt; 
+		FitSettings["Bounds"] = std::monostate(); 
 	}
 
 	if (not FitMethods.empty()) {
 		FitSettings["Method"] = FitMethods; 
 	}
 	else if (FitMethod->IsValueUnspecified()) { 
-		FitSettings["Method"] = std::nullopt; 
+		FitSettings["Method"] = std::monostate(); 
 	}
 
 	if (not FitLogFits.empty()) { FitSettings["LogFit"] = FitLogFits; }
-	else if (FitLogFit->IsValueUnspecified()) { FitSettings["LogFit"] = std::nullopt; }
+	else if (FitLogFit->IsValueUnspecified()) { FitSettings["LogFit"] = std::monostate(); }
 
 	if (not FitLogBases.empty()) { FitSettings["LogBase"] = FitLogBases; }
-	else if (FitLogBase->IsValueUnspecified()) { FitSettings["LogBase"] = std::nullopt; }
+	else if (FitLogBase->IsValueUnspecified()) { FitSettings["LogBase"] = std::monostate(); }
 
 	if (not LossVec.empty()) { FitSettings["Loss"] = LossVec; }
-	else if (FitLoss->IsValueUnspecified()) { FitSettings["Loss"] = std::nullopt; }
+	else if (FitLoss->IsValueUnspecified()) { FitSettings["Loss"] = std::monostate(); }
 
 	if (not LossScaleVec.empty()) { FitSettings["LossScale"] = LossScaleVec; }
-	else if (FitLossScale->IsValueUnspecified()) { FitSettings["LossScale"] = std::nullopt; }
+	else if (FitLossScale->IsValueUnspecified()) { FitSettings["LossScale"] = std::monostate(); }
 
 	if (not FitLinewidths.empty()) { FitSettings["FitLinewidth"] = FitLinewidths; }
-	else if (FitLinewidth->IsValueUnspecified()) { FitSettings["FitLinewidth"] = std::nullopt; }
+	else if (FitLinewidth->IsValueUnspecified()) { FitSettings["FitLinewidth"] = std::monostate(); }
 
 	if (not FitOrders.empty()) { FitSettings["FitOrder"] = FitOrders; }
-	else if (FitOrder->IsValueUnspecified()) { FitSettings["FitOrder"] = std::nullopt; }
+	else if (FitOrder->IsValueUnspecified()) { FitSettings["FitOrder"] = std::monostate(); }
 
 	if (not FitOrdersZooms.empty()) { FitSettings["FitOrdersZoom"] = FitOrdersZooms; }
-	else if (FitOrdersZoom->IsValueUnspecified()) { FitSettings["FitOrdersZoom"] = std::nullopt; }
+	else if (FitOrdersZoom->IsValueUnspecified()) { FitSettings["FitOrdersZoom"] = std::monostate(); }
 
-	FitSettings["ExEr"] = std::nullopt;
-	FitSettings["odrType"] = std::nullopt;
-	FitSettings["CV"] = std::nullopt;
+	FitSettings["ExEr"] = std::monostate();
+	FitSettings["odrType"] = std::monostate();
+	FitSettings["CV"] = std::monostate();
 
 	return FitSettings;
 }
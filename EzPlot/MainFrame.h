@@ -5,18 +5,34 @@
 #include <wx/sizer.h>
 #include <wx/propgrid/propgrid.h>
 #include <wx/activityindicator.h>
+#include <wx/spinctrl.h>
+#include <wx/timer.h>
+#include <wx/grid.h>
 #include <Python.h>
 #include <vector>
 #include <string>
 #include <map>
-#include <any>
 #include <tuple>
 #include <optional>
+#include <thread>
+#include <functional>
+#include "SettingValue.h"
+#include "PlotChanges.h"
+#include "PythonExecutor.h"
+
+// Data file of an entry of the data lists, the entries of a project may come from several files:
+struct DataEntry {
+	std::wstring Path;
+	std::string Seperator;
+	std::string Decimal;
+	std::wstring YColumn; // The y list shows a label, it names the file too if the column is listed already
+};
 
 class MainFrame : public wxFrame
 {
 public:
 	MainFrame(const wxString& title);
+	~MainFrame();
 
 private:
 	void CreateSettingsTab();
@@ -30,25 +46,26 @@ private:
 	wxPGProperty* AppendInChildSameType(wxPropertyGrid* PropertyGrid,
 		wxPGProperty* Property, const wxString& Label = *wxPGProperty::sm_wxPG_LABEL,
 		const wxString& Name = *wxPGProperty::sm_wxPG_LABEL);
-	std::unordered_map<std::string, std::any> GetDataInfos();
-	std::unordered_map<std::string, std::any> GetPlotSettings();
-	PyObject* GetFitFunctions();
-	std::unordered_map<std::string, std::any> GetFitSettings();
+	SettingsMap GetDataInfos();
+	SettingsMap GetPlotSettings();
+	std::vector<std::string> GetFitFunctionNames();
+	PyObject* GetFitFunctions(const std::vector<std::string>& Names); // New reference, NULL with the Python error set
+	SettingsMap GetFitSettings();
 	std::string GetPythonOutput();
-	//bool SettingsChanged(std::unordered_map<std::string, std::any> Settings1,
-	//	std::unordered_map<std::string, std::any> Settings2);
 	void PrintPythonOutput();
 	void ClearPythonOutput();
 	void StoreFunctionVariables();
-	PyObject* ToPyObject(std::any Val);
 	void OnNew(wxCommandEvent& event);
 	void OnOpen(wxCommandEvent& event);
+	void RestoreProject(const std::vector<std::wstring>& Lines, bool Loaded);
 	void OnSave(wxCommandEvent& event);
 	void OnExit(wxCommandEvent& event);
 	void OnEditCSVSettings(wxCommandEvent& event);
 	void OnEditFunctions(wxCommandEvent& event);
 	void ClearAll();
 	void CreatePlot();
+	void OnPlotDone(wxThreadEvent& event);
+	void ShowDataLimits(const SettingsMap& DataInfos);
 	void CreateAdditionalValidators();
 	void ChildsToParent(wxPGProperty* Parent);
 	void OnPropertyGridChanged(wxPropertyGridEvent& event);
@@ -59,11 +76,31 @@ private:
 	void OnRemoveClicked(wxCommandEvent& event);
 	void OnPlotClicked(wxCommandEvent& event);
 	void OnFilePicked(wxFileDirPickerEvent& event);
-	void ProcessPickedFile();
+	void ProcessPickedFile(std::function<void(bool)> Loaded = nullptr, bool KeepDialect = false);
+	void ShowDialect(const wxString& Note);
+	void ShowColumnNames(const std::vector<std::string>& Names);
+	void ShowPreview(const std::string& Path, std::size_t Rows);
+	void SyncDataEntries();
+	void DeleteDataEntry(unsigned int Index);
+	void ClearDataLists();
+	void LoadInBackground(std::function<bool()> Load, std::function<void(bool)> Done);
+	void StartLoading();
+	void LoaderStopped(unsigned long Job, bool Loaded);
+	void FinishLoading(bool Loaded);
+	void CancelLoading();
+	void ShowLoading(bool Show);
+	void OnCancelLoadingClicked(wxCommandEvent& event);
+	void OnLoadingTimer(wxTimerEvent& event);
 	void OnSaveFuncClicked(wxCommandEvent& event);
 	void OnFuncSelected(wxCommandEvent& event);
 	void OnSeperatorSelected(wxCommandEvent& event);
 	void OnDecimalSelected(wxCommandEvent& event);
+	void OnCacheLimitChanged(wxSpinEvent& event);
+	void ApplyCacheLimit();
+	void OnOutOfCoreBudgetChanged(wxSpinEvent& event);
+	void ApplyOutOfCoreBudget();
+	void OnFitCacheClicked(wxCommandEvent& event);
+	void ApplyFitCacheFile();
 	void SaveCSVSettings();
 	void OnCSVSettingsWindowClose(wxCloseEvent& event);
 	void OnFunctionsWindowClose(wxCloseEvent& event);
@@ -111,12 +148,15 @@ private:
 	wxListBox* YList;
 	wxListBox* YErrList;
 	wxButton* PlotButton;
+	wxGrid* PreviewGrid;
 	wxPGProperty* Markers;
 	wxPGProperty* PrZoom;
 	wxPropertyCategory* PGCLegendLabels;
 	wxPGProperty* PlotWidth;
 	wxPGProperty* PlotHeight;
 	wxPGProperty* PlotProjection;
+	wxPGProperty* PlotLiveUpdate;
+	wxPGProperty* PlotSinglePrecision;
 	wxPGProperty* PlotLegendRelX;
 	wxPGProperty* PlotLegendRelY;
 	wxPGProperty* PlotLegendFontsize;
@@ -191,6 +231,9 @@ private:
 	wxPGProperty* FitOrdersZoom;
 	wxChoice* SeperatorChoice;
 	wxChoice* DecimalChoice;
+	wxSpinCtrl* CacheLimitCtrl;
+	wxSpinCtrl* OutOfCoreBudgetCtrl;
+	wxCheckBox* FitCacheCheck;
 	wxChoice* FuncChoice;
 	wxPGProperty* FuncName;
 	wxPGProperty* FuncPython;
@@ -198,7 +241,19 @@ private:
 	wxPGProperty* ParamsCategory;
 	wxArrayPGProperty FuncParams;
 
+	wxStaticText* DialectText;
 	wxActivityIndicator* LoadingIcon;
+	wxStaticText* LoadingText;
+	wxButton* CancelLoadingButton;
+	wxTimer LoadingTimer;
+	std::thread Loader;
+	std::function<void(bool)> LoadingDone;
+	// Load which waits for a cancelled one to stop, readers share the cancel flag:
+	std::function<bool()> PendingLoad;
+	unsigned long LoadingJob = 0;
+	// Fits and draws the plots, Plotting is set until OnPlotDone got the result:
+	PythonExecutor Plotter;
+	bool Plotting = false;
 
 	wxTextCtrl* OutputText;
 
@@ -219,20 +274,39 @@ private:
 
 	PyObject* fp_module;
 	PyObject* plot_module;
+	PyObject* cache_module;
+	PyObject* fit_cache_module;
 	PyObject* fitfunctions_module;
 	PyObject* print_module;
 	PyObject* CPlot;
-	PyObject* GetColNames;
+	PyObject* LoadFile;
+	PyObject* PreviewRowCount;
+	PyObject* PreviewRows;
+	PyObject* PrepareData;
+	PyObject* DataLimits;
+	PyObject* SetCacheLimit;
+	PyObject* SetOutOfCoreBudget;
+	PyObject* SetFitCacheFile;
 	PyObject* catcher;
 	PyObject* ShowPlot;
+	PyObject* Restyle;
+	PyObject* PumpFigures;
+	PyObject* CloseFigures;
 
 	wxString FileName;
+	// Opened or last saved project file, fit results are stored next to it if enabled:
+	std::wstring ProjectPath;
 
-	//std::unordered_map<std::string, std::any> LastDataInfos;
-	//std::unordered_map<std::string, std::any> LastPlotSettings;
-	//PyObject* LastScatterIDs;
+	// Settings of the last plot, compared by ClassifyChanges. Its DataInfos are empty if there was
+	// no successful plot or the fit functions were reloaded since:
+	PlotState LastPlot;
 
 	std::unordered_map<std::string, std::string> CSVSettings;
+	// Seperator and decimal sign of the loaded data file, guessed or restored from the project:
+	std::string DataSeperator;
+	std::string DataDecimal;
+	// Data file of every entry of the data lists, in list order:
+	std::vector<DataEntry> DataEntries;
 	std::unordered_map<std::wstring, std::wstring> PythonFuncs;
 	std::unordered_map<std::wstring, std::wstring> LatexFuncs;
 	std::unordered_map<std::wstring, std::vector<std::wstring>> LatexParams;
@@ -0,0 +1,96 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+	const std::size_t ReleaseAlignment = 1 << 16;
+
+	std::size_t AlignUp(std::size_t Offset) {
+		return (Offset + ReleaseAlignment - 1) / ReleaseAlignment * ReleaseAlignment;
+	}
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& Path) {
+	HANDLE File = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (File == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Unable to open data file");
+	}
+	LARGE_INTEGER FileSize;
+	if (not GetFileSizeEx(File, &FileSize)) {
+		CloseHandle(File);
+		throw std::runtime_error("Unable to read data file size");
+	}
+	FileHandle = File;
+	Length = static_cast<std::size_t>(FileSize.QuadPart);
+	if (Length == 0) { return; } // Empty files can not be mapped
+
+	MapHandle = CreateFileMappingW(File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (MapHandle != NULL) {
+		Begin = static_cast<const char*>(MapViewOfFile(MapHandle, FILE_MAP_READ, 0, 0, 0));
+	}
+	if (Begin == nullptr) {
+		if (MapHandle != NULL) { CloseHandle(MapHandle); }
+		CloseHandle(File);
+		throw std::runtime_error("Unable to map data file");
+	}
+}
+
+void MappedFile::Release(std::size_t First, std::size_t Last) const {
+	First = AlignUp(First);
+	Last = Last >= Length ? Length : Last - Last % ReleaseAlignment;
+	// Unlocking pages which are not locked removes them from the working set:
+	if (First < Last) { VirtualUnlock(const_cast<char*>(Begin + First), Last - First); }
+}
+
+MappedFile::~MappedFile() {
+	if (Begin != nullptr) { UnmapViewOfFile(Begin); }
+	if (MapHandle != nullptr) { CloseHandle(MapHandle); }
+	if (FileHandle != nullptr) { CloseHandle(FileHandle); }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& Path) {
+	int File = open(Path.c_str(), O_RDONLY);
+	if (File < 0) {
+		throw std::runtime_error("Unable to open data file");
+	}
+	struct stat Stat;
+	if (fstat(File, &Stat) != 0) {
+		close(File);
+		throw std::runtime_error("Unable to read data file size");
+	}
+	Length = static_cast<std::size_t>(Stat.st_size);
+	if (Length > 0) {
+		void* Map = mmap(nullptr, Length, PROT_READ, MAP_PRIVATE, File, 0);
+		if (Map == MAP_FAILED) {
+			close(File);
+			throw std::runtime_error("Unable to map data file");
+		}
+		madvise(Map, Length, MADV_SEQUENTIAL);
+		Begin = static_cast<const char*>(Map);
+	}
+	close(File); // The mapping keeps its own reference
+}
+
+void MappedFile::Release(std::size_t First, std::size_t Last) const {
+	First = AlignUp(First);
+	Last = Last >= Length ? Length : Last - Last % ReleaseAlignment;
+	if (First < Last) { madvise(const_cast<char*>(Begin + First), Last - First, MADV_DONTNEED); }
+}
+
+MappedFile::~MappedFile() {
+	if (Begin != nullptr) { munmap(const_cast<char*>(Begin), Length); }
+}
+
+#endif
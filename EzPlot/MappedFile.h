@@ -0,0 +1,28 @@
+#pragma once
+#include <filesystem>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file. Pages are loaded by the OS on access and can be
+// dropped again under memory pressure, so mapping does not count like a copy of the file.
+class MappedFile {
+public:
+	explicit MappedFile(const std::filesystem::path& Path);
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const char* Data() const { return Begin; }
+	std::size_t Size() const { return Length; }
+
+	// Drop the pages of [Begin, End) from the resident set after they were processed,
+	// they are read from the file again if they are accessed later:
+	void Release(std::size_t Begin, std::size_t End) const;
+
+private:
+	const char* Begin = nullptr;
+	std::size_t Length = 0;
+#ifdef _WIN32
+	void* FileHandle = nullptr;
+	void* MapHandle = nullptr;
+#endif
+};
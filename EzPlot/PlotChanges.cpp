@@ -0,0 +1,58 @@
+#include "PlotChanges.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+
+SettingValue Setting(const SettingsMap& Settings, const std::string& Key) {
+	auto Found = Settings.find(Key);
+	return Found == Settings.end() ? SettingValue() : Found->second;
+}
+
+// Fit settings which only change how a fit is drawn, its result is kept. plot.Restyle changes
+// the first ones on the open figure, the others need it drawn again:
+const std::unordered_set<std::string> FitRestyles = { "Color", "Line", "FitLinewidth" };
+const std::unordered_set<std::string> FitStyles = { "Name", "pArea", "FitOrder", "FitOrdersZoom", "NumFits" };
+
+// Plot settings which plot.Restyle changes on the open figure, all others draw it again:
+const std::unordered_set<std::string> PlotRestyles = {
+	"LegendRelX", "LegendRelY", "LegendFontsize", "LegendHandlelength", "LegendMarkerscale",
+	"LegendLabels", "LegendOrder" };
+
+}
+
+PlotChanges ClassifyChanges(const PlotState& Last, const PlotState& Next) {
+	PlotChanges Changes;
+	if (Last.DataInfos.empty() or Next.DataInfos != Last.DataInfos
+		or Setting(Next.PlotSettings, "SinglePrecision") != Setting(Last.PlotSettings, "SinglePrecision")) {
+		return Changes;
+	}
+
+	bool Redraw = false;
+	auto Refit = [&Changes](const std::optional<std::vector<std::size_t>>& Items) {
+		if (not Items) { return false; }
+		Changes.Refits.insert(Changes.Refits.end(), Items->begin(), Items->end());
+		return true;
+	};
+	// Lists hold one item per fit, other changed values apply to all fits:
+	if (not Refit(ChangedItems(Last.FitFunctions, Next.FitFunctions))) { return Changes; }
+	for (const std::string& Key : ChangedSettings(Last.FitSettings, Next.FitSettings)) {
+		if (FitRestyles.contains(Key)) { continue; }
+		if (FitStyles.contains(Key)) {
+			Redraw = true;
+			continue;
+		}
+		if (not Refit(ChangedItems(Setting(Last.FitSettings, Key), Setting(Next.FitSettings, Key)))) {
+			return Changes;
+		}
+	}
+	for (const std::string& Key : ChangedSettings(Last.PlotSettings, Next.PlotSettings)) {
+		if (not PlotRestyles.contains(Key)) { Redraw = true; }
+	}
+
+	std::sort(Changes.Refits.begin(), Changes.Refits.end());
+	Changes.Refits.erase(std::unique(Changes.Refits.begin(), Changes.Refits.end()), Changes.Refits.end());
+	if (not Changes.Refits.empty()) { Changes.Update = PlotUpdate::Refit; }
+	else { Changes.Update = Redraw ? PlotUpdate::Redraw : PlotUpdate::Restyle; }
+	return Changes;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "SettingValue.h"
+#include <vector>
+#include <string>
+
+// Settings of one plot as handed to plot.CPlot. DataInfos is empty if there is no plot to compare
+// with (none succeeded yet or the fit functions were reloaded):
+struct PlotState {
+	SettingsMap DataInfos;
+	SettingsMap PlotSettings;
+	SettingsMap FitSettings;
+	std::vector<std::string> FitFunctions;
+};
+
+// What the next plot has to do, from the most to the least work:
+enum class PlotUpdate {
+	Full,    // Other data or precision, or a fit setting which is no list: every fit runs again
+	Refit,   // The fits in Refits run again, the others and the figure are drawn with the last results
+	Redraw,  // Only how the figure looks changed, it is drawn again with the last fit results
+	Restyle  // Only fit line styles and the legend changed, the open figure is changed in place
+};
+
+struct PlotChanges {
+	PlotUpdate Update = PlotUpdate::Full;
+	std::vector<long> Refits; // Sorted fit numbers for Refit
+};
+
+// Compares the settings of the next plot with the last one:
+PlotChanges ClassifyChanges(const PlotState& Last, const PlotState& Next);
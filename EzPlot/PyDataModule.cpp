@@ -0,0 +1,582 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h> // Must be first
+#include "PyDataModule.h"
+#include "DataReader.h"
+#include "XLSXReader.h"
+#include "ArrowReader.h"
+#include "DataStream.h"
+#include "LoadProgress.h"
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+#include <new>
+#include <functional>
+#include <limits>
+
+// =======
+// COLUMNS
+// =======
+
+// Column values exported with the buffer protocol, so numpy.frombuffer uses them without copying:
+typedef struct {
+	PyObject_HEAD
+	DataColumn* Values;
+	Py_ssize_t Shape[1];
+	Py_ssize_t Strides[1];
+	bool Numeric;
+} ColumnObject;
+
+static PyTypeObject ColumnType = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+// ezdata.Cancelled, raised when the load was cancelled with LoadProgress::Cancel:
+static PyObject* CancelledError = NULL;
+
+static void Column_dealloc(ColumnObject* self) {
+	delete self->Values;
+	PyObject_Del(self);
+}
+
+static int Column_getbuffer(ColumnObject* self, Py_buffer* view, int flags) {
+	if (flags & PyBUF_WRITABLE) {
+		PyErr_SetString(PyExc_BufferError, "Column is read-only");
+		view->obj = NULL;
+		return -1;
+	}
+	Py_INCREF(self);
+	view->obj = (PyObject*)self;
+	view->buf = const_cast<double*>(self->Values->Data());
+	view->len = self->Shape[0] * sizeof(double);
+	view->readonly = 1;
+	view->itemsize = sizeof(double);
+	view->format = (flags & PyBUF_FORMAT) ? (char*)"d" : NULL;
+	view->ndim = 1;
+	view->shape = (flags & PyBUF_ND) ? self->Shape : NULL;
+	view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? self->Strides : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+	return 0;
+}
+
+static Py_ssize_t Column_length(ColumnObject* self) {
+	return self->Shape[0];
+}
+
+static PyObject* Column_numeric(ColumnObject* self, void* closure) {
+	return PyBool_FromLong(self->Numeric);
+}
+
+static PyObject* Column_mapped(ColumnObject* self, void* closure) {
+	return PyBool_FromLong(self->Values->External != nullptr);
+}
+
+// {"Count", "Missing", "Min", "Max", "Mean"}, Min, Max and Mean are NaN without values
+static PyObject* Column_stats(ColumnObject* self, void* closure) {
+	const ColumnStats& Stats = self->Values->Stats;
+	double NaN = std::numeric_limits<double>::quiet_NaN();
+	bool Empty = Stats.Count == 0;
+	return Py_BuildValue("{s:n,s:n,s:d,s:d,s:d}", "Count", (Py_ssize_t)Stats.Count, "Missing", (Py_ssize_t)Stats.Missing,
+		"Min", Empty ? NaN : Stats.Min, "Max", Empty ? NaN : Stats.Max, "Mean", Empty ? NaN : Stats.Sum / Stats.Count);
+}
+
+static PyBufferProcs ColumnBuffer = { (getbufferproc)Column_getbuffer, NULL };
+static PySequenceMethods ColumnSequence = { (lenfunc)Column_length };
+static PyGetSetDef ColumnGetSet[] = {
+	{ "numeric", (getter)Column_numeric, NULL, "False if a field could not be parsed as number", NULL },
+	{ "mapped", (getter)Column_mapped, NULL, "True if the values are used in place in the mapped data file", NULL },
+	{ "stats", (getter)Column_stats, NULL, "Count, missing values, min, max and mean, collected while parsing", NULL },
+	{ NULL }
+};
+
+static PyObject* NewColumn(DataColumn&& Values) {
+	ColumnObject* Column = PyObject_New(ColumnObject, &ColumnType);
+	if (!Column) return NULL;
+	Column->Values = new DataColumn(std::move(Values));
+	Column->Shape[0] = Column->Values->Size();
+	Column->Strides[0] = sizeof(double);
+	Column->Numeric = Column->Values->Numeric;
+	return (PyObject*)Column;
+}
+
+static PyObject* NamesToList(const std::vector<std::string>& Names) {
+	PyObject* List = PyList_New(Names.size());
+	if (!List) return NULL;
+	for (std::size_t i = 0; i < Names.size(); i++) {
+		PyObject* Name = PyUnicode_DecodeUTF8(Names[i].data(), Names[i].size(), "replace");
+		if (!Name) {
+			Py_DECREF(List);
+			return NULL;
+		}
+		PyList_SET_ITEM(List, i, Name);
+	}
+	return List;
+}
+
+// =======
+// SOURCES
+// =======
+
+// Data file (CSV, xlsx or Arrow), columns are parsed on request:
+typedef struct {
+	PyObject_HEAD
+	DataSource* Source;
+} SourceObject;
+
+static PyTypeObject SourceType = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+static void Source_dealloc(SourceObject* self) {
+	delete self->Source;
+	PyObject_Del(self);
+}
+
+static PyObject* Source_names(SourceObject* self, void* closure) {
+	return NamesToList(self->Source->Names());
+}
+
+// columns([names][, first, count]) -> [Column], all columns are parsed in one pass. With first
+// and count only these rows are parsed (uncompressed CSV files only)
+static PyObject* Source_columns(SourceObject* self, PyObject* args) {
+	PyObject* NameList;
+	Py_ssize_t First = -1, Count = -1;
+	if (!PyArg_ParseTuple(args, "O|nn", &NameList, &First, &Count)) return NULL;
+	const CSVSource* Ranged = NULL;
+	if (PyTuple_GET_SIZE(args) > 1) {
+		Ranged = dynamic_cast<const CSVSource*>(self->Source);
+		if (!Ranged) {
+			PyErr_SetString(PyExc_TypeError, "row ranges are only indexed in uncompressed CSV files");
+			return NULL;
+		}
+		if (First < 0 || Count < 0) {
+			PyErr_SetString(PyExc_ValueError, "first and count must not be negative");
+			return NULL;
+		}
+	}
+	PyObject* Sequence = PySequence_Fast(NameList, "names must be a sequence");
+	if (!Sequence) return NULL;
+
+	const std::vector<std::string>& Names = self->Source->Names();
+	std::vector<std::size_t> Indices;
+	for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(Sequence); i++) {
+		const char* Name = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(Sequence, i));
+		if (!Name) {
+			Py_DECREF(Sequence);
+			return NULL;
+		}
+		std::size_t Index = std::find(Names.begin(), Names.end(), Name) - Names.begin();
+		if (Index == Names.size()) {
+			PyErr_Format(PyExc_KeyError, "%s", Name);
+			Py_DECREF(Sequence);
+			return NULL;
+		}
+		Indices.push_back(Index);
+	}
+	Py_DECREF(Sequence);
+
+	std::vector<DataColumn> Columns;
+	bool Failed = false;
+	bool Cancelled = false;
+	std::string Error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		Columns = Ranged ? Ranged->Columns(Indices, First, Count) : self->Source->Columns(Indices);
+	}
+	catch (const std::bad_alloc&) {
+		Failed = true;
+	}
+	catch (const LoadCancelled&) {
+		Cancelled = true;
+	}
+	catch (const std::exception& e) {
+		Error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+	if (Failed) return PyErr_NoMemory();
+	if (Cancelled) {
+		PyErr_SetString(CancelledError, "Loading cancelled");
+		return NULL;
+	}
+	if (!Error.empty()) {
+		PyErr_SetString(PyExc_OSError, Error.c_str());
+		return NULL;
+	}
+
+	PyObject* List = PyList_New(Columns.size());
+	if (!List) return NULL;
+	for (std::size_t i = 0; i < Columns.size(); i++) {
+		PyObject* Column = NewColumn(std::move(Columns[i]));
+		if (!Column) {
+			Py_DECREF(List);
+			return NULL;
+		}
+		PyList_SET_ITEM(List, i, Column);
+	}
+	return List;
+}
+
+// Number of data rows, None if the source has no row index (only mapped CSV files have one)
+static PyObject* Source_row_count(SourceObject* self, void* closure) {
+	const CSVSource* Source = dynamic_cast<const CSVSource*>(self->Source);
+	if (!Source) Py_RETURN_NONE;
+	return PyLong_FromSize_t(Source->Rows());
+}
+
+// rows(first, count) -> [[str]], text of the fields of the rows, only the requested rows are read
+static PyObject* Source_rows(SourceObject* self, PyObject* args) {
+	Py_ssize_t First, Count;
+	if (!PyArg_ParseTuple(args, "nn", &First, &Count)) return NULL;
+	const CSVSource* Source = dynamic_cast<const CSVSource*>(self->Source);
+	if (!Source) {
+		PyErr_SetString(PyExc_TypeError, "rows are only indexed in uncompressed CSV files");
+		return NULL;
+	}
+	if (First < 0 || Count < 0) {
+		PyErr_SetString(PyExc_ValueError, "first and count must not be negative");
+		return NULL;
+	}
+
+	std::vector<std::string> Cells;
+	bool Failed = false;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		Cells = Source->Cells(First, Count);
+	}
+	catch (const std::bad_alloc&) {
+		Failed = true;
+	}
+	Py_END_ALLOW_THREADS
+	if (Failed) return PyErr_NoMemory();
+
+	std::size_t Width = Source->Names().size();
+	std::size_t Rows = Width > 0 ? Cells.size() / Width : 0;
+	PyObject* List = PyList_New(Rows);
+	if (!List) return NULL;
+	for (std::size_t i = 0; i < Rows; i++) {
+		PyObject* Row = PyList_New(Width);
+		if (!Row) {
+			Py_DECREF(List);
+			return NULL;
+		}
+		PyList_SET_ITEM(List, i, Row);
+		for (std::size_t k = 0; k < Width; k++) {
+			const std::string& Cell = Cells[i * Width + k];
+			PyObject* Text = PyUnicode_DecodeUTF8(Cell.data(), Cell.size(), "replace");
+			if (!Text) {
+				Py_DECREF(List);
+				return NULL;
+			}
+			PyList_SET_ITEM(Row, k, Text);
+		}
+	}
+	return List;
+}
+
+static PyMethodDef SourceMethods[] = {
+	{ "columns", (PyCFunction)Source_columns, METH_VARARGS,
+		"columns(names[, first, count]) -> list of Column, parses the requested columns (of count rows from first on) in one pass" },
+	{ "rows", (PyCFunction)Source_rows, METH_VARARGS,
+		"rows(first, count) -> list of rows as lists of field texts, uncompressed CSV files only" },
+	{ NULL }
+};
+
+static PyGetSetDef SourceGetSet[] = {
+	{ "names", (getter)Source_names, NULL, "Column names", NULL },
+	{ "row_count", (getter)Source_row_count, NULL, "Number of data rows, None without row index", NULL },
+	{ NULL }
+};
+
+// =========
+// FUNCTIONS
+// =========
+
+static bool ToPath(PyObject* PathObj, std::filesystem::path& Path) {
+	wchar_t* WPath = PyUnicode_AsWideCharString(PathObj, NULL);
+	if (!WPath) return false;
+	Path = std::filesystem::path(std::wstring(WPath));
+	PyMem_Free(WPath);
+	return true;
+}
+
+static bool ToChar(const char* Str, const char* Name, char& Char) {
+	if (std::char_traits<char>::length(Str) != 1) {
+		PyErr_Format(PyExc_ValueError, "%s must be a single character", Name);
+		return false;
+	}
+	Char = Str[0];
+	return true;
+}
+
+static PyObject* TableToDict(DataTable& Table) {
+	PyObject* Dict = PyDict_New();
+	if (!Dict) return NULL;
+	for (DataColumn& Column : Table.Columns) {
+		PyObject* Name = PyUnicode_DecodeUTF8(Column.Name.data(), Column.Name.size(), "replace");
+		PyObject* Values = NewColumn(std::move(Column));
+		if (!Name || !Values || PyDict_SetItem(Dict, Name, Values) < 0) {
+			Py_XDECREF(Name);
+			Py_XDECREF(Values);
+			Py_DECREF(Dict);
+			return NULL;
+		}
+		Py_DECREF(Name);
+		Py_DECREF(Values);
+	}
+	return Dict;
+}
+
+// read_csv(path, seperator, decimal) -> {name: Column}
+static PyObject* ezdata_read_csv(PyObject* self, PyObject* args) {
+	PyObject* PathObj;
+	const char* SeperatorStr;
+	const char* DecimalStr;
+	char Seperator, Decimal;
+	std::filesystem::path Path;
+	if (!PyArg_ParseTuple(args, "Uss", &PathObj, &SeperatorStr, &DecimalStr)) return NULL;
+	if (!ToPath(PathObj, Path) || !ToChar(SeperatorStr, "seperator", Seperator)
+		|| !ToChar(DecimalStr, "decimal", Decimal)) return NULL;
+
+	// Parse without holding the GIL:
+	DataTable Table;
+	bool Cancelled = false;
+	std::string Error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		Table = ReadCSV(Path, Seperator, Decimal);
+	}
+	catch (const LoadCancelled&) {
+		Cancelled = true;
+	}
+	catch (const std::exception& e) {
+		Error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+
+	if (Cancelled) {
+		PyErr_SetString(CancelledError, "Loading cancelled");
+		return NULL;
+	}
+	if (!Error.empty()) {
+		PyErr_Format(PyExc_OSError, "%s: %U", Error.c_str(), PathObj);
+		return NULL;
+	}
+	return TableToDict(Table);
+}
+
+// read_header(path, seperator) -> [names]
+static PyObject* ezdata_read_header(PyObject* self, PyObject* args) {
+	PyObject* PathObj;
+	const char* SeperatorStr;
+	char Seperator;
+	std::filesystem::path Path;
+	if (!PyArg_ParseTuple(args, "Us", &PathObj, &SeperatorStr)) return NULL;
+	if (!ToPath(PathObj, Path) || !ToChar(SeperatorStr, "seperator", Seperator)) return NULL;
+
+	std::vector<std::string> Names;
+	try {
+		Names = ReadCSVHeader(Path, Seperator);
+	}
+	catch (const std::exception& e) {
+		PyErr_Format(PyExc_OSError, "%s: %U", e.what(), PathObj);
+		return NULL;
+	}
+
+	return NamesToList(Names);
+}
+
+// read_rows(path, seperator, decimal, indices, offset) -> ([Column], end offset)
+static PyObject* ezdata_read_rows(PyObject* self, PyObject* args) {
+	PyObject* PathObj;
+	const char* SeperatorStr;
+	const char* DecimalStr;
+	PyObject* IndicesObj;
+	unsigned long long Offset;
+	char Seperator, Decimal;
+	std::filesystem::path Path;
+	if (!PyArg_ParseTuple(args, "UssOK", &PathObj, &SeperatorStr, &DecimalStr, &IndicesObj, &Offset)) return NULL;
+	if (!ToPath(PathObj, Path) || !ToChar(SeperatorStr, "seperator", Seperator)
+		|| !ToChar(DecimalStr, "decimal", Decimal)) return NULL;
+
+	PyObject* Sequence = PySequence_Fast(IndicesObj, "indices must be a sequence");
+	if (!Sequence) return NULL;
+	std::vector<std::size_t> Indices;
+	for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(Sequence); i++) {
+		std::size_t Index = PyLong_AsSize_t(PySequence_Fast_GET_ITEM(Sequence, i));
+		if (Index == (std::size_t)-1 && PyErr_Occurred()) {
+			Py_DECREF(Sequence);
+			return NULL;
+		}
+		Indices.push_back(Index);
+	}
+	Py_DECREF(Sequence);
+
+	std::vector<DataColumn> Columns;
+	std::size_t End = 0;
+	std::string Error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		End = ReadCSVRows(Path, Seperator, Decimal, static_cast<std::size_t>(Offset), Indices, Columns);
+	}
+	catch (const std::exception& e) {
+		Error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+
+	if (!Error.empty()) {
+		PyErr_Format(PyExc_OSError, "%s: %U", Error.c_str(), PathObj);
+		return NULL;
+	}
+	PyObject* List = PyList_New(Columns.size());
+	if (!List) return NULL;
+	for (std::size_t i = 0; i < Columns.size(); i++) {
+		PyObject* Column = NewColumn(std::move(Columns[i]));
+		if (!Column) {
+			Py_DECREF(List);
+			return NULL;
+		}
+		PyList_SET_ITEM(List, i, Column);
+	}
+	return Py_BuildValue("(NK)", List, (unsigned long long)End);
+}
+
+static PyObject* NewSource(PyObject* PathObj, const std::function<DataSource*()>& Open) {
+	// Map and index without holding the GIL:
+	DataSource* Source = nullptr;
+	bool Cancelled = false;
+	std::string Error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		Source = Open();
+	}
+	catch (const LoadCancelled&) {
+		Cancelled = true;
+	}
+	catch (const std::exception& e) {
+		Error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+
+	if (Cancelled) {
+		PyErr_SetString(CancelledError, "Loading cancelled");
+		return NULL;
+	}
+	if (!Source) {
+		PyErr_Format(PyExc_OSError, "%s: %U", Error.c_str(), PathObj);
+		return NULL;
+	}
+	SourceObject* Object = PyObject_New(SourceObject, &SourceType);
+	if (!Object) {
+		delete Source;
+		return NULL;
+	}
+	Object->Source = Source;
+	return (PyObject*)Object;
+}
+
+// open_csv(path, seperator, decimal) -> Source
+static PyObject* ezdata_open_csv(PyObject* self, PyObject* args) {
+	PyObject* PathObj;
+	const char* SeperatorStr;
+	const char* DecimalStr;
+	char Seperator, Decimal;
+	std::filesystem::path Path;
+	if (!PyArg_ParseTuple(args, "Uss", &PathObj, &SeperatorStr, &DecimalStr)) return NULL;
+	if (!ToPath(PathObj, Path) || !ToChar(SeperatorStr, "seperator", Seperator)
+		|| !ToChar(DecimalStr, "decimal", Decimal)) return NULL;
+	return NewSource(PathObj, [&]() -> DataSource* {
+		if (DataStream::IsCompressed(Path)) { return new CompressedCSVSource(Path, Seperator, Decimal); }
+		return new CSVSource(Path, Seperator, Decimal);
+	});
+}
+
+// open_xlsx(path) -> Source
+static PyObject* ezdata_open_xlsx(PyObject* self, PyObject* args) {
+	PyObject* PathObj;
+	std::filesystem::path Path;
+	if (!PyArg_ParseTuple(args, "U", &PathObj)) return NULL;
+	if (!ToPath(PathObj, Path)) return NULL;
+	return NewSource(PathObj, [&]() { return new XLSXSource(Path); });
+}
+
+// open_arrow(path) -> Source
+static PyObject* ezdata_open_arrow(PyObject* self, PyObject* args) {
+	PyObject* PathObj;
+	std::filesystem::path Path;
+	if (!PyArg_ParseTuple(args, "U", &PathObj)) return NULL;
+	if (!ToPath(PathObj, Path)) return NULL;
+	return NewSource(PathObj, [&]() { return new ArrowSource(Path); });
+}
+
+static PyObject* ezdata_check_cancelled(PyObject* self, PyObject* args) {
+	if (LoadProgress::Current().IsCancelled()) {
+		PyErr_SetString(CancelledError, "Loading cancelled");
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef ezdataMethods[] = {
+	{ "read_csv", ezdata_read_csv, METH_VARARGS,
+		"read_csv(path, seperator, decimal) -> dict of columns with buffer protocol (float64)" },
+	{ "read_header", ezdata_read_header, METH_VARARGS,
+		"read_header(path, seperator) -> list of column names, only the first row is read" },
+	{ "read_rows", ezdata_read_rows, METH_VARARGS,
+		"read_rows(path, seperator, decimal, indices, offset) -> (columns, end), complete rows behind offset" },
+	{ "open_csv", ezdata_open_csv, METH_VARARGS,
+		"open_csv(path, seperator, decimal) -> Source, memory mapped (or gzip/zstd streamed) file with lazily parsed columns" },
+	{ "open_xlsx", ezdata_open_xlsx, METH_VARARGS,
+		"open_xlsx(path) -> Source, first worksheet with lazily parsed columns" },
+	{ "open_arrow", ezdata_open_arrow, METH_VARARGS,
+		"open_arrow(path) -> Source, memory mapped Arrow IPC (Feather) file, float64 columns are used in place" },
+	{ "check_cancelled", ezdata_check_cancelled, METH_NOARGS,
+		"check_cancelled() raises Cancelled if the running load was cancelled, for the steps which are not done by ezdata" },
+	{ NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef ezdataModule = {
+	PyModuleDef_HEAD_INIT, "ezdata", "Native data file readers of EzPlot", -1, ezdataMethods
+};
+
+PyMODINIT_FUNC PyInit_ezdata(void) {
+	ColumnType.tp_name = "ezdata.Column";
+	ColumnType.tp_basicsize = sizeof(ColumnObject);
+	ColumnType.tp_flags = Py_TPFLAGS_DEFAULT;
+	ColumnType.tp_doc = "Parsed data column, use numpy.frombuffer(column) to access the values";
+	ColumnType.tp_dealloc = (destructor)Column_dealloc;
+	ColumnType.tp_as_buffer = &ColumnBuffer;
+	ColumnType.tp_as_sequence = &ColumnSequence;
+	ColumnType.tp_getset = ColumnGetSet;
+	if (PyType_Ready(&ColumnType) < 0) return NULL;
+
+	SourceType.tp_name = "ezdata.Source";
+	SourceType.tp_basicsize = sizeof(SourceObject);
+	SourceType.tp_flags = Py_TPFLAGS_DEFAULT;
+	SourceType.tp_doc = "Data file with lazily parsed columns, use open_csv, open_xlsx or open_arrow to create it";
+	SourceType.tp_dealloc = (destructor)Source_dealloc;
+	SourceType.tp_methods = SourceMethods;
+	SourceType.tp_getset = SourceGetSet;
+	if (PyType_Ready(&SourceType) < 0) return NULL;
+
+	PyObject* Module = PyModule_Create(&ezdataModule);
+	if (!Module) return NULL;
+	Py_INCREF(&ColumnType);
+	if (PyModule_AddObject(Module, "Column", (PyObject*)&ColumnType) < 0) {
+		Py_DECREF(&ColumnType);
+		Py_DECREF(Module);
+		return NULL;
+	}
+	Py_INCREF(&SourceType);
+	if (PyModule_AddObject(Module, "Source", (PyObject*)&SourceType) < 0) {
+		Py_DECREF(&SourceType);
+		Py_DECREF(Module);
+		return NULL;
+	}
+	CancelledError = PyErr_NewException("ezdata.Cancelled", NULL, NULL);
+	Py_XINCREF(CancelledError);
+	if (PyModule_AddObject(Module, "Cancelled", CancelledError) < 0) {
+		Py_XDECREF(CancelledError);
+		Py_CLEAR(CancelledError);
+		Py_DECREF(Module);
+		return NULL;
+	}
+	return Module;
+}
@@ -0,0 +1,6 @@
+#pragma once
+#include <Python.h>
+
+// Native data module "ezdata" for the embedded interpreter. It has to be registered
+// with PyImport_AppendInittab before Py_Initialize is called.
+PyMODINIT_FUNC PyInit_ezdata(void);
@@ -1,6 +1,7 @@
 #include <Python.h> // Must be first
 #include <vector>
 #include <stdexcept>
+#include <memory>
 #include "PyUtils.h"
 using namespace std;
 
@@ -9,17 +10,119 @@ using namespace std;
 // =====
 
 PyObject* vectorToList_Float(const vector<float>& data) {
-	PyObject* listObj = PyList_New(data.size());
+	PyRef listObj(PyList_New(data.size()));
 	if (!listObj) throw logic_error("Unable to allocate memory for Python list");
 	for (unsigned int i = 0; i < data.size(); i++) {
 		PyObject* num = PyFloat_FromDouble((double)data[i]);
-		if (!num) {
-			Py_DECREF(listObj);
-			throw logic_error("Unable to allocate memory for Python list");
-		}
-		PyList_SET_ITEM(listObj, i, num);
+		if (!num) throw logic_error("Unable to allocate memory for Python list");
+		PyList_SET_ITEM(listObj.Get(), i, num);
+	}
+	return listObj.Release();
+}
+
+// ============
+// NUMPY ARRAYS
+// ============
+
+// Exports the values of a vector with the buffer protocol. The vector is kept alive by the
+// capsule Owner, so the numpy array made from it uses the values without copying them.
+typedef struct {
+	PyObject_HEAD
+	PyObject* Owner;
+	const void* Data;
+	Py_ssize_t Shape[1];
+	Py_ssize_t Strides[1];
+	const char* Format;
+} VectorBufferObject;
+
+static PyTypeObject VectorBufferType = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+static void VectorBuffer_dealloc(VectorBufferObject* self) {
+	Py_XDECREF(self->Owner);
+	PyObject_Del(self);
+}
+
+static int VectorBuffer_getbuffer(VectorBufferObject* self, Py_buffer* view, int flags) {
+	if (flags & PyBUF_WRITABLE) {
+		PyErr_SetString(PyExc_BufferError, "Vector values are read-only");
+		view->obj = NULL;
+		return -1;
 	}
-	return listObj;
+	Py_INCREF(self);
+	view->obj = (PyObject*)self;
+	view->buf = const_cast<void*>(self->Data);
+	view->len = self->Shape[0] * self->Strides[0];
+	view->readonly = 1;
+	view->itemsize = self->Strides[0];
+	view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(self->Format) : NULL;
+	view->ndim = 1;
+	view->shape = (flags & PyBUF_ND) ? self->Shape : NULL;
+	view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? self->Strides : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+	return 0;
+}
+
+static PyBufferProcs VectorBuffer = { (getbufferproc)VectorBuffer_getbuffer, NULL };
+
+template <typename T>
+static void DeleteVector(PyObject* Capsule) {
+	delete static_cast<shared_ptr<const vector<T>>*>(PyCapsule_GetPointer(Capsule, "PyUtils.vector"));
+}
+
+template <typename T>
+static PyObject* vectorToArray(shared_ptr<const vector<T>> data, const char* Format, const char* DType) {
+	// numpy.frombuffer is looked up once, the embedded interpreter lives as long as the app
+	static PyObject* FromBuffer = NULL;
+	if (!FromBuffer) {
+		PyObject* NumPy = PyImport_ImportModule("numpy");
+		if (!NumPy) return NULL;
+		FromBuffer = PyObject_GetAttrString(NumPy, "frombuffer");
+		Py_DECREF(NumPy);
+		if (!FromBuffer) return NULL;
+	}
+	if (!(VectorBufferType.tp_flags & Py_TPFLAGS_READY)) {
+		VectorBufferType.tp_name = "PyUtils.VectorBuffer";
+		VectorBufferType.tp_basicsize = sizeof(VectorBufferObject);
+		VectorBufferType.tp_flags = Py_TPFLAGS_DEFAULT;
+		VectorBufferType.tp_doc = "Values of a C++ vector, use numpy.frombuffer to access them";
+		VectorBufferType.tp_dealloc = (destructor)VectorBuffer_dealloc;
+		VectorBufferType.tp_as_buffer = &VectorBuffer;
+		if (PyType_Ready(&VectorBufferType) < 0) return NULL;
+	}
+
+	auto Held = new shared_ptr<const vector<T>>(std::move(data));
+	PyRef Owner(PyCapsule_New(Held, "PyUtils.vector", &DeleteVector<T>));
+	if (!Owner) {
+		delete Held;
+		return NULL;
+	}
+	PyRef Buffer((PyObject*)PyObject_New(VectorBufferObject, &VectorBufferType));
+	if (!Buffer) return NULL;
+	VectorBufferObject* Exported = (VectorBufferObject*)Buffer.Get();
+	Exported->Owner = Owner.Release();
+	Exported->Data = (*Held)->data();
+	Exported->Shape[0] = (*Held)->size();
+	Exported->Strides[0] = sizeof(T);
+	Exported->Format = Format;
+
+	return PyObject_CallFunction(FromBuffer, "Os", Buffer.Get(), DType);
+}
+
+PyObject* vectorToArray_Double(shared_ptr<const vector<double>> data) {
+	return vectorToArray(std::move(data), "d", "float64");
+}
+
+PyObject* vectorToArray_Double(vector<double>&& data) {
+	return vectorToArray_Double(make_shared<const vector<double>>(std::move(data)));
+}
+
+PyObject* vectorToArray_Float(shared_ptr<const vector<float>> data) {
+	return vectorToArray(std::move(data), "f", "float32");
+}
+
+PyObject* vectorToArray_Float(vector<float>&& data) {
+	return vectorToArray_Float(make_shared<const vector<float>>(std::move(data)));
 }
 
 // ======
@@ -27,39 +130,26 @@ PyObject* vectorToList_Float(const vector<float>& data) {
 // ======
 
 PyObject* vectorToTuple_Float(const vector<float>& data) {
-	PyObject* tuple = PyTuple_New(data.size());
+	PyRef tuple(PyTuple_New(data.size()));
 	if (!tuple) throw logic_error("Unable to allocate memory for Python tuple");
 	for (unsigned int i = 0; i < data.size(); i++) {
 		PyObject* num = PyFloat_FromDouble((double)data[i]);
-		if (!num) {
-			Py_DECREF(tuple);
-			throw logic_error("Unable to allocate memory for Python tuple");
-		}
-		PyTuple_SET_ITEM(tuple, i, num);
+		if (!num) throw logic_error("Unable to allocate memory for Python tuple");
+		PyTuple_SET_ITEM(tuple.Get(), i, num);
 	}
 
-	return tuple;
+	return tuple.Release();
 }
 
 PyObject* vectorVectorToTuple_Float(const vector< vector< float > >& data) {
-	PyObject* tuple = PyTuple_New(data.size());
+	PyRef tuple(PyTuple_New(data.size()));
 	if (!tuple) throw logic_error("Unable to allocate memory for Python tuple");
 	for (unsigned int i = 0; i < data.size(); i++) {
-		PyObject* subTuple = NULL;
-		try {
-			subTuple = vectorToTuple_Float(data[i]);
-		}
-		catch (logic_error& e) {
-			throw e;
-		}
-		if (!subTuple) {
-			Py_DECREF(tuple);
-			throw logic_error("Unable to allocate memory for Python tuple of tuples");
-		}
-		PyTuple_SET_ITEM(tuple, i, subTuple);
+		// Throws on failure, tuple releases the sub tuples set so far
+		PyTuple_SET_ITEM(tuple.Get(), i, vectorToTuple_Float(data[i]));
 	}
 
-	return tuple;
+	return tuple.Release();
 }
 
 // PyObject -> Vector
@@ -3,10 +3,21 @@
 
 #include <Python.h>
 #include <vector>
+#include <memory>
 using namespace std;
 
 PyObject* vectorToList_Float(const vector<float>& data);
 
+// Read-only numpy arrays using the values of the vector in place, the array shares the ownership.
+// Return NULL with the Python error set if numpy is missing. Need the GIL.
+PyObject* vectorToArray_Double(shared_ptr<const vector<double>> data);
+
+PyObject* vectorToArray_Double(vector<double>&& data);
+
+PyObject* vectorToArray_Float(shared_ptr<const vector<float>> data);
+
+PyObject* vectorToArray_Float(vector<float>&& data);
+
 PyObject* vectorToTuple_Float(const vector<float>& data);
 
 PyObject* vectorVectorToTuple_Float(const vector< vector< float > >& data);
@@ -17,4 +28,55 @@ vector<int> listTupleToVector_Int(PyObject* incoming);
 
 vector<const char*> listTupleToVector_String(PyObject* incoming);
 
+// Holds the GIL while in scope. The GUI thread does not keep it, so it has to be taken
+// around every Python call (also nested, e.g. from the loading thread of MainFrame):
+class PyLock {
+public:
+	PyLock() : State(PyGILState_Ensure()) {}
+	~PyLock() { PyGILState_Release(State); }
+	PyLock(const PyLock&) = delete;
+	PyLock& operator=(const PyLock&) = delete;
+
+private:
+	PyGILState_STATE State;
+};
+
+// Owns one reference to a Python object and releases it when going out of scope, so it has
+// to live inside a PyLock. Construct it from new references only, use Borrow for borrowed ones:
+class PyRef {
+public:
+	PyRef() = default;
+	explicit PyRef(PyObject* Object) : Object(Object) {}
+	~PyRef() { Py_XDECREF(Object); }
+	PyRef(const PyRef&) = delete;
+	PyRef& operator=(const PyRef&) = delete;
+	PyRef(PyRef&& Other) noexcept : Object(Other.Release()) {}
+	PyRef& operator=(PyRef&& Other) noexcept {
+		Reset(Other.Release());
+		return *this;
+	}
+
+	static PyRef Borrow(PyObject* Object) {
+		Py_XINCREF(Object);
+		return PyRef(Object);
+	}
+
+	PyObject* Get() const { return Object; }
+	// Gives up the reference, for calls which steal it:
+	PyObject* Release() {
+		PyObject* Released = Object;
+		Object = NULL;
+		return Released;
+	}
+	void Reset(PyObject* New = NULL) {
+		PyObject* Old = Object;
+		Object = New;
+		Py_XDECREF(Old);
+	}
+	explicit operator bool() const { return Object != NULL; }
+
+private:
+	PyObject* Object = NULL;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <Python.h> // Must be first
+#include "PythonExecutor.h"
+#include "PyUtils.h"
+#include <exception>
+
+PythonExecutor::PythonExecutor() {
+	Worker = std::thread([this]() { Work(); });
+}
+
+PythonExecutor::~PythonExecutor() {
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Stop = true;
+		Jobs.clear();
+	}
+	Wake.notify_all();
+	Interrupt();
+	if (Finished.get_future().wait_for(StopTimeout) == std::future_status::ready) { Worker.join(); }
+	else { Worker.detach(); }
+}
+
+void PythonExecutor::Post(std::function<void()> Job) {
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Jobs.push_back(std::move(Job));
+	}
+	Wake.notify_one();
+}
+
+void PythonExecutor::SetIdle(std::function<void()> Idle, std::chrono::milliseconds Interval) {
+	std::lock_guard<std::mutex> Lock(Mutex);
+	this->Idle = std::move(Idle);
+	IdleInterval = Interval;
+}
+
+void PythonExecutor::SetLast(std::function<void()> Last) {
+	std::lock_guard<std::mutex> Lock(Mutex);
+	this->Last = std::move(Last);
+}
+
+void PythonExecutor::Interrupt() {
+	PyLock Lock;
+	if (Running) { PyThreadState_SetAsyncExc(PythonThread, PyExc_KeyboardInterrupt); }
+}
+
+void PythonExecutor::Work() {
+	PyLock Gil;
+	PythonThread = PyThread_get_thread_ident();
+	PyThreadState* State = PyEval_SaveThread();
+	while (true) {
+		std::function<void()> Job;
+		bool Queued = false;
+		{
+			std::unique_lock<std::mutex> Queue(Mutex);
+			auto Ready = [this]() { return Stop or not Jobs.empty(); };
+			if (Idle) { Wake.wait_for(Queue, IdleInterval, Ready); }
+			else { Wake.wait(Queue, Ready); }
+			if (Stop) { break; }
+			Queued = not Jobs.empty();
+			if (Queued) {
+				Job = std::move(Jobs.front());
+				Jobs.pop_front();
+			}
+			else { Job = Idle; }
+		}
+
+		PyEval_RestoreThread(State);
+		Running = Queued;
+		try {
+			Job();
+		}
+		catch (const std::exception& e) {
+			PySys_WriteStderr("%.900s\n", e.what());
+		}
+		Running = false;
+		// An interrupt which came after the last Python line of the job is dropped:
+		PyThreadState_SetAsyncExc(PythonThread, NULL);
+		State = PyEval_SaveThread();
+	}
+	PyEval_RestoreThread(State);
+	try {
+		if (Last) { Last(); }
+	}
+	catch (const std::exception& e) {
+		PySys_WriteStderr("%.900s\n", e.what());
+	}
+	Finished.set_value();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <future>
+
+// Thread running Python jobs (fitting and drawing the plot) one after another, so the GUI thread
+// stays responsive meanwhile. matplotlib figures are only created and shown on this thread. The
+// thread keeps one Python thread state, the GIL is held while a job runs and released between
+// jobs. Python releases it during a job too, every few milliseconds.
+class PythonExecutor {
+public:
+	PythonExecutor();
+	// Drops the queued jobs, interrupts the running one and waits until it returned, at most
+	// StopTimeout. A job stuck in C code is left running then, as the app is ending anyway.
+	~PythonExecutor();
+	PythonExecutor(const PythonExecutor&) = delete;
+	PythonExecutor& operator=(const PythonExecutor&) = delete;
+
+	// Queue Job, it is called with the GIL held. Results go back to the GUI with wxQueueEvent.
+	void Post(std::function<void()> Job);
+	// Raise KeyboardInterrupt in the Python code of the running job, it takes effect at the
+	// next Python line (not inside long C calls):
+	void Interrupt();
+	// Called with the GIL every Interval while no job is queued (e.g. to process the window
+	// events of open figures) and once before the thread ends. Set them before the first Post:
+	void SetIdle(std::function<void()> Idle, std::chrono::milliseconds Interval);
+	void SetLast(std::function<void()> Last);
+
+	static constexpr std::chrono::seconds StopTimeout{ 5 };
+
+private:
+	void Work();
+
+	std::thread Worker;
+	std::mutex Mutex;
+	std::condition_variable Wake;
+	std::deque<std::function<void()>> Jobs;
+	std::function<void()> Idle;
+	std::function<void()> Last;
+	std::chrono::milliseconds IdleInterval{ 0 };
+	std::promise<void> Finished;
+	bool Stop = false;
+	// Changed with the GIL held only, so Interrupt cannot hit the next job:
+	std::atomic<bool> Running = false;
+	std::atomic<unsigned long> PythonThread = 0;
+};
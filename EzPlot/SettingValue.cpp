@@ -0,0 +1,163 @@
+#include "SettingValue.h"
+#include "PyUtils.h"
+#include <cwchar>
+#include <algorithm>
+#include <type_traits>
+
+namespace {
+
+PyObject* ToPy(std::monostate) {
+	Py_RETURN_NONE;
+}
+
+PyObject* ToPy(bool Value) {
+	return PyBool_FromLong(Value);
+}
+
+PyObject* ToPy(int Value) {
+	return PyLong_FromLong(Value);
+}
+
+PyObject* ToPy(long Value) {
+	return PyLong_FromLong(Value);
+}
+
+PyObject* ToPy(double Value) {
+	return PyFloat_FromDouble(Value);
+}
+
+PyObject* ToPy(const std::string& Value) {
+	return PyUnicode_DecodeRawUnicodeEscape(Value.c_str(), Value.size(), "error");
+}
+
+PyObject* ToPy(const std::wstring& Value) {
+	return PyUnicode_FromWideChar(Value.c_str(), wcslen(Value.c_str()));
+}
+
+PyObject* ToPy(const NumericArray& Value) {
+	if (!Value) { Py_RETURN_NONE; }
+	return vectorToArray_Double(Value);
+}
+
+PyObject* ToPy(const SettingValue& Value) {
+	return SettingToPy(Value);
+}
+
+// Declared before they are defined, so nested containers find each other:
+template <typename T>
+PyObject* ToPy(const std::optional<T>& Value);
+template <typename... T>
+PyObject* ToPy(const std::tuple<T...>& Value);
+template <typename T>
+PyObject* ToPy(const std::vector<T>& Value);
+template <typename K, typename V>
+PyObject* ToPy(const std::unordered_map<K, V>& Value);
+
+template <typename T>
+PyObject* ToPy(const std::optional<T>& Value) {
+	if (not Value) { Py_RETURN_NONE; }
+	return ToPy(*Value);
+}
+
+// Steals Item, false if its conversion failed:
+bool SetTupleItem(PyObject* Tuple, Py_ssize_t i, PyObject* Item) {
+	if (!Item) { return false; }
+	PyTuple_SET_ITEM(Tuple, i, Item);
+	return true;
+}
+
+template <typename... T>
+PyObject* ToPy(const std::tuple<T...>& Value) {
+	PyObject* Tuple = PyTuple_New(sizeof...(T));
+	if (!Tuple) { return NULL; }
+	bool Converted = std::apply([Tuple](const T&... Items) {
+		Py_ssize_t i = 0;
+		return (SetTupleItem(Tuple, i++, ToPy(Items)) and ...);
+	}, Value);
+	if (not Converted) {
+		Py_DECREF(Tuple);
+		return NULL;
+	}
+	return Tuple;
+}
+
+template <typename T>
+PyObject* ToPy(const std::vector<T>& Value) {
+	PyObject* List = PyList_New(Value.size());
+	if (!List) { return NULL; }
+	for (std::size_t i = 0; i < Value.size(); i++) {
+		// Bound to a const reference, std::vector<bool> hands out proxies
+		const T& Item = Value[i];
+		PyObject* PyItem = ToPy(Item);
+		if (!PyItem) {
+			Py_DECREF(List);
+			return NULL;
+		}
+		PyList_SET_ITEM(List, i, PyItem);
+	}
+	return List;
+}
+
+template <typename K, typename V>
+PyObject* ToPy(const std::unordered_map<K, V>& Value) {
+	PyObject* Dict = PyDict_New();
+	if (!Dict) { return NULL; }
+	for (const auto& [Key, Item] : Value) {
+		PyObject* PyKey = ToPy(Key);
+		PyObject* PyItem = PyKey ? ToPy(Item) : NULL;
+		bool Set = PyItem and PyDict_SetItem(Dict, PyKey, PyItem) == 0;
+		Py_XDECREF(PyKey);
+		Py_XDECREF(PyItem);
+		if (not Set) {
+			Py_DECREF(Dict);
+			return NULL;
+		}
+	}
+	return Dict;
+}
+
+template <typename T>
+struct IsVector : std::false_type {};
+template <typename T>
+struct IsVector<std::vector<T>> : std::true_type {};
+
+}
+
+PyObject* SettingToPy(const SettingValue& Value) {
+	return std::visit([](const auto& Alternative) { return ToPy(Alternative); }, Value);
+}
+
+PyObject* SettingsToPy(const SettingsMap& Settings) {
+	return ToPy(Settings);
+}
+
+std::vector<std::string> ChangedSettings(const SettingsMap& Old, const SettingsMap& New) {
+	std::vector<std::string> Changed;
+	for (const auto& [Key, Value] : New) {
+		auto Found = Old.find(Key);
+		if (Found == Old.end() or Found->second != Value) { Changed.push_back(Key); }
+	}
+	for (const auto& [Key, Value] : Old) {
+		if (not New.contains(Key)) { Changed.push_back(Key); }
+	}
+	return Changed;
+}
+
+std::optional<std::vector<std::size_t>> ChangedItems(const SettingValue& Old, const SettingValue& New) {
+	if (Old.index() != New.index()) { return std::nullopt; }
+	return std::visit([&New](const auto& OldValue) -> std::optional<std::vector<std::size_t>> {
+		using T = std::decay_t<decltype(OldValue)>;
+		const T& NewValue = std::get<T>(New);
+		if constexpr (IsVector<T>::value) {
+			std::vector<std::size_t> Changed;
+			for (std::size_t i = 0; i < std::max(OldValue.size(), NewValue.size()); i++) {
+				if (i >= OldValue.size() or i >= NewValue.size() or OldValue[i] != NewValue[i]) { Changed.push_back(i); }
+			}
+			return Changed;
+		}
+		else {
+			if (OldValue == NewValue) { return std::vector<std::size_t>(); }
+			return std::nullopt;
+		}
+	}, Old);
+}
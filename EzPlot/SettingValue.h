@@ -0,0 +1,55 @@
+#pragma once
+#include <Python.h>
+#include <variant>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <optional>
+#include <unordered_map>
+#include <memory>
+#include <cstddef>
+
+// Bulk numbers like data columns, passed as read-only numpy array which shares the values
+// instead of a list with one float object per value:
+using NumericArray = std::shared_ptr<const std::vector<double>>;
+
+// Value of an entry of the data infos, plot and fit settings handed to Python. Every type stored
+// in the settings maps is listed here, storing another type does not compile. std::monostate
+// is passed as None.
+using SettingValue = std::variant<
+	std::monostate,
+	bool,
+	int,
+	long,
+	double,
+	std::string,
+	std::wstring,
+	std::tuple<double, double>,
+	NumericArray,
+	std::vector<bool>,
+	std::vector<long>,
+	std::vector<double>,
+	std::vector<std::string>,
+	std::vector<std::wstring>,
+	std::vector<std::tuple<double, double>>,
+	std::vector<std::tuple<std::optional<double>, std::optional<double>>>,
+	std::vector<std::tuple<std::string, std::string>>,
+	std::vector<std::vector<double>>,
+	std::vector<std::vector<std::tuple<double, double>>>,
+	std::vector<std::vector<std::vector<double>>>,
+	std::unordered_map<std::wstring, std::wstring>,
+	std::unordered_map<std::wstring, std::vector<std::wstring>>>;
+
+using SettingsMap = std::unordered_map<std::string, SettingValue>;
+
+// New references to the matching Python objects (vectors become lists, tuples tuples, maps
+// dicts and NumericArray numpy arrays), NULL with the Python error set if a conversion failed.
+// Needs the GIL.
+PyObject* SettingToPy(const SettingValue& Value);
+PyObject* SettingsToPy(const SettingsMap& Settings);
+
+// Keys whose value differs between Old and New, also the keys only one of them has
+std::vector<std::string> ChangedSettings(const SettingsMap& Old, const SettingsMap& New);
+// Indices of the items which differ if Old and New are lists of the same type, items only the
+// longer list has count as changed. Empty if the values are equal, nullopt if they differ otherwise.
+std::optional<std::vector<std::size_t>> ChangedItems(const SettingValue& Old, const SettingValue& New);
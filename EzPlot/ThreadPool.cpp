@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+#include <exception>
+#include <memory>
+
+namespace {
+
+	// State of one ParallelFor call, shared with its tasks which may outlive the wait by a moment
+	struct Batch {
+		std::atomic<std::size_t> Remaining;
+		std::mutex Mutex;
+		std::condition_variable Done;
+		std::exception_ptr Error;
+	};
+
+}
+
+ThreadPool::ThreadPool(unsigned Threads) : Queues(Threads > 0 ? Threads : 1) {
+	for (std::size_t i = 0; i < Queues.size(); i++) {
+		Workers.emplace_back([this, i]() { Work(i); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Stop = true;
+	}
+	Wake.notify_all();
+	for (std::thread& Worker : Workers) {
+		Worker.join();
+	}
+}
+
+ThreadPool& ThreadPool::Shared() {
+	static ThreadPool Pool;
+	return Pool;
+}
+
+bool ThreadPool::RunOne(std::size_t First) {
+	for (std::size_t k = 0; k < Queues.size(); k++) {
+		Queue& Tasks = Queues[(First + k) % Queues.size()];
+		std::function<void()> Task;
+		{
+			std::lock_guard<std::mutex> Lock(Tasks.Mutex);
+			if (Tasks.Tasks.empty()) { continue; }
+			if (k == 0) {
+				Task = std::move(Tasks.Tasks.front());
+				Tasks.Tasks.pop_front();
+			}
+			else {
+				Task = std::move(Tasks.Tasks.back());
+				Tasks.Tasks.pop_back();
+			}
+		}
+		Pending--;
+		Task();
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::Work(std::size_t Index) {
+	while (true) {
+		if (RunOne(Index)) { continue; }
+		std::unique_lock<std::mutex> Lock(Mutex);
+		Wake.wait(Lock, [this]() { return Stop or Pending > 0; });
+		if (Stop and Pending <= 0) { return; }
+	}
+}
+
+void ThreadPool::ParallelFor(std::size_t Count, const std::function<void(std::size_t)>& Function) {
+	if (Count == 0) { return; }
+	if (Count == 1) {
+		Function(0);
+		return;
+	}
+
+	std::shared_ptr<Batch> State = std::make_shared<Batch>();
+	State->Remaining = Count;
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Pending += Count;
+	}
+	for (std::size_t i = 0; i < Count; i++) {
+		Queue& Tasks = Queues[i % Queues.size()];
+		std::lock_guard<std::mutex> Lock(Tasks.Mutex);
+		Tasks.Tasks.emplace_back([State, &Function, i]() {
+			try {
+				Function(i);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> Lock(State->Mutex);
+				if (not State->Error) { State->Error = std::current_exception(); }
+			}
+			if (--State->Remaining == 0) {
+				std::lock_guard<std::mutex> Lock(State->Mutex);
+				State->Done.notify_all();
+			}
+		});
+	}
+	Wake.notify_all();
+
+	// Help instead of only waiting:
+	while (State->Remaining > 0) {
+		if (RunOne(0)) { continue; }
+		std::unique_lock<std::mutex> Lock(State->Mutex);
+		State->Done.wait(Lock, [&State]() { return State->Remaining == 0; });
+	}
+	if (State->Error) { std::rethrow_exception(State->Error); }
+}
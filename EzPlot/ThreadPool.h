@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+
+// Work-stealing thread pool. Every worker takes tasks from the front of its own queue and
+// steals from the back of the other queues when it runs dry.
+class ThreadPool {
+public:
+	explicit ThreadPool(unsigned Threads = std::thread::hardware_concurrency());
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Call Function(0) ... Function(Count - 1) in parallel and wait until all calls returned.
+	// The calling thread helps with the work, the first exception thrown is rethrown here.
+	void ParallelFor(std::size_t Count, const std::function<void(std::size_t)>& Function);
+
+	unsigned Size() const { return static_cast<unsigned>(Queues.size()); }
+
+	// Pool shared by the data readers, created on first use
+	static ThreadPool& Shared();
+
+private:
+	struct Queue {
+		std::mutex Mutex;
+		std::deque<std::function<void()>> Tasks;
+	};
+
+	bool RunOne(std::size_t First);
+	void Work(std::size_t Index);
+
+	std::vector<Queue> Queues;
+	std::vector<std::thread> Workers;
+	std::atomic<long long> Pending = 0;
+	std::mutex Mutex;
+	std::condition_variable Wake;
+	bool Stop = false;
+};
@@ -0,0 +1,622 @@
+#include "XLSXReader.h"
+#include "LoadProgress.h"
+#include <zlib.h>
+#include <cstring>
+#include <cmath>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+
+namespace {
+
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	const std::size_t BlockSize = 1 << 20; // Inflate 1 MiB at once
+
+	std::uint64_t ReadLE(const char* Pos, int Bytes) {
+		std::uint64_t Value = 0;
+		for (int i = Bytes - 1; i >= 0; i--) {
+			Value = (Value << 8) | static_cast<unsigned char>(Pos[i]);
+		}
+		return Value;
+	}
+
+	// XML helpers, the sheet parts are simple enough to be scanned without a full XML parser:
+
+	std::string_view LocalName(std::string_view Name) {
+		std::size_t Colon = Name.find(':');
+		return Colon == std::string_view::npos ? Name : Name.substr(Colon + 1);
+	}
+
+	// Name of the tag between "<" and ">" without namespace prefix and "/":
+	std::string_view TagName(std::string_view Tag) {
+		if (not Tag.empty() and Tag[0] == '/') { Tag.remove_prefix(1); }
+		std::size_t End = Tag.find_first_of(" \t\r\n/");
+		return LocalName(Tag.substr(0, End));
+	}
+
+	std::string_view Attribute(std::string_view Tag, std::string_view Name) {
+		std::size_t Pos = 0;
+		while ((Pos = Tag.find(Name, Pos)) != std::string_view::npos) {
+			std::size_t After = Pos + Name.size();
+			bool Start = Pos > 0 and (Tag[Pos - 1] == ' ' or Tag[Pos - 1] == '\t' or Tag[Pos - 1] == '\n' or Tag[Pos - 1] == '\r');
+			if (Start and After + 1 < Tag.size() and Tag[After] == '=' and (Tag[After + 1] == '"' or Tag[After + 1] == '\'')) {
+				std::size_t Close = Tag.find(Tag[After + 1], After + 2);
+				if (Close == std::string_view::npos) { break; }
+				return Tag.substr(After + 2, Close - After - 2);
+			}
+			Pos = After;
+		}
+		return {};
+	}
+
+	std::string DecodeEntities(std::string_view Text) {
+		std::string Result;
+		Result.reserve(Text.size());
+		for (std::size_t i = 0; i < Text.size(); i++) {
+			std::size_t Semicolon;
+			if (Text[i] != '&' or (Semicolon = Text.find(';', i)) == std::string_view::npos) {
+				Result.push_back(Text[i]);
+				continue;
+			}
+			std::string_view Entity = Text.substr(i + 1, Semicolon - i - 1);
+			if (Entity == "amp") { Result.push_back('&'); }
+			else if (Entity == "lt") { Result.push_back('<'); }
+			else if (Entity == "gt") { Result.push_back('>'); }
+			else if (Entity == "quot") { Result.push_back('"'); }
+			else if (Entity == "apos") { Result.push_back('\''); }
+			else if (Entity.size() > 1 and Entity[0] == '#') {
+				unsigned long Code = 0;
+				bool Hex = Entity[1] == 'x';
+				std::from_chars(Entity.data() + (Hex ? 2 : 1), Entity.data() + Entity.size(), Code, Hex ? 16 : 10);
+				// UTF-8 encoding of the code point:
+				if (Code < 0x80) { Result.push_back(static_cast<char>(Code)); }
+				else if (Code < 0x800) {
+					Result.push_back(static_cast<char>(0xC0 | (Code >> 6)));
+					Result.push_back(static_cast<char>(0x80 | (Code & 0x3F)));
+				}
+				else if (Code < 0x10000) {
+					Result.push_back(static_cast<char>(0xE0 | (Code >> 12)));
+					Result.push_back(static_cast<char>(0x80 | ((Code >> 6) & 0x3F)));
+					Result.push_back(static_cast<char>(0x80 | (Code & 0x3F)));
+				}
+				else {
+					Result.push_back(static_cast<char>(0xF0 | (Code >> 18)));
+					Result.push_back(static_cast<char>(0x80 | ((Code >> 12) & 0x3F)));
+					Result.push_back(static_cast<char>(0x80 | ((Code >> 6) & 0x3F)));
+					Result.push_back(static_cast<char>(0x80 | (Code & 0x3F)));
+				}
+			}
+			else {
+				Result.append(Text.substr(i, Semicolon - i + 1));
+			}
+			i = Semicolon;
+		}
+		return Result;
+	}
+
+	// End of the element whose start tag ends at Pos (behind the closing tag), nullptr if
+	// the closing tag is not in [Pos, End) yet:
+	const char* FindElementEnd(const char* Pos, const char* End, std::string_view Name) {
+		while (true) {
+			const char* Close = static_cast<const char*>(std::memchr(Pos, '<', End - Pos));
+			if (Close == nullptr or Close + 1 >= End) { return nullptr; }
+			const char* Gt = static_cast<const char*>(std::memchr(Close, '>', End - Close));
+			if (Gt == nullptr) { return nullptr; }
+			if (Close[1] == '/' and TagName(std::string_view(Close + 1, Gt - Close - 1)) == Name) { return Gt + 1; }
+			Pos = Gt + 1;
+		}
+	}
+
+	// Text of all <Name> elements inside of [Begin, End), Skip elements (like phonetic runs) are left out:
+	std::string InnerText(const char* Begin, const char* End, std::string_view Name, std::string_view Skip = {}) {
+		std::string Text;
+		const char* Pos = Begin;
+		while (true) {
+			const char* Lt = static_cast<const char*>(std::memchr(Pos, '<', End - Pos));
+			if (Lt == nullptr) { break; }
+			const char* Gt = static_cast<const char*>(std::memchr(Lt, '>', End - Lt));
+			if (Gt == nullptr) { break; }
+			std::string_view Tag(Lt + 1, Gt - Lt - 1);
+			std::string_view TagLocal = TagName(Tag);
+			Pos = Gt + 1;
+			if (Tag.empty() or Tag[0] == '/' or Tag.back() == '/') { continue; }
+			if (not Skip.empty() and TagLocal == Skip) {
+				const char* SkipEnd = FindElementEnd(Pos, End, Skip);
+				Pos = SkipEnd ? SkipEnd : End;
+				continue;
+			}
+			if (TagLocal != Name) { continue; }
+			const char* TextEnd = static_cast<const char*>(std::memchr(Pos, '<', End - Pos));
+			if (TextEnd == nullptr) { TextEnd = End; }
+			Text += DecodeEntities(std::string_view(Pos, TextEnd - Pos));
+			Pos = TextEnd;
+		}
+		return Text;
+	}
+
+	// Zero based column and row of a cell reference like "AB12":
+	void CellReference(std::string_view Reference, std::size_t& Column, std::size_t& Row) {
+		std::size_t i = 0;
+		Column = 0;
+		for (; i < Reference.size() and Reference[i] >= 'A' and Reference[i] <= 'Z'; i++) {
+			Column = Column * 26 + (Reference[i] - 'A' + 1);
+		}
+		Column--;
+		Row = 0;
+		std::from_chars(Reference.data() + i, Reference.data() + Reference.size(), Row);
+		Row--;
+	}
+
+	// Number formats which openpyxl converts to dates (built in ids and codes with date/time letters):
+	bool IsDateFormat(int Id, const std::string& Code) {
+		if ((Id >= 14 and Id <= 22) or (Id >= 27 and Id <= 36) or (Id >= 45 and Id <= 47) or (Id >= 50 and Id <= 58)) {
+			return true;
+		}
+		bool Quoted = false;
+		bool Bracket = false;
+		for (std::size_t i = 0; i < Code.size(); i++) {
+			char c = Code[i];
+			if (c == '"') { Quoted = not Quoted; }
+			else if (Quoted) { continue; }
+			else if (c == '\\' or c == '_' or c == '*') { i++; }
+			else if (c == '[') { Bracket = true; }
+			else if (c == ']') { Bracket = false; }
+			else if (not Bracket and std::strchr("dmyhsDMYHS", c) != nullptr) { return true; }
+		}
+		return false;
+	}
+
+	// Streams a worksheet and hands every cell to OnCell(Row, Column, Type, Style, Begin, End)
+	// with the content of the cell element. OnRowEnd(Row) returns false to stop the stream.
+	template <typename CellCallback, typename RowCallback>
+	class SheetScanner {
+	public:
+		SheetScanner(CellCallback& OnCell, RowCallback& OnRowEnd) : OnCell(OnCell), OnRowEnd(OnRowEnd) {}
+
+		bool Feed(const char* Data, std::size_t Size) {
+			Pending.append(Data, Size);
+			const char* Begin = Pending.data();
+			const char* End = Begin + Pending.size();
+			const char* Pos = Begin;
+			bool Continue = true;
+			while (Continue) {
+				const char* Lt = static_cast<const char*>(std::memchr(Pos, '<', End - Pos));
+				if (Lt == nullptr) {
+					Pos = End;
+					break;
+				}
+				const char* Gt = static_cast<const char*>(std::memchr(Lt, '>', End - Lt));
+				if (Gt == nullptr) {
+					Pos = Lt;
+					break;
+				}
+				std::string_view Tag(Lt + 1, Gt - Lt - 1);
+				std::string_view Name = TagName(Tag);
+				bool Closing = not Tag.empty() and Tag[0] == '/';
+				bool Empty = not Tag.empty() and Tag.back() == '/';
+
+				if (Name == "c" and not Closing) {
+					const char* CellEnd = Empty ? Gt + 1 : FindElementEnd(Gt + 1, End, "c");
+					if (CellEnd == nullptr) {
+						Pos = Lt;
+						break;
+					}
+					std::string_view Reference = Attribute(Tag, "r");
+					std::size_t Row = CurrentRow;
+					if (not Reference.empty()) { CellReference(Reference, Column, Row); }
+					std::string_view Type = Attribute(Tag, "t");
+					std::size_t Style = 0;
+					std::string_view StyleText = Attribute(Tag, "s");
+					std::from_chars(StyleText.data(), StyleText.data() + StyleText.size(), Style);
+					if (not Empty) {
+						OnCell(Row, Column, Type.empty() ? std::string_view("n") : Type, Style, Gt + 1, CellEnd);
+					}
+					Column++;
+					Pos = CellEnd;
+					continue;
+				}
+				if (Name == "row") {
+					if (not Closing) {
+						std::string_view Number = Attribute(Tag, "r");
+						std::size_t Row = 0;
+						if (not Number.empty() and std::from_chars(Number.data(), Number.data() + Number.size(), Row).ec == std::errc()) {
+							CurrentRow = Row - 1;
+						}
+						else {
+							CurrentRow++;
+						}
+						Column = 0;
+					}
+					if (Closing or Empty) { Continue = OnRowEnd(CurrentRow); }
+				}
+				else if (Name == "sheetData" and Closing) {
+					Continue = false;
+				}
+				Pos = Gt + 1;
+			}
+			Pending.erase(0, Pos - Begin);
+			return Continue;
+		}
+
+	private:
+		CellCallback& OnCell;
+		RowCallback& OnRowEnd;
+		std::string Pending;
+		std::size_t CurrentRow = static_cast<std::size_t>(-1);
+		std::size_t Column = 0;
+	};
+
+	// Text of a number cell like pandas names such a column ("3.0" -> "3"):
+	std::string NumberText(std::string_view Text) {
+		double Value;
+		auto [Ptr, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+		if (Error != std::errc() or Ptr != Text.data() + Text.size()) { return std::string(Text); }
+		char Buffer[64];
+		std::to_chars_result Result = std::floor(Value) == Value and std::abs(Value) < 1e300
+			? std::to_chars(Buffer, Buffer + sizeof(Buffer), Value, std::chars_format::fixed, 0)
+			: std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+		return std::string(Buffer, Result.ptr);
+	}
+
+}
+
+// ===========
+// ZIP ARCHIVE
+// ===========
+
+ZipArchive::ZipArchive(const std::filesystem::path& Path) : File(Path) {
+	const char* Data = File.Data();
+	std::size_t Size = File.Size();
+
+	// End of central directory record, followed by a comment of up to 64 KiB:
+	std::size_t Record = std::string::npos;
+	for (std::size_t Pos = Size >= 22 ? Size - 22 : 0; Size >= 22; Pos--) {
+		if (std::memcmp(Data + Pos, "PK\x05\x06", 4) == 0) {
+			Record = Pos;
+			break;
+		}
+		if (Pos == 0 or Size - Pos > 22 + 0xFFFF) { break; }
+	}
+	if (Record == std::string::npos) {
+		throw std::runtime_error("Data file is no xlsx workbook");
+	}
+	std::uint64_t Count = ReadLE(Data + Record + 10, 2);
+	std::uint64_t Directory = ReadLE(Data + Record + 16, 4);
+	if ((Count == 0xFFFF or Directory == 0xFFFFFFFF) and Record >= 20
+		and std::memcmp(Data + Record - 20, "PK\x06\x07", 4) == 0) {
+		std::uint64_t Record64 = ReadLE(Data + Record - 20 + 8, 8);
+		if (Record64 + 56 > Size) { throw std::runtime_error("Damaged xlsx workbook"); }
+		Count = ReadLE(Data + Record64 + 32, 8);
+		Directory = ReadLE(Data + Record64 + 48, 8);
+	}
+
+	std::uint64_t Pos = Directory;
+	for (std::uint64_t i = 0; i < Count; i++) {
+		if (Pos + 46 > Size or std::memcmp(Data + Pos, "PK\x01\x02", 4) != 0) {
+			throw std::runtime_error("Damaged xlsx workbook");
+		}
+		Entry Item;
+		Item.Method = static_cast<std::uint16_t>(ReadLE(Data + Pos + 10, 2));
+		Item.CompressedSize = ReadLE(Data + Pos + 20, 4);
+		Item.Size = ReadLE(Data + Pos + 24, 4);
+		std::size_t NameLength = ReadLE(Data + Pos + 28, 2);
+		std::size_t ExtraLength = ReadLE(Data + Pos + 30, 2);
+		std::size_t CommentLength = ReadLE(Data + Pos + 32, 2);
+		Item.Offset = ReadLE(Data + Pos + 42, 4);
+		Item.Name.assign(Data + Pos + 46, NameLength);
+
+		// Zip64 extra field with the sizes which did not fit:
+		const char* Extra = Data + Pos + 46 + NameLength;
+		for (std::size_t e = 0; e + 4 <= ExtraLength;) {
+			std::uint64_t Id = ReadLE(Extra + e, 2);
+			std::size_t Length = ReadLE(Extra + e + 2, 2);
+			if (Id == 1) {
+				const char* Field = Extra + e + 4;
+				if (Item.Size == 0xFFFFFFFF) {
+					Item.Size = ReadLE(Field, 8);
+					Field += 8;
+				}
+				if (Item.CompressedSize == 0xFFFFFFFF) {
+					Item.CompressedSize = ReadLE(Field, 8);
+					Field += 8;
+				}
+				if (Item.Offset == 0xFFFFFFFF) { Item.Offset = ReadLE(Field, 8); }
+			}
+			e += 4 + Length;
+		}
+		Entries.push_back(std::move(Item));
+		Pos += 46 + NameLength + ExtraLength + CommentLength;
+	}
+}
+
+bool ZipArchive::Contains(const std::string& Name) const {
+	return std::any_of(Entries.begin(), Entries.end(), [&](const Entry& Item) { return Item.Name == Name; });
+}
+
+std::uint64_t ZipArchive::Size(const std::string& Name) const {
+	return Find(Name).Size;
+}
+
+const ZipArchive::Entry& ZipArchive::Find(const std::string& Name) const {
+	for (const Entry& Item : Entries) {
+		if (Item.Name == Name) { return Item; }
+	}
+	throw std::runtime_error("Missing part in xlsx workbook: " + Name);
+}
+
+void ZipArchive::Stream(const std::string& Name, const std::function<bool(const char*, std::size_t)>& Consume) const {
+	const Entry& Item = Find(Name);
+	const char* Local = File.Data() + Item.Offset;
+	if (Item.Offset + 30 > File.Size() or std::memcmp(Local, "PK\x03\x04", 4) != 0) {
+		throw std::runtime_error("Damaged xlsx workbook");
+	}
+	std::uint64_t Start = Item.Offset + 30 + ReadLE(Local + 26, 2) + ReadLE(Local + 28, 2);
+	if (Start + Item.CompressedSize > File.Size()) {
+		throw std::runtime_error("Damaged xlsx workbook");
+	}
+	const char* Data = File.Data() + Start;
+
+	if (Item.Method == 0) {
+		for (std::uint64_t Pos = 0; Pos < Item.CompressedSize; Pos += BlockSize) {
+			std::size_t Length = static_cast<std::size_t>(std::min<std::uint64_t>(BlockSize, Item.CompressedSize - Pos));
+			if (not Consume(Data + Pos, Length)) { return; }
+		}
+		return;
+	}
+	if (Item.Method != 8) {
+		throw std::runtime_error("Unsupported compression in xlsx workbook");
+	}
+
+	z_stream Stream = {};
+	if (inflateInit2(&Stream, -MAX_WBITS) != Z_OK) {
+		throw std::runtime_error("Unable to inflate xlsx workbook");
+	}
+	std::vector<char> Block(BlockSize);
+	std::uint64_t Remaining = Item.CompressedSize;
+	int Status = Z_OK;
+	while (Status != Z_STREAM_END) {
+		if (Stream.avail_in == 0 and Remaining > 0) {
+			uInt Length = static_cast<uInt>(std::min<std::uint64_t>(Remaining, 1u << 30));
+			Stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(Data + (Item.CompressedSize - Remaining)));
+			Stream.avail_in = Length;
+			Remaining -= Length;
+		}
+		Stream.next_out = reinterpret_cast<Bytef*>(Block.data());
+		Stream.avail_out = static_cast<uInt>(Block.size());
+		Status = inflate(&Stream, Z_NO_FLUSH);
+		if (Status != Z_OK and Status != Z_STREAM_END) {
+			inflateEnd(&Stream);
+			throw std::runtime_error("Damaged xlsx workbook");
+		}
+		std::size_t Produced = Block.size() - Stream.avail_out;
+		if (Produced > 0 and not Consume(Block.data(), Produced)) { break; }
+		if (Produced == 0 and Stream.avail_in == 0 and Remaining == 0 and Status != Z_STREAM_END) {
+			inflateEnd(&Stream);
+			throw std::runtime_error("Damaged xlsx workbook");
+		}
+	}
+	inflateEnd(&Stream);
+}
+
+std::string ZipArchive::Read(const std::string& Name) const {
+	std::string Content;
+	Stream(Name, [&](const char* Data, std::size_t Size) {
+		Content.append(Data, Size);
+		return true;
+	});
+	return Content;
+}
+
+// ===========
+// XLSX SOURCE
+// ===========
+
+XLSXSource::XLSXSource(const std::filesystem::path& Path) : Archive(Path) {
+	// First worksheet in workbook order:
+	std::string Workbook = Archive.Read("xl/workbook.xml");
+	std::string Relations = Archive.Read("xl/_rels/workbook.xml.rels");
+	std::string Id;
+	for (std::size_t Pos = 0; (Pos = Workbook.find('<', Pos)) != std::string::npos; Pos++) {
+		std::size_t Gt = Workbook.find('>', Pos);
+		std::string_view Tag(Workbook.data() + Pos + 1, Gt - Pos - 1);
+		if (TagName(Tag) == "sheet" and Tag[0] != '/') {
+			// Relationship id attribute has a namespace prefix (mostly "r:id"):
+			std::size_t Quote = Tag.find(":id=");
+			if (Quote != std::string_view::npos and Quote + 5 < Tag.size()) {
+				Quote += 4;
+				Id = std::string(Tag.substr(Quote + 1, Tag.find(Tag[Quote], Quote + 1) - Quote - 1));
+			}
+			break;
+		}
+	}
+	for (std::size_t Pos = 0; (Pos = Relations.find('<', Pos)) != std::string::npos; Pos++) {
+		std::size_t Gt = Relations.find('>', Pos);
+		std::string_view Tag(Relations.data() + Pos + 1, Gt - Pos - 1);
+		if (TagName(Tag) == "Relationship" and Attribute(Tag, "Id") == Id) {
+			std::string Target(Attribute(Tag, "Target"));
+			SheetPath = Target[0] == '/' ? Target.substr(1) : "xl/" + Target;
+			break;
+		}
+	}
+	if (SheetPath.empty()) {
+		throw std::runtime_error("No worksheet in xlsx workbook");
+	}
+	ReadStyles();
+	ReadHeader();
+}
+
+void XLSXSource::ReadStyles() {
+	if (not Archive.Contains("xl/styles.xml")) { return; }
+	std::string Styles = Archive.Read("xl/styles.xml");
+	std::unordered_map<int, std::string> Formats;
+	bool CellFormats = false;
+	for (std::size_t Pos = 0; (Pos = Styles.find('<', Pos)) != std::string::npos; Pos++) {
+		std::size_t Gt = Styles.find('>', Pos);
+		if (Gt == std::string::npos) { break; }
+		std::string_view Tag(Styles.data() + Pos + 1, Gt - Pos - 1);
+		std::string_view Name = TagName(Tag);
+		int Id = 0;
+		std::string_view IdText = Attribute(Tag, "numFmtId");
+		std::from_chars(IdText.data(), IdText.data() + IdText.size(), Id);
+		if (Name == "numFmt") {
+			Formats[Id] = DecodeEntities(Attribute(Tag, "formatCode"));
+		}
+		else if (Name == "cellXfs") {
+			CellFormats = Tag[0] != '/' and Tag.back() != '/';
+		}
+		else if (Name == "xf" and CellFormats and Tag[0] != '/') {
+			DateStyles.push_back(IsDateFormat(Id, Formats[Id]));
+		}
+	}
+}
+
+void XLSXSource::ReadHeader() {
+	struct Cell {
+		std::size_t Column;
+		std::string Type;
+		std::string Text;
+	};
+	std::vector<Cell> Cells;
+	auto OnCell = [&](std::size_t Row, std::size_t Column, std::string_view Type, std::size_t, const char* Begin, const char* End) {
+		std::string Text = Type == "inlineStr" ? InnerText(Begin, End, "t", "rPh") : InnerText(Begin, End, "v");
+		if (Text.empty() and Type != "inlineStr") { return; }
+		if (Cells.empty()) { HeaderRow = Row; }
+		Cells.push_back({ Column, std::string(Type), Text });
+	};
+	auto OnRowEnd = [&](std::size_t) { return Cells.empty(); };
+	SheetScanner<decltype(OnCell), decltype(OnRowEnd)> Scanner(OnCell, OnRowEnd);
+	Archive.Stream(SheetPath, [&](const char* Data, std::size_t Size) { return Scanner.Feed(Data, Size); });
+
+	// Shared strings of the header only:
+	std::vector<std::size_t> Indices;
+	for (const Cell& Item : Cells) {
+		if (Item.Type == "s") { Indices.push_back(std::stoul(Item.Text)); }
+	}
+	std::vector<std::string> Strings = SharedStrings(Indices);
+
+	std::size_t Width = 0;
+	for (const Cell& Item : Cells) { Width = std::max(Width, Item.Column + 1); }
+	ColNames.assign(Width, "");
+	std::size_t StringIndex = 0;
+	for (const Cell& Item : Cells) {
+		std::string& Name = ColNames[Item.Column];
+		if (Item.Type == "s") { Name = Strings[StringIndex++]; }
+		else if (Item.Type == "b") { Name = Item.Text == "1" ? "True" : "False"; }
+		else if (Item.Type == "n") { Name = NumberText(Item.Text); }
+		else { Name = Item.Text; }
+	}
+	for (std::size_t i = 0; i < ColNames.size(); i++) {
+		if (ColNames[i].empty()) { ColNames[i] = "Unnamed: " + std::to_string(i); }
+	}
+	MangleDuplicateNames(ColNames);
+}
+
+// Shared strings at Indices (in this order), sharedStrings.xml is only read up to the highest index:
+std::vector<std::string> XLSXSource::SharedStrings(const std::vector<std::size_t>& Indices) const {
+	std::vector<std::string> Strings(Indices.size());
+	if (Indices.empty() or not Archive.Contains("xl/sharedStrings.xml")) { return Strings; }
+	std::size_t Last = *std::max_element(Indices.begin(), Indices.end());
+
+	std::string Pending;
+	std::size_t Index = 0;
+	Archive.Stream("xl/sharedStrings.xml", [&](const char* Data, std::size_t Size) {
+		Pending.append(Data, Size);
+		const char* Begin = Pending.data();
+		const char* End = Begin + Pending.size();
+		const char* Pos = Begin;
+		while (Index <= Last) {
+			const char* Lt = static_cast<const char*>(std::memchr(Pos, '<', End - Pos));
+			if (Lt == nullptr) {
+				Pos = End;
+				break;
+			}
+			const char* Gt = static_cast<const char*>(std::memchr(Lt, '>', End - Lt));
+			if (Gt == nullptr) {
+				Pos = Lt;
+				break;
+			}
+			std::string_view Tag(Lt + 1, Gt - Lt - 1);
+			if (TagName(Tag) != "si" or Tag[0] == '/') {
+				Pos = Gt + 1;
+				continue;
+			}
+			const char* ItemEnd = Tag.back() == '/' ? Gt + 1 : FindElementEnd(Gt + 1, End, "si");
+			if (ItemEnd == nullptr) {
+				Pos = Lt;
+				break;
+			}
+			for (std::size_t i = 0; i < Indices.size(); i++) {
+				if (Indices[i] == Index) { Strings[i] = InnerText(Gt + 1, ItemEnd, "t", "rPh"); }
+			}
+			Index++;
+			Pos = ItemEnd;
+		}
+		Pending.erase(0, Pos - Begin);
+		return Index <= Last;
+	});
+	return Strings;
+}
+
+std::vector<DataColumn> XLSXSource::Columns(const std::vector<std::size_t>& Indices) const {
+	const std::size_t NoSlot = std::numeric_limits<std::size_t>::max();
+	std::vector<std::size_t> Slots(ColNames.size(), NoSlot);
+	std::vector<DataColumn> Result(Indices.size());
+	for (std::size_t i = 0; i < Indices.size(); i++) {
+		if (Indices[i] >= ColNames.size()) {
+			throw std::out_of_range("Column index out of range");
+		}
+		Slots[Indices[i]] = i;
+		Result[i].Name = ColNames[Indices[i]];
+	}
+
+	// Rows behind the last row with any value are dropped like pandas does:
+	std::size_t Rows = 0;
+	auto OnCell = [&](std::size_t Row, std::size_t Column, std::string_view Type, std::size_t Style, const char* Begin, const char* End) {
+		if (Row <= HeaderRow) { return; }
+		bool Inline = Type == "inlineStr";
+		std::string Text = Inline ? InnerText(Begin, End, "t", "rPh") : InnerText(Begin, End, "v");
+		if (Text.empty()) { return; }
+		std::size_t DataRow = Row - HeaderRow - 1;
+		Rows = std::max(Rows, DataRow + 1);
+		if (Column >= Slots.size() or Slots[Column] == NoSlot) { return; }
+
+		DataColumn& Target = Result[Slots[Column]];
+		if (Target.Values.size() <= DataRow) { Target.Values.resize(DataRow + 1, NaN); }
+		double& Value = Target.Values[DataRow];
+		if (Type == "n") {
+			if (Style < DateStyles.size() and DateStyles[Style]) { Target.Numeric = false; }
+			if (not ParseNumber(Text.data(), Text.data() + Text.size(), '.', Value)) { Target.Numeric = false; }
+		}
+		else if (Type == "b") {
+			Value = Text == "1" ? 1.0 : 0.0;
+		}
+		else {
+			// Strings (shared, inline, formula results), errors and ISO dates; only missing value markers keep it numeric:
+			Value = NaN;
+			if (Type == "s" or not IsNAToken(Text.data(), Text.data() + Text.size())) { Target.Numeric = false; }
+		}
+	};
+	std::size_t RowsRead = 0;
+	auto OnRowEnd = [&](std::size_t) {
+		RowsRead++;
+		return true;
+	};
+	SheetScanner<decltype(OnCell), decltype(OnRowEnd)> Scanner(OnCell, OnRowEnd);
+	LoadProgress& Progress = LoadProgress::Current();
+	Progress.BeginPass("Parsing", Archive.Size(SheetPath));
+	Archive.Stream(SheetPath, [&](const char* Data, std::size_t Size) {
+		std::size_t Before = RowsRead;
+		bool More = Scanner.Feed(Data, Size);
+		Progress.Add(Size, RowsRead - Before);
+		return More;
+	});
+
+	for (DataColumn& Column : Result) {
+		Column.Values.resize(Rows, NaN);
+		ComputeStats(Column);
+	}
+	return Result;
+}
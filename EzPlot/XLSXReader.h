@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "DataReader.h"
+#include "MappedFile.h"
+
+// Read-only zip archive on a memory mapped file, entries are inflated in blocks:
+class ZipArchive {
+public:
+	explicit ZipArchive(const std::filesystem::path& Path);
+
+	bool Contains(const std::string& Name) const;
+	std::uint64_t Size(const std::string& Name) const; // Uncompressed size
+	// Hand the uncompressed entry to Consume block by block, Consume returns false to stop:
+	void Stream(const std::string& Name, const std::function<bool(const char*, std::size_t)>& Consume) const;
+	std::string Read(const std::string& Name) const;
+
+private:
+	struct Entry {
+		std::string Name;
+		std::uint16_t Method;
+		std::uint64_t CompressedSize;
+		std::uint64_t Size;
+		std::uint64_t Offset; // Local file header
+	};
+
+	const Entry& Find(const std::string& Name) const;
+
+	MappedFile File;
+	std::vector<Entry> Entries;
+};
+
+// First worksheet of a xlsx workbook. Opening reads only the header row, the sheet XML is
+// streamed again for every Columns call and only cells of requested columns are converted.
+// Shared strings are only loaded up to the highest index used in the header.
+class XLSXSource : public DataSource {
+public:
+	explicit XLSXSource(const std::filesystem::path& Path);
+
+	const std::vector<std::string>& Names() const override { return ColNames; }
+	std::vector<DataColumn> Columns(const std::vector<std::size_t>& Indices) const override;
+
+private:
+	void ReadHeader();
+	void ReadStyles();
+	std::vector<std::string> SharedStrings(const std::vector<std::size_t>& Indices) const;
+
+	ZipArchive Archive;
+	std::string SheetPath;
+	std::vector<std::string> ColNames;
+	std::size_t HeaderRow = 0;
+	std::vector<bool> DateStyles; // Cell formats which pandas reads as dates
+};
@@ -0,0 +1,58 @@
+# CSV reading benchmark by Ezodox
+# Compares pandas.read_csv (old PickData path) with the native ezdata reader.
+# ezdata is built into EzPlot.exe; to run this script standalone build DataReader.cpp and
+# PyDataModule.cpp as python extension "ezdata" and put it next to this file.
+#
+# Usage: python csv_benchmark.py [max rows, default 1e7] (1e8 rows need about 5 GB disk space)
+
+import os
+import sys
+import time
+import tempfile
+import numpy as np
+import pandas as pd
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from python_modules import data_cache
+
+def WriteFile(Path, Rows, Seperator, Decimal):
+    Block = 10**6
+    with open(Path, "w") as File:
+        File.write(Seperator.join(["x", "y", "xerr", "yerr"]) + "\n")
+        for Start in range(0, Rows, Block):
+            Count = min(Block, Rows - Start)
+            Data = pd.DataFrame(np.random.rand(Count, 4))
+            Data.to_csv(File, sep=Seperator, decimal=Decimal, header=False, index=False)
+
+def ReadAllColumns(Path, Seperator, Decimal):
+    Table = data_cache.SourceTable(Path, Seperator, Decimal)
+    return {Name: Table[Name] for Name in Table.keys()}
+
+def Measure(Function):
+    Start = time.perf_counter()
+    Result = Function()
+    return time.perf_counter() - Start, Result
+
+def main():
+    MaxRows = int(float(sys.argv[1])) if len(sys.argv) > 1 else 10**7
+    if not data_cache.ezdata:
+        print("ezdata module not found, only pandas is measured")
+    Directory = tempfile.mkdtemp()
+    Rows = 10**5
+    while Rows <= MaxRows:
+        for Seperator, Decimal in ((",", "."), (";", ",")):
+            Path = os.path.join(Directory, f"bench_{Rows}.csv")
+            WriteFile(Path, Rows, Seperator, Decimal)
+            PandasTime, Expected = Measure(lambda: pd.read_csv(Path, sep=Seperator, decimal=Decimal))
+            Line = f"{Rows:>11,} rows  sep '{Seperator}' dec '{Decimal}'  pandas {PandasTime:8.3f} s"
+            if data_cache.ezdata:
+                NativeTime, Data = Measure(lambda: ReadAllColumns(Path, Seperator, Decimal))
+                Equal = all(np.allclose(Data[Name], Expected[Name], rtol=1e-15) for Name in Expected.columns)
+                Line += f"  ezdata {NativeTime:8.3f} s  speedup {PandasTime / NativeTime:5.1f}x  {'ok' if Equal else 'MISMATCH'}"
+            print(Line)
+            del Expected
+            os.remove(Path)
+        Rows *= 10
+    os.rmdir(Directory)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,431 @@
+# Parsed data table cache by Ezodox
+# Shared by file_picker and plot, so a data file is parsed only once as long as
+# path, size, modification time, seperator and decimal stay the same.
+
+import os
+import threading
+from collections import OrderedDict
+from concurrent.futures import ThreadPoolExecutor
+import numpy as np
+import pandas as pd
+from python_modules import sidecar
+try:
+    import ezdata # Native readers of EzPlot (PyDataModule.cpp)
+except ImportError:
+    ezdata = None
+
+CacheLimit = 1024 * 1024**2 # Memory cap of all cached tables in bytes
+SinglePrecision = False # Keep float columns as float32, set by the plot settings of the project
+LoaderThreads = os.cpu_count() or 1 # Data files read at the same time
+OutOfCoreBudget = 0 # Memory in bytes for streaming columns which stay on disk, 0 reads them into memory
+Tables = OrderedDict() # Key -> Data, least recently used first
+# The cache is used by the loading thread (and its pool), the plot thread and the GUI thread. Lock
+# guards Tables, Opening holds a lock per file which is opened, so each file is opened only once.
+# Parsing runs under the lock of the table (SourceTable.Lock) only.
+Lock = threading.RLock()
+Opening = {} # Key -> threading.Lock
+
+def SetCacheLimit(LimitMB):
+    global CacheLimit
+    CacheLimit = int(LimitMB) * 1024**2
+    Evict()
+
+def SetOutOfCoreBudget(BudgetMB):
+    # CSV columns parsed from now on are written to the sidecar in parts and mapped from there,
+    # plotting and fitting go through them in chunks of the budget
+    global OutOfCoreBudget
+    OutOfCoreBudget = max(int(BudgetMB), 0) * 1024**2
+
+def OutOfCore():
+    return OutOfCoreBudget > 0
+
+def ChunkRows(Width):
+    # Rows of Width float64 columns per chunk, a quarter of the budget leaves room for the copies
+    # and temporaries of the chunk
+    return max(OutOfCoreBudget // (4 * 8 * max(Width, 1)), 1 << 12)
+
+def Chunks(Rows, Width):
+    # Row slices to go through Width columns of Rows rows, a single slice without out-of-core mode
+    Step = ChunkRows(Width) if OutOfCore() else max(Rows, 1)
+    for First in range(0, Rows, Step): yield slice(First, min(First + Step, Rows))
+
+def SetSinglePrecision(Single):
+    # Cached tables keep the precision they were parsed with, so they are dropped when it changes
+    global SinglePrecision
+    if bool(Single) == SinglePrecision: return
+    SinglePrecision = bool(Single)
+    Clear()
+
+def Reduce(Values):
+    # Column as it is kept in the cache, float64 becomes float32 in single precision mode
+    if SinglePrecision and isinstance(Values, np.ndarray) and Values.dtype == np.float64:
+        return Values.astype(np.float32)
+    return Values
+
+def Promote(Values):
+    # float32 values as float64 for the fit solvers
+    if isinstance(Values, np.ndarray) and Values.dtype == np.float32: return Values.astype(np.float64)
+    return Values
+
+def CheckCancelled():
+    # Between the steps of a load, the ezdata readers check it while they parse
+    if ezdata: ezdata.check_cancelled()
+
+def TableKey(Path, Seperator, Decimal):
+    Stat = os.stat(Path)
+    return (os.path.abspath(Path), Stat.st_size, Stat.st_mtime_ns, Seperator, Decimal)
+
+def IsArrow(Path):
+    # Arrow IPC (Feather) files are columnar already, they are mapped instead of parsed
+    return Path.lower().endswith((".arrow", ".feather", ".ipc", ".arrows"))
+
+def ColumnArray(Column):
+    # View on the values of a native column without copying
+    if len(Column) == 0: return np.empty(0)
+    return np.frombuffer(Column, dtype=np.float64)
+
+def FilterSeries(Values, Mask):
+    # Keep the rows of Mask in every column of a series, constants are left as they are
+    if Mask is None: return tuple(Values)
+    Rows = np.flatnonzero(Mask)
+    return tuple(Column[Rows] if isinstance(Column, np.ndarray) else Column for Column in Values)
+
+def MissingMask(Values):
+    # Rows with a value, None if no value is missing (the columns are used as they are then)
+    Mask = ~np.isnan(Values)
+    return None if Mask.all() else Mask
+
+def MergeStats(Parts):
+    # Summary of a column from the summaries of its parts
+    Parts = [Part for Part in Parts if Part]
+    Count = sum(Part["Count"] for Part in Parts)
+    Missing = sum(Part["Missing"] for Part in Parts)
+    if Count == 0: return {"Count": 0, "Missing": Missing, "Min": np.nan, "Max": np.nan, "Mean": np.nan}
+    Parts = [Part for Part in Parts if Part["Count"]]
+    return {"Count": Count, "Missing": Missing, "Min": min(Part["Min"] for Part in Parts),
+            "Max": max(Part["Max"] for Part in Parts), "Mean": sum(Part["Mean"] * Part["Count"] for Part in Parts) / Count}
+
+def ChunkStats(Values):
+    Missing = int(np.count_nonzero(np.isnan(Values))) if Values.dtype.kind == "f" else 0
+    Count = len(Values) - Missing
+    if Count == 0: return {"Count": 0, "Missing": Missing, "Min": np.nan, "Max": np.nan, "Mean": np.nan}
+    return {"Count": Count, "Missing": Missing, "Min": float(np.nanmin(Values)), "Max": float(np.nanmax(Values)),
+            "Mean": float(np.nansum(Values, dtype=np.float64)) / Count}
+
+def ColumnStats(Values):
+    # Same summary as ezdata collects while parsing, for columns from pandas or the sidecar
+    Values = np.asarray(Values)
+    if Values.dtype.kind not in "biuf": return None
+    return MergeStats([ChunkStats(Values[Rows]) for Rows in Chunks(len(Values), 1)])
+
+def ValueRange(Values, yValues=None):
+    # (min, max) without NaN, None if there is no value. With yValues only the rows with a y value count.
+    Values = np.asarray(Values)
+    if Values.dtype.kind not in "biuf": return None
+    Low, High = np.inf, -np.inf
+    for Rows in Chunks(len(Values), 2):
+        Part = Values[Rows] if yValues is None else Values[Rows][~np.isnan(yValues[Rows])]
+        if len(Part) and not np.isnan(Part).all():
+            Low, High = min(Low, float(np.nanmin(Part))), max(High, float(np.nanmax(Part)))
+    return (Low, High) if Low <= High else None
+
+class TextColumn(Exception):
+    # A streamed column turned out not to be numeric
+    pass
+
+class FilteredTable:
+    # Validity masks of the columns, the series without missing y values and the statistics of
+    # the columns, all computed once per table and kept until the table is dropped from the cache
+    def __init__(self):
+        self.Masks = {}
+        self.Views = {}
+        self.Ranges = {}
+        self.Summaries = {}
+
+    def OnDisk(self, Name):
+        # Column which is streamed in chunks instead of being filtered in memory
+        return False
+
+    def Stats(self, Name):
+        if Name not in self.Summaries: self.Summaries[Name] = ColumnStats(self[Name])
+        return self.Summaries[Name]
+
+    def Valid(self, Name):
+        if Name not in self.Masks:
+            Stats = self.Stats(Name)
+            self.Masks[Name] = None if Stats and Stats["Missing"] == 0 else MissingMask(self[Name])
+        return self.Masks[Name]
+
+    def Range(self, x, y):
+        # x range of the rows with a y value, the column statistics tell it if no y is missing
+        if (x, y) not in self.Ranges:
+            Stats = self.Stats(x)
+            if self.OnDisk(y) and not (self.Stats(y) and self.Stats(y)["Missing"] == 0):
+                self.Ranges[x, y] = ValueRange(self[x], self[y])
+            elif self.Valid(y) is None and Stats: self.Ranges[x, y] = (Stats["Min"], Stats["Max"]) if Stats["Count"] else None
+            else: self.Ranges[x, y] = ValueRange(self.Series(x, y, 0, 0)[0])
+        return self.Ranges[x, y]
+
+    def Series(self, x, y, xErr, yErr):
+        # Column names or constant errors -> (x, y, xErr, yErr) of the rows with a y value.
+        # Columns on disk are not copied, their rows without y value are skipped while streaming.
+        Key = (x, y, xErr, yErr)
+        if Key not in self.Views:
+            Values = [self[Column] if type(Column) == str else Column for Column in Key]
+            self.Views[Key] = tuple(Values) if self.OnDisk(y) else FilterSeries(Values, self.Valid(y))
+        return self.Views[Key]
+
+    @property
+    def ViewBytes(self):
+        # Only filtered copies take memory, unfiltered series are the columns themselves. Copies of
+        # the dicts, another thread may add to them meanwhile.
+        return sum(Column.nbytes for Key, Values in list(self.Views.items()) if self.Masks.get(Key[1]) is not None
+                   for Column in Values if isinstance(Column, np.ndarray)) \
+             + sum(Mask.nbytes for Mask in list(self.Masks.values()) if Mask is not None)
+
+class DictTable(dict, FilteredTable):
+    # Table parsed completely (pandas or a complete sidecar)
+    def __init__(self, Columns):
+        dict.__init__(self, Columns)
+        FilteredTable.__init__(self)
+
+    @property
+    def nbytes(self):
+        return sum(Values.nbytes for Values in self.values()) + self.ViewBytes
+
+class SourceTable(FilteredTable):
+    # CSV, xlsx or Arrow file read by ezdata, a column is parsed the first time it is accessed.
+    # Parsed columns are kept in the sidecar file, so they are only mapped next time.
+    # Arrow files need no sidecar, their float64 columns are used in place (Mapped).
+    # In out-of-core mode the sidecar columns stay mapped as well and CSV columns are streamed
+    # into the sidecar chunk by chunk, so the file is never in memory at once.
+    def __init__(self, Path, Seperator, Decimal):
+        FilteredTable.__init__(self)
+        self.Path, self.Seperator, self.Decimal = Path, Seperator, Decimal
+        self.Lock = threading.RLock() # Held while the source is opened, columns are parsed or stored
+        self.Columns = {}
+        self.Mapped = set()
+        self.Source = None
+        self.Sidecar = None if IsArrow(Path) else sidecar.Open(Path, Seperator, Decimal)
+        if self.Sidecar: self.Names = self.Sidecar.Names
+        else: self.Names = self.OpenSource().names
+
+    def OpenSource(self):
+        with self.Lock:
+            if not self.Source:
+                if self.Path.endswith("xlsx"): self.Source = ezdata.open_xlsx(self.Path)
+                elif IsArrow(self.Path): self.Source = ezdata.open_arrow(self.Path)
+                else: self.Source = ezdata.open_csv(self.Path, self.Seperator, self.Decimal)
+            return self.Source
+
+    def keys(self):
+        return self.Names
+
+    def OnDisk(self, Name):
+        return OutOfCore() and Name in self.Mapped
+
+    def Load(self, Names):
+        # Parse all missing columns in one pass, other columns of the file are not converted. ezdata
+        # parses without the GIL, the lock keeps other threads from parsing the same columns.
+        with self.Lock: self.LoadLocked(Names)
+
+    def LoadLocked(self, Names):
+        Names = [Name for Name in dict.fromkeys(Names) if Name in self.Names and Name not in self.Columns]
+        Stored = self.Sidecar.Stored if self.Sidecar else {}
+        for Name in [Name for Name in Names if Name in Stored]:
+            if OutOfCore():
+                self.Columns[Name] = self.Sidecar.Column(Name)
+                self.Mapped.add(Name)
+            else: self.Columns[Name] = Reduce(self.Sidecar.Column(Name))
+        Parsed = [Name for Name in Names if Name not in Stored]
+        if not Parsed: return
+        if OutOfCore() and self.Stream(Parsed): return
+        TextColumns = {}
+        for Name, Column in zip(Parsed, self.OpenSource().columns(Parsed)):
+            if Column.numeric:
+                self.Columns[Name] = ColumnArray(Column)
+                self.Summaries[Name] = Column.stats
+            else: TextColumns[Name] = Column
+            if Column.mapped: self.Mapped.add(Name)
+        TextNames = list(TextColumns)
+        CheckCancelled()
+
+        # Let pandas decide about the type of text and date columns
+        if TextNames and IsArrow(self.Path):
+            try:
+                Text = pd.read_feather(self.Path, columns=TextNames)
+                for Name in TextNames: self.Columns[Name] = Text[Name].to_numpy()
+            except ImportError: # pandas needs pyarrow for that, dates and times keep their raw numbers then
+                for Name in TextNames: self.Columns[Name] = ColumnArray(TextColumns[Name])
+        elif TextNames and self.Path.endswith("xlsx"):
+            Text = pd.read_excel(self.Path)
+            Text.columns = [str(Name) for Name in Text.columns]
+            for Name in TextNames: self.Columns[Name] = Text[Name].to_numpy()
+        elif TextNames:
+            Text = pd.read_csv(self.Path, sep=self.Seperator, decimal=self.Decimal, usecols=TextNames)
+            for Name in TextNames: self.Columns[Name] = Text[Name].to_numpy()
+        CheckCancelled()
+        self.UpdateSidecar()
+
+        # The sidecar keeps float64, mapped columns take no memory of their own
+        for Name in Parsed:
+            if Name not in self.Mapped: self.Columns[Name] = Reduce(self.Columns[Name])
+
+    def Stream(self, Names):
+        # Parse the columns in chunks of rows straight into the sidecar and map them from there.
+        # Returns False if the file cannot be streamed (no row index, text columns), the columns are
+        # parsed into memory then. A file larger than the RAM would not fit, so if the sidecar
+        # cannot be written that is an error.
+        with self.Lock: return self.StreamLocked(Names)
+
+    def StreamLocked(self, Names):
+        if IsArrow(self.Path): return False
+        Source = self.OpenSource()
+        Rows = Source.row_count
+        if Rows is None: return False
+        Parts = {Name: [] for Name in Names}
+        def Chunked():
+            for Chunk in Chunks(Rows, len(Names)):
+                Columns = Source.columns(Names, Chunk.start, Chunk.stop - Chunk.start)
+                if not all(Column.numeric for Column in Columns): raise TextColumn()
+                for Name, Column in zip(Names, Columns): Parts[Name].append(Column.stats)
+                yield Chunk.start, {Name: ColumnArray(Column) for Name, Column in zip(Names, Columns)}
+        Columns = {Name: self.Sidecar.Column(Name) for Name in self.Sidecar.Stored} if self.Sidecar else {}
+        Columns.update({Name: sidecar.Streamed(Rows, np.float64) for Name in Names})
+        try:
+            Written = sidecar.Write(self.Path, self.Seperator, self.Decimal, self.Names, Columns, Chunked())
+        except TextColumn:
+            return False
+        if Written: self.Sidecar = sidecar.Open(self.Path, self.Seperator, self.Decimal)
+        if not Written or not self.Sidecar:
+            raise OSError("No sidecar could be written for " + self.Path + ", out-of-core mode needs one")
+        for Name in Names:
+            self.Columns[Name] = self.Sidecar.Column(Name)
+            self.Mapped.add(Name)
+            self.Summaries[Name] = MergeStats(Parts[Name])
+        return True
+
+    def UpdateSidecar(self):
+        # Rewrite the sidecar with the stored and the newly parsed columns. The old one stays mapped
+        # while its columns are in use, the new one gets another name then (see sidecar.SidecarNames).
+        with self.Lock: self.UpdateSidecarLocked()
+
+    def UpdateSidecarLocked(self):
+        if IsArrow(self.Path): return
+        Columns = {}
+        if self.Sidecar:
+            for Name in self.Sidecar.Stored: Columns[Name] = self.Sidecar.Column(Name)
+        # Columns reduced to float32 are not stored, the sidecar keeps the full precision
+        Columns.update({Name: Values for Name, Values in self.Columns.items() if Name not in Columns
+                        and sidecar.Storable(Values) and not (SinglePrecision and Values.dtype == np.float32)})
+        if self.Sidecar and all(Name in self.Sidecar.Stored for Name in Columns): return
+        if sidecar.Write(self.Path, self.Seperator, self.Decimal, self.Names, Columns):
+            self.Sidecar = sidecar.Open(self.Path, self.Seperator, self.Decimal)
+
+    def __getitem__(self, Name):
+        if Name not in self.Columns:
+            self.Load([Name])
+        return self.Columns[Name]
+
+    @property
+    def nbytes(self):
+        # Mapped columns are file pages, the OS drops them under memory pressure
+        return sum(Values.nbytes for Name, Values in list(self.Columns.items()) if Name not in self.Mapped) + self.ViewBytes
+
+def TableSize(Data):
+    return Data.nbytes
+
+def SeriesData(Data, x, y, xErr, yErr):
+    # One data series without the rows missing a y value, cached tables keep it for the next call
+    if isinstance(Data, FilteredTable): return Data.Series(x, y, xErr, yErr)
+    Values = [Data[Column] if type(Column) == str else Column for Column in (x, y, xErr, yErr)]
+    return FilterSeries(Values, MissingMask(Values[1]))
+
+def SeriesRange(Data, x, y):
+    # x range of a data series from the statistics of a cached table, None for other tables
+    return Data.Range(x, y) if isinstance(Data, FilteredTable) else None
+
+def ReadTable(Path, Seperator, Decimal):
+    # Returns the table as mapping: column name -> numpy array
+    if ezdata:
+        return SourceTable(Path, Seperator, Decimal)
+
+    if IsArrow(Path): # pandas reads Arrow files with pyarrow
+        Data = pd.read_feather(Path)
+        return DictTable({str(Name): Reduce(Data[Name].to_numpy()) for Name in Data.columns})
+
+    # Whole table is parsed by pandas, so the sidecar is only used if it holds every column
+    Stored = sidecar.Open(Path, Seperator, Decimal)
+    if Stored and Stored.Complete():
+        return DictTable({Name: Reduce(Stored.Column(Name)) for Name in Stored.Names})
+    if Path.endswith("xlsx"):
+        Data = pd.read_excel(Path)
+    else: # CSV, pandas decompresses .gz and .zst files by their extension
+        Data = pd.read_csv(Path, sep=Seperator, decimal=Decimal)
+    Data = {str(Name): Data[Name].to_numpy() for Name in Data.columns}
+    sidecar.Write(Path, Seperator, Decimal, list(Data), Data)
+    return DictTable({Name: Reduce(Values) for Name, Values in Data.items()})
+
+def CacheSize():
+    # Sizes are summed up on demand, because mapped tables grow when columns are parsed
+    with Lock: return sum(TableSize(Data) for Data in list(Tables.values()))
+
+def Evict(Keep=()):
+    # Remove least recently used tables until cache fits in its limit (never the ones just used)
+    with Lock:
+        Size = CacheSize()
+        for Key in list(Tables):
+            if Size <= CacheLimit: break
+            if Key not in Keep: Size -= TableSize(Tables.pop(Key))
+
+def LoadTable(Source, Columns):
+    # (Key, table) of a (Path, Seperator, Decimal) source with the needed columns parsed.
+    # Runs on a loader thread when several files are read. A file which is not cached is opened
+    # by one thread, the others wait for it and take the table it stored.
+    Key = TableKey(*Source)
+    with Lock:
+        Data = Tables.get(Key)
+        if Data is None: FileLock = Opening.setdefault(Key, threading.Lock())
+    if Data is None:
+        with FileLock:
+            with Lock: Data = Tables.get(Key)
+            if Data is None:
+                Data = ReadTable(*Source)
+                Store(Key, Data)
+        with Lock: Opening.pop(Key, None)
+    CheckCancelled()
+    if Columns and isinstance(Data, SourceTable): Data.Load(Columns)
+    return Key, Data
+
+def Store(Key, Data):
+    with Lock:
+        if Key in Tables:
+            Tables.move_to_end(Key)
+            return
+        # Drop outdated versions of the same file
+        for OldKey in [k for k in Tables if k[0] == Key[0]]: del Tables[OldKey]
+        Tables[Key] = Data
+
+def GetTable(Path, Seperator, Decimal, Columns=None):
+    # Columns: names which are needed, mapped tables parse them together in one pass
+    Key, Data = LoadTable((Path, Seperator, Decimal), Columns)
+    Store(Key, Data)
+    Evict(Keep=(Key,))
+    return Data
+
+def GetTables(Requests):
+    # Requests: (Path, Seperator, Decimal) -> needed column names, returns the table of every source.
+    # Each file is opened once and the files are read at the same time, ezdata parses without
+    # holding the GIL.
+    Sources = list(Requests)
+    if len(Sources) > 1:
+        with ThreadPoolExecutor(max_workers=min(len(Sources), LoaderThreads)) as Pool:
+            Loaded = list(Pool.map(lambda Source: LoadTable(Source, Requests[Source]), Sources))
+    else:
+        Loaded = [LoadTable(Source, Requests[Source]) for Source in Sources]
+    for Key, Data in Loaded: Store(Key, Data)
+    Evict(Keep=[Key for Key, Data in Loaded])
+    return {Source: Data for Source, (Key, Data) in zip(Sources, Loaded)}
+
+def Clear():
+    with Lock: Tables.clear()
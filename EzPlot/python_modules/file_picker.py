@@ -1,9 +1,154 @@
-import pandas
+import re
+import zipfile
+import posixpath
+import xml.etree.ElementTree as ET
+import numpy as np
+import pandas as pd
+from python_modules import data_cache
+from python_modules import sidecar
+
+Main = "{http://schemas.openxmlformats.org/spreadsheetml/2006/main}"
+RelId = "{http://schemas.openxmlformats.org/officeDocument/2006/relationships}id"
+RelTag = "{http://schemas.openxmlformats.org/package/2006/relationships}Relationship"
+
+def MangleNames(Names):
+    # Same naming as the table readers: empty -> "Unnamed: i", duplicates -> "a", "a.1"
+    Names = [Name if Name != "" else f"Unnamed: {i}" for i, Name in enumerate(Names)]
+    Used = set()
+    for i, Name in enumerate(Names):
+        Base, Count = Name, 1
+        while Name in Used:
+            Name = f"{Base}.{Count}"
+            Count += 1
+        Names[i] = Name
+        Used.add(Name)
+    return Names
+
+def CSVHeader(FilePath, Seperator, Decimal):
+    if data_cache.ezdata:
+        return data_cache.ezdata.read_header(FilePath, Seperator)
+    return [str(Name) for Name in pd.read_csv(FilePath, sep=Seperator, decimal=Decimal, nrows=0).columns]
+
+def FirstSheetPath(Archive):
+    # Path of the first worksheet in workbook order
+    Workbook = ET.fromstring(Archive.read("xl/workbook.xml"))
+    Id = Workbook.find(f"{Main}sheets/{Main}sheet").get(RelId)
+    for Rel in ET.fromstring(Archive.read("xl/_rels/workbook.xml.rels")).iter(RelTag):
+        if Rel.get("Id") == Id:
+            Target = Rel.get("Target")
+            return Target.lstrip("/") if Target.startswith("/") else posixpath.normpath("xl/" + Target)
+
+def SharedStrings(Archive, Indices):
+    # Read shared strings only up to the highest index needed
+    Strings = {}
+    if not Indices or "xl/sharedStrings.xml" not in Archive.namelist(): return Strings
+    Last = max(Indices)
+    with Archive.open("xl/sharedStrings.xml") as File:
+        Index = 0
+        for _, Element in ET.iterparse(File):
+            if Element.tag != f"{Main}si": continue
+            if Index in Indices:
+                Strings[Index] = "".join(Text.text or "" for Text in Element.iter(f"{Main}t"))
+            Element.clear()
+            if Index == Last: break
+            Index += 1
+    return Strings
+
+def ColumnIndex(Reference):
+    Index = 0
+    for Letter in re.match(r"[A-Z]+", Reference).group():
+        Index = Index * 26 + ord(Letter) - ord("A") + 1
+    return Index - 1
+
+def CellText(Value):
+    # Numeric header cells are named like pandas converts them to text ("1.0" -> "1")
+    try:
+        Number = float(Value)
+    except ValueError:
+        return Value
+    return str(int(Number)) if Number.is_integer() else str(Number)
+
+def XLSXHeader(FilePath):
+    with zipfile.ZipFile(FilePath) as Archive:
+        Cells = {} # Column index -> (type, value)
+        with Archive.open(FirstSheetPath(Archive)) as File:
+            for _, Element in ET.iterparse(File):
+                if Element.tag == f"{Main}c":
+                    Type = Element.get("t", "n")
+                    if Type == "inlineStr":
+                        Value = "".join(Text.text or "" for Text in Element.iter(f"{Main}t"))
+                    else:
+                        Value = Element.findtext(f"{Main}v")
+                    if Value is not None:
+                        Index = ColumnIndex(Element.get("r")) if Element.get("r") else len(Cells)
+                        Cells[Index] = (Type, Value)
+                elif Element.tag == f"{Main}row":
+                    if Cells: break
+                    Element.clear()
+        Strings = SharedStrings(Archive, {int(Value) for Type, Value in Cells.values() if Type == "s"})
+
+    Names = [""] * (max(Cells) + 1 if Cells else 0)
+    for Index, (Type, Value) in Cells.items():
+        if Type == "s": Names[Index] = Strings.get(int(Value), "")
+        elif Type == "b": Names[Index] = "True" if Value == "1" else "False"
+        elif Type == "n": Names[Index] = CellText(Value)
+        else: Names[Index] = Value
+    return MangleNames(Names)
 
 def GetColNames(FilePath, Seperator, Decimal):
+    # Only the header row is read, the table itself is parsed when plotting
     if FilePath.endswith("xlsx"):
-        Data = pandas.read_excel(FilePath)
-    elif FilePath.endswith("csv"):
-        Data = pandas.read_csv(FilePath, sep=Seperator, decimal=Decimal)
-    Names = list(Data.columns)
-    return Names
\ No newline at end of file
+        Stored = sidecar.Open(FilePath, Seperator, Decimal)
+        if Stored: Names = Stored.Names
+        elif data_cache.ezdata: Names = data_cache.ezdata.open_xlsx(FilePath).names
+        else: Names = XLSXHeader(FilePath)
+    elif data_cache.IsArrow(FilePath): # Names come from the schema, no data is read
+        Names = list(data_cache.GetTable(FilePath, Seperator, Decimal).keys())
+    else:
+        Names = CSVHeader(FilePath, Seperator, Decimal)
+    return Names
+def LoadFile(FilePath, Seperator, Decimal):
+    # Called on the loading thread of EzPlot: column names, and the table is opened (indexed)
+    # in the cache already, so plotting only has to parse the used columns
+    Names = GetColNames(FilePath, Seperator, Decimal)
+    data_cache.GetTable(FilePath, Seperator, Decimal)
+    return Names
+
+def PreviewSource(FilePath, Seperator, Decimal):
+    # Cached table and the row index of ezdata, the index only exists for uncompressed CSV files
+    Data = data_cache.GetTable(FilePath, Seperator, Decimal)
+    if not isinstance(Data, data_cache.SourceTable) or FilePath.endswith("xlsx") or data_cache.IsArrow(FilePath):
+        return Data, None
+    Source = Data.OpenSource()
+    return Data, (Source if Source.row_count is not None else None)
+
+def PreviewCell(Value):
+    if Value is None or (isinstance(Value, (float, np.floating)) and np.isnan(Value)): return ""
+    return str(Value)
+
+PreviewLimit = 10000 # Rows shown of files without a row index, copied from the parsed columns
+Preview = None # ((Path, Seperator, Decimal), indexed source or first rows as columns) of the shown file
+
+def PreviewRowCount(FilePath, Seperator, Decimal):
+    # Rows of the preview grid of the Data tab, called on the loading thread. Files without a row
+    # index are parsed here and their first PreviewLimit rows are kept, so PreviewRows never parses.
+    global Preview
+    Data, Source = PreviewSource(FilePath, Seperator, Decimal)
+    if Source:
+        Preview = ((FilePath, Seperator, Decimal), Source)
+        return Source.row_count
+    Names = list(Data.keys())
+    if isinstance(Data, data_cache.SourceTable): Data.Load(Names)
+    Columns = [np.array(Data[Name][:PreviewLimit]) for Name in Names] # Copies, the table may be evicted
+    Preview = ((FilePath, Seperator, Decimal), Columns)
+    return len(Columns[0]) if Columns else 0
+
+def PreviewRows(FilePath, Seperator, Decimal, First, Count):
+    # Cell texts of Count rows from First on, requested by the preview grid for the rows it shows.
+    # Called on the GUI thread: CSV rows are read from the mapped file, other files are shown from
+    # the rows PreviewRowCount kept. Nothing is parsed or loaded here.
+    if not Preview or Preview[0] != (FilePath, Seperator, Decimal): return []
+    Source = Preview[1]
+    if type(Source) != list: return Source.rows(First, Count)
+    Columns = [Values[First:First + Count] for Values in Source]
+    return [[PreviewCell(Value) for Value in Row] for Row in zip(*Columns)]
@@ -0,0 +1,126 @@
+# Fit result cache by Ezodox
+# Results of plot.SolveFit (parameters, errors, covariance, goodness of fit and the printed
+# output without the residuals) by a hash of everything they depend on: the fitted rows after the
+# Area/ExArea masking, the source of the fit function and the fit settings. Results are kept in
+# memory and, if the project is saved with the option on, those of the project in "<project>.ezfit"
+# next to the project file (JSON).
+
+import os
+import json
+import hashlib
+import inspect
+import marshal
+import tempfile
+from collections import OrderedDict
+import numpy as np
+
+Version = 2 # Version 1 stored the residuals in the output
+MaxResults = 1024 # Results kept, the least recently used are dropped first
+Results = OrderedDict() # Key -> Result, least recently used first
+ProjectFile = None # Results of the project are also stored there, None keeps them in memory only
+Project = set() # Keys of the results of the project: stored in ProjectFile or used since it was opened
+Unsaved = False # Results which are not written to ProjectFile yet
+
+def FunctionSource(func):
+    # Functions without a source file (defined in the console) are identified by their bytecode
+    try: return inspect.getsource(func).encode("utf-8")
+    except (OSError, TypeError): return marshal.dumps(func.__code__)
+
+def Key(func, Chunks, **Settings):
+    # Chunks: (x, y, x errors, y errors) of all fitted rows, arrays or constants.
+    # Settings: everything else the result depends on, in a repr which stays the same
+    Hash = hashlib.blake2b(digest_size=16)
+    Hash.update(func.__name__.encode("utf-8"))
+    Hash.update(FunctionSource(func))
+    Hash.update(repr(sorted(Settings.items())).encode("utf-8"))
+    for Chunk in Chunks:
+        for Values in Chunk:
+            if isinstance(Values, np.ndarray):
+                Values = np.ascontiguousarray(Values)
+                Hash.update("{0}{1}".format(Values.dtype.str, Values.shape).encode("utf-8"))
+                Hash.update(Values.data)
+            else: Hash.update(repr(Values).encode("utf-8"))
+    return Hash.hexdigest()
+
+def Get(Key):
+    if Key not in Results: return None
+    Results.move_to_end(Key)
+    Use(Key)
+    return Results[Key]
+
+def Put(Key, Result):
+    Results[Key] = Result
+    Results.move_to_end(Key)
+    while len(Results) > MaxResults: Results.popitem(last=False)
+    Use(Key)
+
+def Use(Key):
+    # A plot of the project used the result, it is stored with the project
+    global Unsaved
+    if Key in Project: return
+    Project.add(Key)
+    Unsaved = True
+
+def Clear():
+    global Unsaved
+    Results.clear()
+    Project.clear()
+    Unsaved = False
+
+def SetProjectFile(Path):
+    # Path of the saved project, "" when the results should stay in memory only (a new project,
+    # the results used so far belong to none then). The stored results of the project are added
+    # to those in memory.
+    global ProjectFile, Unsaved
+    ProjectFile = Path + ".ezfit" if Path else None
+    if not ProjectFile:
+        Project.clear()
+        return
+    try:
+        with open(ProjectFile, "r", encoding="utf-8") as File: Stored = json.load(File)
+    except (OSError, ValueError):
+        Stored = None
+    if type(Stored) == dict and Stored.get("Version") == Version:
+        for Key, Result in reversed(list(Stored["Results"].items())):
+            Project.add(Key)
+            if Key in Results: continue
+            Results[Key] = Restore(Result)
+            Results.move_to_end(Key, last=False) # Behind the results of this session
+        while len(Results) > MaxResults: Results.popitem(last=False)
+    Unsaved = True
+    Save()
+
+def Save():
+    # Write the results of the project to the project file, called after every plot. Results
+    # dropped from memory are dropped from the file too.
+    global Unsaved
+    if not ProjectFile or not Unsaved: return
+    Folder = os.path.dirname(os.path.abspath(ProjectFile))
+    File = None
+    try:
+        Project.intersection_update(Results)
+        Stored = OrderedDict((Key, Result) for Key, Result in Results.items() if Key in Project)
+        with tempfile.NamedTemporaryFile("w", encoding="utf-8", dir=Folder, suffix=".tmp", delete=False) as File:
+            json.dump({"Version": Version, "Results": Stored}, File, default=Plain)
+        os.replace(File.name, ProjectFile)
+        Unsaved = False
+    except Exception as Error:
+        # No partial file is left next to the project, the plot goes on without storing
+        if File is not None:
+            try: os.remove(File.name)
+            except OSError: pass
+        print("Fit results could not be stored next to the project:", Error)
+
+def Plain(Value):
+    # JSON form of the numpy values of a result
+    if isinstance(Value, np.ndarray): return {"Array": Value.tolist()}
+    if isinstance(Value, np.generic): return Value.item()
+    raise TypeError(type(Value).__name__)
+
+def Restore(Value):
+    # Result as it was before it was stored, arrays become numpy arrays again
+    if type(Value) == dict:
+        if list(Value) == ["Array"]: return np.asarray(Value["Array"], dtype=np.float64)
+        return {Key: Restore(Item) for Key, Item in Value.items()}
+    if type(Value) == list: return [Restore(Item) for Item in Value]
+    return Value
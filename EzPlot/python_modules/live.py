@@ -0,0 +1,272 @@
+# Live tail of growing CSV files by Ezodox
+# While the plot window is open the data file is polled, rows appended since the last
+# poll are parsed by ezdata.read_rows and only the new points are drawn (blitted).
+# The whole figure is redrawn only if the view has to grow, the fits are renewed or
+# too many small artists piled up.
+
+import io
+import os
+import time
+import contextlib
+import numpy as np
+from python_modules import data_cache
+
+Interval = 100 # Poll interval of the data file in ms
+FitInterval = 5 # Minimal time between two refits in s
+MergeUpdates = 100 # Number of incremental updates until they are merged into the series artists
+Headroom = 0.25 # Relative space added when the view is expanded, so growing data does not rescale every poll
+
+Current = None # Running live update, only the latest plot window is followed
+
+class GrowingColumn:
+    # Float column with amortized appends, Values is a view on the filled part
+    def __init__(self):
+        self.Buffer = np.empty(1024)
+        self.Size = 0
+
+    def Append(self, Values):
+        End = self.Size + len(Values)
+        if End > len(self.Buffer):
+            Buffer = np.empty(max(2 * len(self.Buffer), End))
+            Buffer[:self.Size] = self.Buffer[:self.Size]
+            self.Buffer = Buffer
+        self.Buffer[self.Size:End] = Values
+        self.Size = End
+
+    @property
+    def Values(self):
+        return self.Buffer[:self.Size]
+
+def Numeric(Values):
+    # Text cells of the cached table become NaN like in ezdata.read_rows
+    Values = np.asarray(Values)
+    if Values.dtype.kind in "fiub": return Values.astype(np.float64, copy=False)
+    Result = np.full(len(Values), np.nan)
+    for i, Value in enumerate(Values):
+        try: Result[i] = float(Value)
+        except (TypeError, ValueError): pass
+    return Result
+
+def EndsWithLineBreak(Path, Size):
+    if Size == 0: return False
+    with open(Path, "rb") as File:
+        File.seek(Size - 1)
+        return File.read(1) in (b"\n", b"\r")
+
+class LiveTable:
+    # Referenced columns of a CSV file, Offset is the end of the last complete row read
+    def __init__(self, Path, Seperator, Decimal, Names):
+        self.Path, self.Seperator, self.Decimal = Path, Seperator, Decimal
+        self.Names = list(dict.fromkeys(Names))
+        Key = data_cache.TableKey(Path, Seperator, Decimal)
+        Data = data_cache.GetTable(Path, Seperator, Decimal, self.Names)
+        Header = list(Data.keys())
+        self.Indices = [Header.index(Name) for Name in self.Names]
+        self.Reset()
+
+        # Start from the already parsed table if the file did not change meanwhile
+        if Key == data_cache.TableKey(Path, Seperator, Decimal) and EndsWithLineBreak(Path, Key[1]):
+            for Name in self.Names: self.Columns[Name].Append(Numeric(Data[Name]))
+            self.Offset = Key[1]
+        else: self.Update()
+
+    def Reset(self):
+        self.Columns = {Name: GrowingColumn() for Name in self.Names}
+        self.Offset = 0
+
+    def Update(self):
+        # Returns the number of new rows, None if the file was truncated or replaced
+        Size = os.path.getsize(self.Path)
+        if Size < self.Offset: return None
+        if Size == self.Offset: return 0
+        Columns, self.Offset = data_cache.ezdata.read_rows(self.Path, self.Seperator, self.Decimal,
+                                                           self.Indices, self.Offset)
+        for Name, Column in zip(self.Names, Columns): self.Columns[Name].Append(data_cache.ColumnArray(Column))
+        return len(Columns[0]) if Columns else 0
+
+    def __len__(self):
+        return self.Columns[self.Names[0]].Size if self.Names else 0
+
+    def keys(self):
+        return self.Names
+
+    def __getitem__(self, Name):
+        return self.Columns[Name].Values
+
+def ExpandLimits(Limits, Low, High, Log):
+    # New limits which include [Low, High], None if they already do
+    Lo, Hi = sorted(Limits)
+    if Low >= Lo and High <= Hi: return None
+    if Log: Lo, Hi, Low, High = np.log10(Lo), np.log10(Hi), np.log10(Low), np.log10(High)
+    NewLo, NewHi = min(Lo, Low), max(Hi, High)
+    Extra = (NewHi - NewLo) * Headroom
+    if Low < Lo: NewLo -= Extra
+    if High > Hi: NewHi += Extra
+    if Log: NewLo, NewHi = 10**NewLo, 10**NewHi
+    if Limits[0] > Limits[1]: return NewHi, NewLo
+    return NewLo, NewHi
+
+class LivePlot:
+    # Series: columns, styles and artists of every data series as returned by plot.PlotFigure
+    # Refit(Data): renews the fit lines with the grown columns, None if nothing is fitted
+    # Fixed: (x, y) whether the limits of the axis were set by the user
+    def __init__(self, Figure, Table, Series, Refit, Fixed):
+        self.Figure, self.Table, self.Series, self.Refit, self.Fixed = Figure, Table, Series, Refit, Fixed
+        self.Shown = len(Table)
+        self.Tails = [] # Artists of the incremental updates since the last merge
+        self.Updates = 0
+        self.Drawn = False
+        self.FitPending = False
+        self.LastFit = time.monotonic()
+        for s in Series: s["Last"] = self.LastPoint(s)
+        self.Connections = [Figure.canvas.mpl_connect("draw_event", self.OnDraw),
+                            Figure.canvas.mpl_connect("close_event", lambda Event: self.Stop())]
+        self.Timer = Figure.canvas.new_timer(interval=Interval)
+        self.Timer.add_callback(self.Tick)
+        self.Timer.start()
+
+    def Stop(self):
+        self.Timer.stop()
+        for Connection in self.Connections: self.Figure.canvas.mpl_disconnect(Connection)
+        self.Connections = []
+
+    def OnDraw(self, Event):
+        self.Drawn = True
+
+    def SeriesData(self, s, Start):
+        # Points of a series from row Start on, without missing y values
+        xCol, yCol, xErrCol, yErrCol = s["Columns"]
+        x, y = self.Table[xCol][Start:], self.Table[yCol][Start:]
+        xErr = self.Table[xErrCol][Start:] if type(xErrCol) == str else xErrCol
+        yErr = self.Table[yErrCol][Start:] if type(yErrCol) == str else yErrCol
+        Valid = ~np.isnan(y)
+        if Valid.all(): return x, y, xErr, yErr
+        if isinstance(xErr, np.ndarray): xErr = xErr[Valid]
+        if isinstance(yErr, np.ndarray): yErr = yErr[Valid]
+        return x[Valid], y[Valid], xErr, yErr
+
+    def LastPoint(self, s):
+        x, y, _, _ = self.SeriesData(s, 0)
+        return (x[-1], y[-1]) if len(y) else None
+
+    def Tick(self):
+        try:
+            New = self.Table.Update()
+        except OSError:
+            return # File is replaced or locked by the writer right now, try again next time
+        Redraw = False
+        if New is None:
+            self.Table.Reset()
+            self.Table.Update()
+            self.Shown = 0
+            New = len(self.Table)
+            Redraw = True
+        Start, self.Shown = self.Shown, len(self.Table)
+
+        Added = []
+        if New:
+            self.FitPending = True
+            if not Redraw:
+                Added = self.AddPoints(Start)
+                self.Updates += 1
+            if self.Rescale(0 if Redraw else Start): Redraw = True
+
+        if self.FitPending and self.Refit and time.monotonic() - self.LastFit >= FitInterval:
+            # Fits print their parameters, which would pile up in the output of EzPlot
+            with contextlib.redirect_stdout(io.StringIO()):
+                try: self.Refit(self.Table)
+                except Exception: pass # Not fittable yet, the last fit is kept removed until it works again
+            self.LastFit = time.monotonic()
+            self.FitPending = False
+            Redraw = True
+
+        if Redraw or self.Updates >= MergeUpdates: self.Merge()
+        elif Added: self.Blit(Added)
+
+    def AddPoints(self, Start):
+        # Draw the new rows with extra artists, returns (axes, artist) of everything to blit
+        Added = []
+        for s in self.Series:
+            x, y, xErr, yErr = self.SeriesData(s, Start)
+            if not len(y): continue
+            for ax, _, _, _ in s["Artists"]:
+                Scatter = ax.scatter(x=x, y=y, **s["Scatter"])
+                Errorbar = ax.errorbar(x, y, yerr=yErr, xerr=xErr, **s["Errorbar"])
+                self.Tails += [Scatter, Errorbar]
+                Added += [(ax, Scatter)] + [(ax, Child) for Child in Errorbar.get_children()]
+                if s["Line"]:
+                    # Continue the connecting line from the last point shown
+                    xLine, yLine = (np.r_[s["Last"][0], x], np.r_[s["Last"][1], y]) if s["Last"] else (x, y)
+                    Line, = ax.plot(xLine, yLine, **s["Line"])
+                    self.Tails.append(Line)
+                    Added.append((ax, Line))
+            s["Last"] = (x[-1], y[-1])
+        return Added
+
+    def Rescale(self, Start):
+        # Expand the view of the main axes to the new points, True if the limits changed
+        ax = self.Series[0]["Artists"][0][0]
+        Changed = False
+        for Axis, Fixed, GetLimits, SetLimits, Scale in ((0, self.Fixed[0], ax.get_xlim, ax.set_xlim, ax.get_xscale()),
+                                                        (1, self.Fixed[1], ax.get_ylim, ax.set_ylim, ax.get_yscale())):
+            if Fixed: continue
+            Values = np.concatenate([self.SeriesData(s, Start)[Axis] for s in self.Series])
+            Values = Values[np.isfinite(Values)]
+            if Scale == "log": Values = Values[Values > 0]
+            if not len(Values): continue
+            Limits = ExpandLimits(GetLimits(), Values.min(), Values.max(), Scale == "log")
+            if Limits:
+                SetLimits(Limits)
+                Changed = True
+        return Changed
+
+    def Merge(self):
+        # Replace the incremental artists by the data of the series artists and redraw everything
+        for Artist in self.Tails: Artist.remove()
+        self.Tails = []
+        for s in self.Series:
+            x, y, xErr, yErr = self.SeriesData(s, 0)
+            Artists = []
+            for ax, Scatter, Errorbar, Line in s["Artists"]:
+                Scatter.set_offsets(np.column_stack((x, y)))
+                Errorbar.remove()
+                Errorbar = ax.errorbar(x, y, yerr=yErr, xerr=xErr, **s["Errorbar"])
+                if Line: Line.set_data(x, y)
+                Artists.append((ax, Scatter, Errorbar, Line))
+            s["Artists"] = Artists
+            s["Last"] = (x[-1], y[-1]) if len(y) else None
+        self.Updates = 0
+        self.Figure.canvas.draw_idle()
+
+    def Blit(self, Added):
+        # Draw only the new artists onto the last rendered figure
+        Canvas = self.Figure.canvas
+        if not (self.Drawn and Canvas.supports_blit):
+            Canvas.draw_idle()
+            return
+        Axes = []
+        for ax, Artist in Added:
+            ax.draw_artist(Artist)
+            if ax not in Axes: Axes.append(ax)
+        for ax in Axes: Canvas.blit(ax.bbox)
+
+def Start(Figure, Sources, Series, Refit, Fixed):
+    # Follow the data file of the plot until its window is closed
+    # Sources: (Path, Seperator, Decimal) of the data files of the series
+    global Current
+    Stop()
+    if len(Sources) != 1:
+        print("Live update is only available for plots of a single data file")
+        return
+    Path, Seperator, Decimal = next(iter(Sources))
+    if not data_cache.ezdata or not Path.endswith("csv"):
+        print("Live update is only available for CSV files")
+        return
+    Names = [Column for s in Series for Column in s["Columns"] if type(Column) == str]
+    Table = LiveTable(Path, Seperator, Decimal, Names)
+    Current = LivePlot(Figure, Table, Series, Refit, Fixed)
+
+def Stop():
+    global Current
+    if Current: Current.Stop()
+    Current = None
@@ -7,7 +7,7 @@
 # Python plotting and fitting script by Ezodox
 # v1.0.0
 # Licence: MIT License
-# required packages: matplotlib, scipy, scikit-learn, pandas, numpy
+# required packages: matplotlib, scipy, pandas, numpy
 
 import numpy as np
 import pandas as pd
@@ -15,11 +15,21 @@ import matplotlib.pyplot as plt
 import matplotlib.ticker as ticker
 import scipy as sp
 from scipy import odr
-from sklearn.metrics import r2_score
 import math
 from matplotlib.patches import ConnectionPatch
+from matplotlib._pylab_helpers import Gcf
 import copy
 import os
+import io
+import contextlib
+import itertools
+import warnings
+from python_modules import data_cache
+from python_modules import live
+from python_modules import fit_cache
+
+# EzPlot creates and shows all figures on its Python thread, which is not the main thread:
+warnings.filterwarnings("ignore", message="Starting a Matplotlib GUI outside of the main thread")
 
 # In[2]:
 
@@ -122,83 +132,32 @@ def LSpErr(res):
 # CV: Calculate Goodness of Fit with cross validation?
 # FitOrders can be a list over multiple data sets
 # FitOrdersZoom can be a list over zoom sets 
+# xRanges: (min, max) of x per data set from the column statistics, fills open ends of Area
+# Solved: result of SolveFit from the last plot, the fit is only drawn with it then
+# Cached: take the result from fit_cache and keep it there, False for throwaway fits (live updates)
 
 def ApplyFit(xDatas, yDatas, xErrors, yErrors, func, sParams, LatexFuncs=None, LatexParams=None, DataNo = 0, Area = None, 
              Color = "blue", Name=None, ExArea = (0,0), pArea=None, Line="-", ExEr=True, 
              pRes=False, Bounds=(-np.inf,np.inf), Method="lm", LogFit = False, LogBase = np.exp, 
              Loss = False, LossScale = 1, odrType = 0, CV = False, FitLinewidth = 3, FitOrder = 3, 
-             FitOrdersZoom = 3):
+             FitOrdersZoom = 3, xRanges = None, Solved = None, Cached = True):
 
-    if Line == "dashdotdot": Line = (0, (3, 5, 1, 5, 1, 5))
-    elif Line == "densely dashed": Line = (0, (5, 1))
+    Line = LineStyle(Line)
     if LogFit == False: LogBase = False
     
-    # Select Fit area
-    xData, yData, xError, yError = xDatas, yDatas, xErrors, yErrors
-    if type(xDatas) == list: xData = xDatas[DataNo]
-    if type(yDatas) == list: yData = yDatas[DataNo]
-    if type(xErrors) == list: xError = xErrors[DataNo]
-    if type(yErrors) == list: yError = yErrors[DataNo]
-    if type(xError) == list: xError = np.resize(xError,len(yError))
-    xData = np.array(xData)
-    yData = np.array(yData)
-
-    # Remove every point without a y value
-    xData = xData[~np.isnan(yData)]
-    if isinstance(xError, pd.Series): xError = xError[~np.isnan(yData)]
-    if isinstance(yError, pd.Series): yError = yError[~np.isnan(yData)]
-    yData = yData[~np.isnan(yData)]
-    
-    if Area == None: Area = (min(xData),max(xData))
-    x_fit = xData[(xData >= Area[0]) & (xData <= Area[1]) & ((xData<=ExArea[0]) | (xData>=ExArea[1]))]
-    y_fit = yData[(xData >= Area[0]) & (xData <= Area[1]) & ((xData<=ExArea[0]) | (xData>=ExArea[1]))]
-    xErr_fit = xError
-    yErr_fit = yError
-    if isinstance(xErr_fit, (int,float,np.floating)):
-        if xErr_fit == 0: xErr_fit = None
-        else: xErr_fit = np.full(len(x_fit),xError)
-    else:
-        xError = np.array(xError)
-        xErr_fit = xError[(xData >= Area[0]) & (xData <= Area[1]) & ((xData<=ExArea[0]) | (xData>=ExArea[1]))]
-    if isinstance(yErr_fit, (int,float,np.floating)):
-        if yErr_fit == 0: yErr_fit = None
-        else: yErr_fit = np.full(len(y_fit),yError)
-    else:
-        yError = np.array(yError)
-        yErr_fit = yError[(xData >= Area[0]) & (xData <= Area[1]) & ((xData<=ExArea[0]) | (xData>=ExArea[1]))]
-        
-    # Add small Error to all Errors to prevent division by zero
-    if isinstance(xErr_fit, np.ndarray): xErr_fit = xErr_fit + 1e-10
-    if isinstance(yErr_fit, np.ndarray): yErr_fit = yErr_fit + 1e-10
-    
-    # Calculate fit parameters
-    p,perr,pcov = CalcFit(func, sParams, x_fit, y_fit, xErr_fit, yErr_fit, method=Method, 
-                            LogBase=LogBase, bounds=Bounds, loss=Loss, scale=LossScale, odrType=odrType)
-    
     # Print Name of Fit
     if Name: print(Name+":")
-    
-    # Get parameter names
-    pNames = func.__code__.co_varnames
-    
-    # Print found fit parameters
-    print("      Parameters:")
-    for i in range(len(p)):
-        print("""
-            {0} = {1:.10g} +- {2:.10g}
-        """.format(pNames[i+1],p[i],perr[i]))
 
-    #if not ExEr: 
-    #    x_fit = xData
-    #    y_fit = yData
-    #    yErr_fit = yError
-    #    xErr_fit = xError
-        
-    FitParams, MeanLine = CalcFitEr(x_fit, y_fit, xErr_fit, yErr_fit, func, params=p, 
-                                    LatexFuncs=LatexFuncs, LatexParams=LatexParams, 
-                                    pErr=perr, pRes=pRes, CV=CV, method=Method, 
-                                    LogBase=LogBase, bounds=Bounds, loss=Loss, 
-                                    scale=LossScale, Name = "Fit 1")
+    # The result of the last plot is only drawn again, unless the fit function changed meanwhile
+    if Solved is None or Solved["Func"] != func.__code__:
+        Solved = SolveFit(xDatas, yDatas, xErrors, yErrors, func, sParams, LatexFuncs, LatexParams, DataNo,
+                          Area, ExArea, pRes, Bounds, Method, LogBase, Loss, LossScale, odrType, CV, xRanges, Cached)
+    else:
+        # The residuals are not kept with the result, they are calculated again from the fitted rows
+        Rows = FitChunks = None
+        if pRes: _, Rows, FitChunks = SelectFit(xDatas, yDatas, xErrors, yErrors, DataNo, Solved["Area"], ExArea, xRanges)
+        PrintOutput(Solved, func, pRes, LogBase, Rows, FitChunks)
+    p, Area, FitParams = Solved["p"], Solved["Area"], Solved["FitParams"]
     
     ax = plt.gca()
     if type(pArea) == str:
@@ -247,9 +206,9 @@ def ApplyFit(xDatas, yDatas, xErrors, yErrors, func, sParams, LatexFuncs=None, L
     y_p1 = func(x_p1, *tuple(p))
     y_p2 = func(x_p2, *tuple(p))
 
-    # Plot Fitfunction
-    FitLine, = plt.plot(x_p1, y_p1, marker='None', linestyle=Line, color=Color, zorder=FitOrder, linewidth=FitLinewidth)
-    plt.plot(x_p2, y_p2, marker='None', linestyle=Line, color=Color, zorder=FitOrder, linewidth=FitLinewidth)
+    # Plot Fitfunction, its lines are tagged for Restyle
+    FitLine, = plt.plot(x_p1, y_p1, marker='None', linestyle=Line, color=Color, zorder=FitOrder, linewidth=FitLinewidth, gid="Fit")
+    plt.plot(x_p2, y_p2, marker='None', linestyle=Line, color=Color, zorder=FitOrder, linewidth=FitLinewidth, gid="Fit")
 
     fig = plt.gcf()
     Axes = fig.get_axes()
@@ -257,8 +216,8 @@ def ApplyFit(xDatas, yDatas, xErrors, yErrors, func, sParams, LatexFuncs=None, L
         FitOrderZoom = FitOrdersZoom
         for sub in Axes:
             if type(FitOrdersZoom) == list: FitOrderZoom = FitOrdersZoom[Axes.index(sub)]
-            sub.plot(x_p1, y_p1, marker='None', linestyle=Line, color=Color, zorder=FitOrderZoom, linewidth=FitLinewidth)
-            sub.plot(x_p2, y_p2, marker='None', linestyle=Line, color=Color, zorder=FitOrderZoom, linewidth=FitLinewidth)
+            sub.plot(x_p1, y_p1, marker='None', linestyle=Line, color=Color, zorder=FitOrderZoom, linewidth=FitLinewidth, gid="Fit")
+            sub.plot(x_p2, y_p2, marker='None', linestyle=Line, color=Color, zorder=FitOrderZoom, linewidth=FitLinewidth, gid="Fit")
     
     # if fitted an underground plot it
     UnderLine = False
@@ -282,8 +241,179 @@ def ApplyFit(xDatas, yDatas, xErrors, yErrors, func, sParams, LatexFuncs=None, L
             for sub in Axes:
                 sub.plot(x_p1, y_p1, marker='None', linestyle="--", color="red", zorder=FitOrder, linewidth=FitLinewidth)
                 sub.plot(x_p2, y_p2, marker='None', linestyle="--", color="red", zorder=FitOrder, linewidth=FitLinewidth)
+
+    # Mean of skewed functions
+    MeanLine = False
+    for Mean in Solved["Means"]:
+        for sub in Axes:
+            Line = sub.axvline(x = Mean, color = "green")
+            if not MeanLine: MeanLine = Line
         
-    return FitLine, UnderLine, MeanLine, FitParams
+    return FitLine, UnderLine, MeanLine, FitParams, Solved
+
+def LineStyle(Line):
+    # Matplotlib line style of the Line fit setting
+    if Line == "dashdotdot": return (0, (3, 5, 1, 5, 1, 5))
+    if Line == "densely dashed": return (0, (5, 1))
+    return Line
+
+def SolveFit(xDatas, yDatas, xErrors, yErrors, func, sParams, LatexFuncs, LatexParams, DataNo, Area, ExArea, 
+             pRes, Bounds, Method, LogBase, Loss, LossScale, odrType, CV, xRanges, Cached=True):
+    # Fit stage of ApplyFit, everything but drawing. Returns the result which ApplyFit draws:
+    # parameters with errors and covariance, fitted area, parameters for latex, x of the mean
+    # lines, goodness of fit and the printed output. Results are taken from fit_cache if the same
+    # rows were fitted with the same function and settings before, unless Cached is False.
+
+    Area, (x_fit, y_fit, xErr_fit, yErr_fit), FitChunks = SelectFit(xDatas, yDatas, xErrors, yErrors, DataNo,
+                                                                    Area, ExArea, xRanges)
+    
+    # Results are cached by the fitted rows, out-of-core series are hashed chunk by chunk
+    Key = None
+    if Cached:
+        Rows = [(x_fit, y_fit, xErr_fit, yErr_fit)]
+        if FitChunks: Rows = itertools.chain(Rows, FitChunks())
+        Latex = ((LatexFuncs or {}).get(func.__name__), (LatexParams or {}).get(func.__name__))
+        Key = fit_cache.Key(func, Rows, sParams=sParams, Area=Area, ExArea=ExArea, Bounds=Bounds, Method=Method,
+                            LogBase=LogBase, Loss=Loss, LossScale=LossScale, odrType=odrType, CV=CV, pRes=pRes, Latex=Latex)
+    Rows = (x_fit, y_fit, xErr_fit, yErr_fit)
+
+    Result = fit_cache.Get(Key) if Cached else None
+    if Result is not None:
+        PrintOutput(Result, func, pRes, LogBase, Rows, FitChunks)
+        return dict(Result, Func=func.__code__, Area=Area)
+
+    # The output is kept with the result, it is printed again when the result is reused
+    Output = io.StringIO()
+    ResidualsAt = None
+    def MarkResiduals():
+        nonlocal ResidualsAt
+        ResidualsAt = Output.tell()
+    try:
+        with contextlib.redirect_stdout(Output):
+            # Calculate fit parameters
+            p,perr,pcov = CalcFit(func, sParams, x_fit, y_fit, xErr_fit, yErr_fit, method=Method, 
+                                    LogBase=LogBase, bounds=Bounds, loss=Loss, scale=LossScale, odrType=odrType)
+
+            # Get parameter names
+            pNames = func.__code__.co_varnames
+
+            # Print found fit parameters
+            print("      Parameters:")
+            for i in range(len(p)):
+                print("""
+            {0} = {1:.10g} +- {2:.10g}
+        """.format(pNames[i+1],p[i],perr[i]))
+
+            #if not ExEr: 
+            #    x_fit = xData
+            #    y_fit = yData
+            #    yErr_fit = yError
+            #    xErr_fit = xError
+
+            FitParams, Means, Stats = CalcFitEr(x_fit, y_fit, xErr_fit, yErr_fit, func, params=p, 
+                                                LatexFuncs=LatexFuncs, LatexParams=LatexParams, 
+                                                pErr=perr, pRes=MarkResiduals if pRes else False, CV=CV, 
+                                                method=Method, LogBase=LogBase, bounds=Bounds, loss=Loss, 
+                                                scale=LossScale, Name = "Fit 1", Chunks=FitChunks)
+    except BaseException:
+        print(Output.getvalue(), end="")
+        raise
+
+    Result = {"p": p, "perr": perr, "pcov": pcov, "FitParams": FitParams, "Means": Means, "Stats": Stats,
+              "Output": Output.getvalue(), "ResidualsAt": ResidualsAt}
+    if Cached: fit_cache.Put(Key, Result)
+    PrintOutput(Result, func, pRes, LogBase, Rows, FitChunks)
+    return dict(Result, Func=func.__code__, Area=Area)
+
+def SelectFit(xDatas, yDatas, xErrors, yErrors, DataNo, Area, ExArea, xRanges):
+    # Fit area and rows of series DataNo: the area with its open limits filled in, the fitted rows
+    # (x, y, x errors, y errors) and a function returning the chunks of all fit rows of an
+    # out-of-core series, None if the fitted rows are all of them
+
+    # Select Fit area
+    xData, yData, xError, yError = xDatas, yDatas, xErrors, yErrors
+    if type(xDatas) == list: xData = xDatas[DataNo]
+    if type(yDatas) == list: yData = yDatas[DataNo]
+    if type(xErrors) == list: xError = xErrors[DataNo]
+    if type(yErrors) == list: yError = yErrors[DataNo]
+    if type(xError) == list: xError = np.resize(xError,len(yError))
+    xData = np.asarray(xData)
+    yData = np.asarray(yData)
+    
+    if Area == None or None in Area:
+        xRange = xRanges[DataNo] if type(xRanges) == list else xRanges
+        if xRange is None: xRange = data_cache.ValueRange(xData, yData)
+        if Area == None: Area = xRange
+        else: Area = tuple(Range if Limit is None else Limit for Limit, Range in zip(Area, xRange))
+
+    # Out-of-core series are fitted with evenly spread rows which fit into the memory budget,
+    # the residuals of all rows are summed up chunk by chunk afterwards
+    Sample = slice(None)
+    if data_cache.OutOfCore() and len(xData) > data_cache.ChunkRows(4):
+        Sample = slice(None, None, -(-len(xData) // data_cache.ChunkRows(4)))
+    x_fit, y_fit, xErr_fit, yErr_fit = FitRows(xData, yData, xError, yError, Area, ExArea, Sample)
+    FitChunks = None
+    if Sample.step:
+        FitChunks = lambda: (FitRows(xData, yData, xError, yError, Area, ExArea, Rows)
+                             for Rows in data_cache.Chunks(len(xData), 4))
+    return Area, (x_fit, y_fit, xErr_fit, yErr_fit), FitChunks
+
+def PrintOutput(Result, func, pRes, LogBase, Rows, FitChunks):
+    # Output of a fit result, the residuals are not kept with it. They are calculated again from
+    # the parameters and the fitted rows (Rows and FitChunks as returned by SelectFit).
+    At = Result.get("ResidualsAt")
+    if At is None: At = len(Result["Output"])
+    print(Result["Output"][:At], end="")
+    if pRes: PrintResiduals(FitChunks() if FitChunks else [Rows], func, Result["p"], LogBase, Rows[3])
+    print(Result["Output"][At:], end="")
+
+def FitRows(xData, yData, xError, yError, Area, ExArea, Rows=slice(None)):
+    # x, y and errors of the rows in Rows which lie in the fit area and have a y value, prepared for
+    # the solvers. Constant errors become columns, an error of 0 is None.
+    x, y = xData[Rows], yData[Rows]
+    Inside = (x >= Area[0]) & (x <= Area[1]) & ((x<=ExArea[0]) | (x>=ExArea[1])) & ~np.isnan(y)
+    Fit = [x[Inside], y[Inside]]
+    for Error in (xError, yError):
+        if isinstance(Error, (int,float,np.floating)):
+            Fit.append(None if Error == 0 else np.full(len(Fit[0]), Error))
+        else: Fit.append(np.asarray(Error)[Rows][Inside])
+
+    # Single precision data is promoted for the solvers, only the fitted rows are copied
+    Fit = [data_cache.Promote(Values) for Values in Fit]
+
+    # Add small Error to all Errors to prevent division by zero
+    for k in (2, 3):
+        if isinstance(Fit[k], np.ndarray): Fit[k] = Fit[k] + 1e-10
+    return tuple(Fit)
+
+def PrintResiduals(Chunks, func, params, LogBase, yerr):
+    # Residuals are calculated again chunk by chunk, they are not kept for out-of-core series
+    YErrNotZero = yerr is not None and not (type(yerr) == float and yerr == 0)
+    if YErrNotZero:
+        #GoodRes = nRes[nRes <= 3]
+        #NumGoodRes = len(GoodRes)
+        #MgRes = np.mean(GoodRes)
+        print("      ----------Normalized Residuals----------")
+    else: print("      ----------Residuals----------")
+    for Residuals, y, ModelY, ye in ChunkResiduals(Chunks, func, params, LogBase):
+        if LogBase: Residuals = np.abs(ModelY - y)
+        if YErrNotZero: Residuals = Residuals/ye # normalized Residuals
+        for r in Residuals: print("      "+str(r))
+    if YErrNotZero: print("      ----------------------------------------")
+    else: print("      -----------------------------")
+
+def ChunkResiduals(Chunks, func, params, LogBase=False):
+    # (absolute residuals, y, model y, y errors) of every chunk of fit rows. For log fits y, model y
+    # and errors are in log scale, the residuals stay linear.
+    for xdat, ydat, xerr, yerr in Chunks:
+        ModelY = func(xdat, *tuple(params))
+        Residuals = np.abs(ModelY - ydat)
+        if LogBase:
+            Valid = (ModelY != 0) & (ydat != 0)
+            if isinstance(yerr, np.ndarray): yerr = yerr[Valid] / ydat[Valid] # Propagation of uncertainty: error of log(y) is yerr / y
+            ModelY = np.log(ModelY[Valid]) / np.log(LogBase)
+            ydat = np.log(ydat[Valid]) / np.log(LogBase)
+        yield Residuals, ydat, ModelY, yerr
 
 def CalcFit(func, params, xdat, ydat, xerr, yerr, method="lm", LogBase=False, bounds=(-np.inf,np.inf), 
             loss=False, scale=1, odrType=0):
@@ -327,7 +457,11 @@ def CalcFit(func, params, xdat, ydat, xerr, yerr, method="lm", LogBase=False, bo
 
 def CalcFitEr(xdat, ydat, xerr, yerr, func, params, LatexFuncs=None, LatexParams=None, pErr=0, 
               pRes=True, CV=False, method="lm", LogBase=False, bounds=(-np.inf,np.inf), loss=False, 
-              scale=1, Name="Fit 1"):
+              scale=1, Name="Fit 1", Chunks=None):
+    # Chunks: function returning the chunks (x, y, xerr, yerr) of all fit rows of an out-of-core
+    # series, the statistics are summed up over them. xdat, ... are the fitted sample then.
+    # pRes: print the residuals, a function is called in their place instead (SolveFit prints them).
+    # Returns the parameters for latex, x of the means of skewed functions and the goodness of fit.
     
     # Calculate confidence interval with 95%
     #DOF = len(yData)-len(sParams) # Degrees of Freedom = number of data points - number of (non fixed) parameters
@@ -352,49 +486,45 @@ def CalcFitEr(xdat, ydat, xerr, yerr, func, params, LatexFuncs=None, LatexParams
         CVRMSE = np.sqrt(CVMSE) # Root Mean Squared Error, RMSE
         print("      Cross Validation RMSE:", CVRMSE)
     
-    # Calculate RMSE,R-squared and print
-    ModelY = func(xdat, *tuple(params))
-    Residuals = np.abs(ModelY - ydat)
-    SE = np.square(Residuals) # squared errors / residuals
-    MSE = np.mean(SE) # mean squared errors
+    # Calculate RMSE,R-squared and print, the sums are added up chunk by chunk
+    if Chunks is None: Chunks = lambda: [(xdat, ydat, xerr, yerr)]
+    YErrNotZero = yerr is not None and not (type(yerr) == float and yerr == 0)
+    NumData, SE, RSS, Chi2 = 0, 0.0, 0.0, 0.0
+    yCount, yMean, yM2 = 0, 0.0, 0.0 # Mean and squared deviations of y, merged over the chunks
+    for Residuals, y, ModelY, ye in ChunkResiduals(Chunks(), func, params, LogBase):
+        NumData += len(Residuals)
+        SE += np.sum(np.square(Residuals)) # squared errors / residuals
+        RSS += np.sum(np.square(y - ModelY))
+        if len(y):
+            Mean = np.mean(y)
+            Delta = Mean - yMean
+            yM2 += np.sum(np.square(y - Mean)) + Delta**2 * yCount * len(y) / (yCount + len(y))
+            yCount += len(y)
+            yMean += Delta * len(y) / yCount
+        if YErrNotZero:
+            if LogBase: Residuals = np.abs(ModelY - y)
+            Chi2 += np.sum((Residuals/ye)**2) # Chi-squared of the normalized Residuals
+    MSE = SE / NumData # mean squared errors
     RMSE = np.sqrt(MSE) # Root Mean Squared Error, RMSE
     
-    if LogBase:
-        yerr = yerr[ModelY != 0]
-        ModelY = ModelY[ModelY != 0]
-        ydat = ydat[ydat != 0]
-        yerr = yerr / ydat # Propagation of uncertainty: error of log(y) is yerr / y
-        ModelY = np.log(ModelY) / np.log(LogBase)
-        ydat = np.log(ydat) / np.log(LogBase)
-        Residuals = np.abs(ModelY - ydat)
-    
-    R2 = r2_score(ydat, ModelY) # R-squared
-    AdjR2 = 1 - ((1-R2)*(len(xdat)-1)/(len(xdat)-len(params)-1))
-    YErrNotZero =  not (type(yerr) == float and yerr == 0)
+    R2 = 1 - RSS / yM2 if yM2 else float(RSS == 0) # R-squared
+    AdjR2 = 1 - ((1-R2)*(NumData-1)/(NumData-len(params)-1))
     if YErrNotZero:
-        nRes = Residuals/yerr # normalized Residuals
-        Chi2 = np.sum(nRes**2) # Chi-squared
-        DoF = len(xdat) - len(params) # Degrees of Freedom = amount of data - amount of parameters
+        DoF = NumData - len(params) # Degrees of Freedom = amount of data - amount of parameters
         rChi2 = Chi2 / DoF
     
+    Stats = {"RMSE": RMSE, "R2": R2, "AdjR2": AdjR2}
+    if CV: Stats["CVRMSE"] = CVRMSE
+    if YErrNotZero: Stats.update(Chi2=Chi2, rChi2=rChi2)
+    
     print("      RMSE:", RMSE)
     print("      R-squared:", R2)
     print("      Adjusted R-squared:", AdjR2)
     if YErrNotZero:
         print("      Chi-squared:",Chi2)
         print("      Reduced Chi-squared:",rChi2)
-    if pRes:
-        if YErrNotZero:
-            #GoodRes = nRes[nRes <= 3]
-            #NumGoodRes = len(GoodRes)
-            #MgRes = np.mean(GoodRes)
-            print("      ----------Normalized Residuals----------")
-            for r in nRes: print("      "+str(r))
-            print("      ----------------------------------------")
-        else:
-            print("      ----------Residuals----------")
-            for r in Residuals: print("      "+str(r))
-            print("      -----------------------------")
+    if callable(pRes): pRes()
+    elif pRes: PrintResiduals(Chunks(), func, params, LogBase, yerr)
     print("")
     FitParams = None
     if LatexFuncs and LatexParams: 
@@ -412,7 +542,7 @@ def CalcFitEr(xdat, ydat, xerr, yerr, func, params, LatexFuncs=None, LatexParams
             FitParams[Name]["Params"].append("R^2")
             FitParams[Name]["ParamVals"] = np.append(FitParams[Name]["ParamVals"],AdjR2)
             FitParams[Name]["ParamErrs"] = np.append(FitParams[Name]["ParamErrs"],0)
-    MeanLine = False
+    Means = [] # x of the mean of skewed functions, ApplyFit draws lines there
     if "Voigt" in func.__name__:
         NumVoigts = 1
         UnderLen = 0
@@ -508,16 +638,9 @@ def CalcFitEr(xdat, ydat, xerr, yerr, func, params, LatexFuncs=None, LatexParams
             if NumSkewed == 2: NumSkewedStr = str(i+1)
             print("      Mean {0}: {1:.10g} +- {2:.10g}".format(NumSkewedStr, Mean, MeanErr))
             print("      MeanY {0}: {1:.10g} +- {2:.10g}".format(NumSkewedStr, MeanY, MeanYErr))
-            
-            fig = plt.gcf()
-            Axes = fig.get_axes()
-            for sub in Axes:
-                if not MeanLine:
-                    MeanLine = sub.axvline(x = Mean, color = "green")
-                else:
-                    sub.axvline(x = Mean, color = "green")
+            Means.append(Mean)
         
-    return FitParams, MeanLine
+    return FitParams, Means, Stats
          
 def SaveParamsAsLatex(FitParams, FilePath = ""):
     Alignment, Names, Funcs, TitleLine, Titles = "","","","",""
@@ -629,52 +752,86 @@ def SaveParamsAsLatex(FitParams, FilePath = ""):
             f.write(line)
             f.write("\n")
 
-def PickData(DataInfos):
-    
-    Path = DataInfos["Path"]
-    xColumns = DataInfos["xColumns"]
-    yColumns = DataInfos["yColumns"]
-    xErrorColumns = DataInfos["xErrorColumns"]
-    yErrorColumns = DataInfos["yErrorColumns"]
-    Seperator = DataInfos["Seperator"]
-    Decimal = DataInfos["Decimal"]
-    
-    if Path.endswith("xlsx"):
-        Data = pd.read_excel(Path)
-    elif Path.endswith("csv"):
-        Data = pd.read_csv(Path, sep=Seperator, decimal=Decimal)
-    if type(xColumns) == list:
-        xDatas = []
-        for col in xColumns: xDatas.append(Data[col])
-    else: xDatas = Data[xColumns]
-        
-    if type(yColumns) == list:
-        yDatas = []
-        for col in yColumns: yDatas.append(Data[col])
-    else: yDatas = Data[yColumns]
-        
-    if type(xErrorColumns) == list:
-        xErrors = []
-        for col in xErrorColumns: 
-            if type(col) == str:
-                if col == "[NULL]": xErrors.append(0)
-                else: xErrors.append(Data[col])
-            else: xErrors.append(col)
-    elif type(xErrorColumns) == str: xErrors = Data[xErrorColumns]
-    else: xErrors = xErrorColumns
-        
-    if type(yErrorColumns) == list:
-        yErrors = []
-        for col in yErrorColumns: 
-            if type(col) == str:
-                if col == "[NULL]": yErrors.append(0)
-                else: yErrors.append(Data[col])
-            else: yErrors.append(col)
-    elif type(yErrorColumns) == str: yErrors = Data[yErrorColumns]
-    else: yErrors = yErrorColumns
-        
+def NumSeries(DataInfos):
+    return len(DataInfos["yColumns"]) if type(DataInfos["yColumns"]) == list else 1
+
+def PrepareData(DataInfos):
+    # Parse the referenced columns of every data file, also called on the loading thread before
+    # plotting. Returns the table of each data series, series of the same file share it.
+    Requests = {}
+    for i in range(NumSeries(DataInfos)):
+        Names = Requests.setdefault(SeriesSource(DataInfos, i), [])
+        Names += [Column for Column in SeriesColumns(DataInfos, i) if type(Column) == str]
+    Tables = data_cache.GetTables(Requests)
+    return [Tables[SeriesSource(DataInfos, i)] for i in range(NumSeries(DataInfos))]
+
+def SeriesTables(DataInfos, Data):
+    # Table of each data series, a single table holds all of them (live updates)
+    if Data is None: return PrepareData(DataInfos)
+    if type(Data) == list: return Data
+    return [Data] * NumSeries(DataInfos)
+
+def PickData(DataInfos, Data = None):
+    # Data: tables of the data series, taken from the cache if not given.
+    # Rows without a y value are already removed from every series, cached tables keep the
+    # filtered series, so plotting and every fit use them without masking again.
+    Data = SeriesTables(DataInfos, Data)
+    Series = [data_cache.SeriesData(Data[i], *SeriesColumns(DataInfos, i)) for i in range(NumSeries(DataInfos))]
+    if type(DataInfos["yColumns"]) != list: return Series[0]
+    xDatas, yDatas, xErrors, yErrors = (list(Values) for Values in zip(*Series))
     return xDatas, yDatas, xErrors, yErrors
+
+def DataLimits(DataInfos):
+    # (xMin, xMax, yMin, yMax) of all plotted columns from the statistics of the cached table,
+    # shown as hints of the empty limits. None where a limit is not known.
+    Data = PrepareData(DataInfos)
+    Limits = []
+    for Axis in (0, 1):
+        Columns = [(Data[i], SeriesColumns(DataInfos, i)[Axis]) for i in range(NumSeries(DataInfos))]
+        Stats = [Table.Stats(Column) for Table, Column in Columns if type(Column) == str]
+        Stats = [Stat for Stat in Stats if Stat and Stat["Count"]]
+        Limits += [min(Stat["Min"] for Stat in Stats), max(Stat["Max"] for Stat in Stats)] if Stats else [None, None]
+    return tuple(Limits)
+
+def SeriesSource(DataInfos, i):
+    # (Path, Seperator, Decimal) of the data file of the i-th data series, without per series
+    # files all series come from Path
+    if type(DataInfos.get("Paths")) == list and i < len(DataInfos["Paths"]):
+        return (DataInfos["Paths"][i], DataInfos["Seperators"][i], DataInfos["Decimals"][i])
+    return (DataInfos["Path"], DataInfos["Seperator"], DataInfos["Decimal"])
+
+def SeriesColumns(DataInfos, i):
+    # Column names (or constant errors) of the i-th data series
+    Columns = []
+    for Key in ("xColumns", "yColumns", "xErrorColumns", "yErrorColumns"):
+        Column = DataInfos[Key]
+        if type(Column) == list: Column = Column[i]
+        if type(Column) == str and Column == "[NULL]": Column = 0
+        Columns.append(Column)
+    return tuple(Columns)
             
+DecimatedPoints = 1 << 16 # Plotted points of an out-of-core data series at most
+
+def DecimateSeries(xData, yData, xError, yError):
+    # Out-of-core series have too many rows to plot them all. Consecutive rows are grouped into
+    # buckets and the rows with the smallest and the largest y of every bucket are kept, so peaks
+    # and the envelope of the data stay visible. The columns are read chunk by chunk.
+    if not data_cache.OutOfCore() or len(yData) <= DecimatedPoints: return xData, yData, xError, yError
+    Bucket = -(-len(yData) // (DecimatedPoints // 2))
+    Step = max(data_cache.ChunkRows(4) // Bucket, 1) * Bucket
+    Kept = []
+    for First in range(0, len(yData), Step):
+        y = np.asarray(yData[First:First + Step], dtype=np.float64)
+        Pad = -len(y) % Bucket
+        for Fill, Pick in ((np.inf, np.argmin), (-np.inf, np.argmax)):
+            Values = np.concatenate((np.where(np.isnan(y), Fill, y), np.full(Pad, Fill))).reshape(-1, Bucket)
+            Picked = Pick(Values, axis=1)
+            Found = Values[np.arange(len(Values)), Picked] != Fill # Buckets without a y value
+            Kept.append(First + np.flatnonzero(Found) * Bucket + Picked[Found])
+    Rows = np.unique(np.concatenate(Kept))
+    return tuple(Values if isinstance(Values, (int,float,np.floating)) or Values is None
+                 else np.asarray(Values)[Rows] for Values in (xData, yData, xError, yError))
+
 #--------------------------------Plot Figure--------------------------------
 def PlotFigure(DataInfos, Settings):
     
@@ -750,6 +907,7 @@ def PlotFigure(DataInfos, Settings):
     NumYData = 1
     if type(yDatas) == list: NumYData = len(yDatas)
     ScatterIDs = []
+    Series = [] # Columns, styles and artists of every data series for live updates
     for i in range(NumYData):
         xData, yData, xError, yError = xDatas, yDatas, xErrors, yErrors
         mSize, mStyle, mColor, mOrder, mAlpha, mConnect = mSizes, mStyles, mColors, mOrders, mAlphas, mConnects
@@ -805,11 +963,7 @@ def PlotFigure(DataInfos, Settings):
         # Rescale xErrors to yErrors
         if type(xError) == list: xError = np.resize(xError,len(yError))
 
-        # Remove every point without a y value
-        xData = xData[~np.isnan(yData)]
-        if isinstance(xError, pd.Series): xError = xError[~np.isnan(yData)]
-        if isinstance(yError, pd.Series): yError = yError[~np.isnan(yData)]
-        yData = yData[~np.isnan(yData)]
+        xData, yData, xError, yError = DecimateSeries(xData, yData, xError, yError)
 
         if Projection == "polar":
             xData = xData * np.pi/180
@@ -817,16 +971,25 @@ def PlotFigure(DataInfos, Settings):
 
         ScatterID = plt.scatter(x=xData, y = yData, s=mSize, marker=mStyle, color=mColor, alpha=mAlpha, zorder=mOrder)
         ScatterIDs = np.append(ScatterIDs, ScatterID)
-        plt.errorbar(xData, yData, yerr=yError, xerr=xError, fmt="none", capsize=ErrCapsize, elinewidth=ErrWidth, 
+        ErrorbarID = plt.errorbar(xData, yData, yerr=yError, xerr=xError, fmt="none", capsize=ErrCapsize, elinewidth=ErrWidth, 
                 markersize=0, color=mColor,alpha = mAlpha)
-        if mConnect: plt.plot(xData, yData,  marker='None', color=mColor, alpha=mAlpha, zorder=mOrder)
+        LineID = None
+        if mConnect: LineID, = plt.plot(xData, yData,  marker='None', color=mColor, alpha=mAlpha, zorder=mOrder)
+        Artists = [(plt.gca(), ScatterID, ErrorbarID, LineID)]
 
         if type(Zoom) == list and len(Zoom) > 0:
             for s in Subs:
-                s.scatter(x=xData, y = yData, s=mSize, marker=mStyle, color=mColor, alpha=mAlpha, zorder=mOrder)
-                s.errorbar(xData, yData, yerr=yError, xerr=xError, fmt="none", capsize=ErrCapsize, elinewidth=ErrWidth, 
+                SubScatter = s.scatter(x=xData, y = yData, s=mSize, marker=mStyle, color=mColor, alpha=mAlpha, zorder=mOrder)
+                SubErrorbar = s.errorbar(xData, yData, yerr=yError, xerr=xError, fmt="none", capsize=ErrCapsize, elinewidth=ErrWidth, 
                     markersize=0, color=mColor,alpha = mAlpha)
-                if mConnect: s.plot(xData, yData,  marker='None', color=mColor, alpha=mAlpha, zorder=mOrder)
+                SubLine = None
+                if mConnect: SubLine, = s.plot(xData, yData,  marker='None', color=mColor, alpha=mAlpha, zorder=mOrder)
+                Artists.append((s, SubScatter, SubErrorbar, SubLine))
+
+        Series.append({"Columns": SeriesColumns(DataInfos, i), "Artists": Artists,
+                       "Scatter": dict(s=mSize, marker=mStyle, color=mColor, alpha=mAlpha, zorder=mOrder),
+                       "Errorbar": dict(fmt="none", capsize=ErrCapsize, elinewidth=ErrWidth, markersize=0, color=mColor, alpha=mAlpha),
+                       "Line": dict(marker='None', color=mColor, alpha=mAlpha, zorder=mOrder) if mConnect else None})
 
     #---------------------Apply settings on plot design-------------------------
 
@@ -995,7 +1158,7 @@ def PlotFigure(DataInfos, Settings):
 
     plt.tight_layout()
     
-    return ScatterIDs
+    return ScatterIDs, Series
 
 #def DeleteFits():
 #    fig = plt.gcf()
@@ -1006,23 +1169,34 @@ def PlotFigure(DataInfos, Settings):
 #        for a in Axes: a.lines.clear()
 #    if ax.get_legend(): ax.get_legend().remove()
         
-def AddFits(DataInfos, FitSettings):
+def AddFits(DataInfos, FitSettings, Data = None, Solved = None, Lines = None, Cached = True):
+    # Solved: results of the fits which are drawn without fitting again, by fit number.
+    # Cached: False for the fits of live updates, their results are not kept in fit_cache.
+    # Lines: filled with the fit lines of every fit number (for Restyle).
+    # Returns the results of all fits in the end.
     FitIDs = []
     FitsParams = {}
     NumFits = FitSettings["NumFits"]
     Underground, MeanLine = False, False
-    xDatas, yDatas, xErrors, yErrors = PickData(DataInfos)
+    Solved, Results = Solved or {}, {}
+    Data = SeriesTables(DataInfos, Data)
+    xDatas, yDatas, xErrors, yErrors = PickData(DataInfos, Data)
+    xRanges = [data_cache.SeriesRange(Data[i], *SeriesColumns(DataInfos, i)[:2]) for i in range(NumSeries(DataInfos))]
     for i in range(NumFits):
         FitArgs = {}
         for key, val in FitSettings.items():
             if val != None and key != "NumFits":
                 if type(val) == list: FitArgs.update({key : val[i]})
                 else: FitArgs.update({key : val})
-        FitID, Underground, MeanLine, FitParams = ApplyFit(xDatas, yDatas, xErrors, yErrors, **FitArgs)
+        Before = set(Line for ax in plt.gcf().get_axes() for Line in ax.lines)
+        FitID, Underground, MeanLine, FitParams, Results[i] = ApplyFit(xDatas, yDatas, xErrors, yErrors, xRanges=xRanges,
+                                                                      Solved=Solved.get(i), Cached=Cached, **FitArgs)
+        if Lines is not None:
+            Lines[i] = [Line for ax in plt.gcf().get_axes() for Line in ax.lines if Line not in Before and Line.get_gid() == "Fit"]
         FitIDs.append(FitID)
         FitsParams.update(FitParams)
     
-    return FitIDs, Underground, MeanLine, FitsParams
+    return FitIDs, Underground, MeanLine, FitsParams, Results
 
 def CreateLegend(PlotSettings, ScatterIDs, FitIDs, Underground, MeanLine):
     ax = plt.gca()
@@ -1101,17 +1275,40 @@ def CreateLegend(PlotSettings, ScatterIDs, FitIDs, Underground, MeanLine):
 #CalcFitEr(xData,yData,xError,yError,FallingExpFit,params=SV_find,pRes=False)
 
 
-def CPlot(DataInfos, PlotSettings, FitFunctions, FitSettings):
+Fits = {} # Results of the fits of the last plot by fit number, CPlot draws them again
+FitSources = None # Data files of the last plot as data_cache.TableKey, the fits are renewed if they change
+Drawn = None # Figure of the last plot and the artists Restyle changes, None if the plot failed
+
+def CPlot(DataInfos, PlotSettings, FitFunctions, FitSettings, Refits = None):
+    # Refits: numbers of the fits whose settings changed since the last plot, the others are
+    # drawn with their last result. None fits everything again (the data changed).
+    global Fits, FitSources, Drawn
 
     FitSettings["func"] = FitFunctions
     
     OutErr = 1
     
-    ScatterIDs = PlotFigure(DataInfos, PlotSettings)
+    CloseFigures() # The window of the last plot is replaced
+    Drawn = None
+    data_cache.SetSinglePrecision(PlotSettings.get("SinglePrecision", False))
+    ScatterIDs, Series = PlotFigure(DataInfos, PlotSettings)
 
-    FitIDs, Underground, MeanLine, FitsParams = AddFits(DataInfos, FitSettings)
+    Sources = [data_cache.TableKey(*SeriesSource(DataInfos, i)) for i in range(NumSeries(DataInfos))]
+    if Refits is None or Sources != FitSources: Fits = {}
+    Solved = {i: Result for i, Result in Fits.items() if i not in (Refits or ())}
+    Fits, FitSources = {}, None # Kept only if all fits succeed
+
+    fig = plt.gcf()
+    FitLines = set(Line for ax in fig.get_axes() for Line in ax.lines)
+    Lines = {}
+    FitIDs, Underground, MeanLine, FitsParams, Solved = AddFits(DataInfos, FitSettings, Solved=Solved, Lines=Lines)
+    FitLines = [Line for ax in fig.get_axes() for Line in ax.lines if Line not in FitLines]
+    Fits, FitSources = Solved, Sources
+    fit_cache.Save()
 
     CreateLegend(PlotSettings, ScatterIDs, FitIDs, Underground, MeanLine)
+    Drawn = {"Figure": fig, "Axes": plt.gca(), "ScatterIDs": ScatterIDs, "FitIDs": FitIDs,
+             "Underground": Underground, "MeanLine": MeanLine, "Lines": Lines}
 
     LocalDataPath = os.getenv('LOCALAPPDATA') + "\\Ezodox\\EzPlot"
     if not os.path.exists(LocalDataPath):
@@ -1120,8 +1317,61 @@ def CPlot(DataInfos, PlotSettings, FitFunctions, FitSettings):
     SaveParamsAsLatex(FitsParams, LocalDataPath)
     plt.savefig(LocalDataPath+"\\plot.png", dpi=50)
 
+    if PlotSettings.get("LiveUpdate") and PlotSettings["Projection"] != "polar":
+        def Refit(Data):
+            # Replace the fit lines of the last fit, called by the live update with the grown columns
+            nonlocal FitLines
+            for Line in FitLines: Line.remove()
+            Before = set(Line for ax in fig.get_axes() for Line in ax.lines)
+            Lines = {}
+            FitIDs, Underground, MeanLine, FitsParams, _ = AddFits(DataInfos, FitSettings, Data, Lines=Lines, Cached=False)
+            FitLines = [Line for ax in fig.get_axes() for Line in ax.lines if Line not in Before]
+            CreateLegend(PlotSettings, ScatterIDs, FitIDs, Underground, MeanLine)
+            SaveParamsAsLatex(FitsParams, LocalDataPath)
+            if Drawn and Drawn["Figure"] is fig:
+                Drawn.update(FitIDs=FitIDs, Underground=Underground, MeanLine=MeanLine, Lines=Lines)
+
+        Fixed = (bool(PlotSettings["xLimit"]), bool(PlotSettings["yLimit"]))
+        Sources = set(SeriesSource(DataInfos, i) for i in range(NumSeries(DataInfos)))
+        live.Start(fig, Sources, Series, Refit if FitSettings["NumFits"] > 0 else None, Fixed)
+
     return OutErr
 
+def FitSetting(FitSettings, Key, i, Default):
+    # Setting of fit i as AddFits passes it to ApplyFit
+    Value = FitSettings.get(Key)
+    if Value is None: return Default
+    return Value[i] if type(Value) == list else Value
+
+def Restyle(DataInfos, PlotSettings, FitSettings):
+    # Change the fit line styles and the legend of the open figure of the last plot in place,
+    # the settings differ from that plot only there. Returns False if the figure was closed or
+    # its data files changed since, CPlot has to draw it again then.
+    if not Drawn or not plt.fignum_exists(Drawn["Figure"].number): return False
+    Sources = [data_cache.TableKey(*SeriesSource(DataInfos, i)) for i in range(NumSeries(DataInfos))]
+    if Sources != FitSources: return False
+
+    for i, Lines in Drawn["Lines"].items():
+        for Line in Lines:
+            Line.set_color(FitSetting(FitSettings, "Color", i, "blue"))
+            Line.set_linestyle(LineStyle(FitSetting(FitSettings, "Line", i, "-")))
+            Line.set_linewidth(FitSetting(FitSettings, "FitLinewidth", i, 3))
+    plt.figure(Drawn["Figure"].number)
+    plt.sca(Drawn["Axes"])
+    CreateLegend(PlotSettings, Drawn["ScatterIDs"], Drawn["FitIDs"], Drawn["Underground"], Drawn["MeanLine"])
+    Drawn["Figure"].canvas.draw_idle()
+    plt.savefig(os.getenv('LOCALAPPDATA') + "\\Ezodox\\EzPlot\\plot.png", dpi=50)
+    return True
+
 def ShowPlot():
-    plt.show()
+    # Without waiting for the window to be closed, PumpFigures keeps it responsive
+    plt.show(block=False)
+
+def PumpFigures():
+    # Process the window events of the open figures, called by the Python thread between its jobs
+    for Manager in Gcf.get_all_fig_managers(): Manager.canvas.flush_events()
+
+def CloseFigures():
+    live.Stop()
+    plt.close("all")
 
@@ -0,0 +1,180 @@
+# Binary columnar sidecar files (.ezc) by Ezodox
+# Parsed columns of a data file are stored next to it as "<data file>.ezc" (or in the local
+# app data folder if that is not writable) and memory mapped the next time the file is opened.
+# A sidecar which is still mapped cannot be replaced on Windows, the new one is written as
+# "<data file>.<n>.ezc" then and the newest valid one is opened.
+#
+# Layout (little-endian):
+#   Header      "EZC\1", version (u32), source size (u64), source mtime in ns (i64),
+#               source hash (16 bytes), directory size (u64)
+#   Directory   UTF-8 JSON: seperator, decimal, rows, all column names and the stored columns
+#               with dtype and offset
+#   Columns     raw values, every column starts at a multiple of 64 bytes
+
+import os
+import json
+import mmap
+import struct
+import hashlib
+import tempfile
+import numpy as np
+
+Magic = b"EZC\x01"
+Version = 1
+Header = struct.Struct("<4sIQq16sQ")
+Alignment = 64
+SampleSize = 1 << 20 # Bytes hashed at start and end of the source file
+Generations = 4 # Names of a sidecar, so it can be rewritten while older ones are mapped
+
+def SourceHash(Path, Size):
+    # Hash of the first and last MiB, a full hash would cost as much as parsing
+    Hash = hashlib.blake2b(digest_size=16)
+    with open(Path, "rb") as File:
+        Hash.update(File.read(SampleSize))
+        if Size > SampleSize:
+            File.seek(max(SampleSize, Size - SampleSize))
+            Hash.update(File.read(SampleSize))
+    return Hash.digest()
+
+def Locations(Path):
+    # Next to the data file first, then in the cache folder of EzPlot
+    Path = os.path.abspath(Path)
+    AppData = os.environ.get("LOCALAPPDATA", os.path.join(os.path.expanduser("~"), ".cache"))
+    Name = hashlib.blake2b(os.path.normcase(Path).encode("utf-8"), digest_size=16).hexdigest()
+    return [Path + ".ezc", os.path.join(AppData, "Ezodox", "EzPlot", "Cache", Name + ".ezc")]
+
+def SidecarNames(SidecarPath):
+    # The sidecar path and the names used while it is mapped
+    Base = SidecarPath[:-len(".ezc")]
+    return [SidecarPath] + ["{0}.{1}.ezc".format(Base, Number) for Number in range(1, Generations)]
+
+def ModifiedTime(SidecarPath):
+    try: return os.stat(SidecarPath).st_mtime_ns
+    except OSError: return -1
+
+class Streamed:
+    # Column which is written in parts while it is parsed, only its length and type are known in advance
+    def __init__(self, Rows, Type):
+        self.Rows, self.dtype = Rows, np.dtype(Type)
+
+    def __len__(self):
+        return self.Rows
+
+def Storable(Values):
+    if isinstance(Values, Streamed): return True
+    return isinstance(Values, np.ndarray) and Values.ndim == 1 and Values.dtype.kind in "biufmM"
+
+class Sidecar:
+    def __init__(self, Map, Directory):
+        self.Map = Map
+        self.Rows = Directory["Rows"]
+        self.Names = Directory["Names"]
+        self.Stored = {Column["Name"]: Column for Column in Directory["Columns"]}
+
+    def Complete(self):
+        return all(Name in self.Stored for Name in self.Names)
+
+    def Column(self, Name):
+        # Read-only view on the mapped file
+        Column = self.Stored[Name]
+        if self.Rows == 0: return np.empty(0, dtype=Column["Type"])
+        return np.frombuffer(self.Map, dtype=Column["Type"], count=self.Rows, offset=Column["Offset"])
+
+def ReadSidecar(SidecarPath, Stat, Hash, Seperator, Decimal):
+    # The file is closed after mapping, the map alone keeps it open
+    with open(SidecarPath, "rb") as File:
+        Start = File.read(Header.size)
+        if len(Start) != Header.size: raise ValueError("Truncated sidecar")
+        FileMagic, FileVersion, Size, Mtime, FileHash, DirectorySize = Header.unpack(Start)
+        if (FileMagic, FileVersion, Size, Mtime) != (Magic, Version, Stat.st_size, Stat.st_mtime_ns):
+            raise ValueError("Outdated sidecar")
+        if FileHash != Hash(): raise ValueError("Outdated sidecar")
+        Directory = json.loads(File.read(DirectorySize).decode("utf-8"))
+        if (Directory["Seperator"], Directory["Decimal"]) != (Seperator, Decimal):
+            raise ValueError("Sidecar of other CSV settings")
+        Map = mmap.mmap(File.fileno(), 0, access=mmap.ACCESS_READ)
+    return Sidecar(Map, Directory)
+
+def Open(Path, Seperator, Decimal):
+    # Returns the sidecar of the data file or None if there is no valid one
+    Stat = os.stat(Path)
+    Hashes = []
+    def Hash():
+        if not Hashes: Hashes.append(SourceHash(Path, Stat.st_size))
+        return Hashes[0]
+    for SidecarPath in Locations(Path):
+        Found = sorted((Name for Name in SidecarNames(SidecarPath) if os.path.exists(Name)), key=ModifiedTime, reverse=True)
+        for Index, Name in enumerate(Found):
+            try:
+                Opened = ReadSidecar(Name, Stat, Hash, Seperator, Decimal)
+            except (OSError, ValueError, KeyError):
+                continue
+            # Older ones are left over from rewrites, those still mapped are removed next time
+            for Other in Found[:Index] + Found[Index + 1:]:
+                try: os.remove(Other)
+                except OSError: pass
+            return Opened
+    return None
+
+def Write(Path, Seperator, Decimal, Names, Columns, Parts=()):
+    # Store all storable columns of the data file, returns False if no location is writable.
+    # Parts: (first row, {name: values}) of the Streamed columns, written at their place in the file
+    # as they come, so a column never has to be in memory at once. Parts can only be consumed once,
+    # so any error after it was started (also one raised while it is produced) is passed on.
+    Stat = os.stat(Path)
+    Columns = {Name: Values for Name, Values in Columns.items() if Storable(Values)}
+    Rows = len(next(iter(Columns.values()))) if Columns else 0
+
+    Directory = {"Seperator": Seperator, "Decimal": Decimal, "Rows": Rows, "Names": list(Names), "Columns": []}
+    # Offsets depend on the directory size, so grow the reserved space until it fits
+    Reserved = 4096
+    while True:
+        Offset = Header.size + Reserved
+        Directory["Columns"] = []
+        for Name, Values in Columns.items():
+            Offset = -(-Offset // Alignment) * Alignment
+            Type = Values.dtype.newbyteorder("<").str
+            Directory["Columns"].append({"Name": Name, "Type": Type, "Offset": Offset})
+            Offset += Rows * Values.dtype.itemsize
+        Encoded = json.dumps(Directory).encode("utf-8")
+        if len(Encoded) <= Reserved: break
+        Reserved = -(-len(Encoded) // 4096) * 4096
+
+    Start = Header.pack(Magic, Version, Stat.st_size, Stat.st_mtime_ns, SourceHash(Path, Stat.st_size), len(Encoded))
+    Streaming = any(isinstance(Values, Streamed) for Values in Columns.values())
+    for SidecarPath in Locations(Path):
+        try:
+            os.makedirs(os.path.dirname(SidecarPath), exist_ok=True)
+            Handle, TempPath = tempfile.mkstemp(suffix=".tmp", dir=os.path.dirname(SidecarPath))
+        except OSError:
+            continue
+        Started = False
+        try:
+            with os.fdopen(Handle, "wb") as File:
+                File.write(Start)
+                File.write(Encoded)
+                for Column, Values in zip(Directory["Columns"], Columns.values()):
+                    if isinstance(Values, Streamed): continue
+                    File.seek(Column["Offset"])
+                    np.ascontiguousarray(Values, dtype=Column["Type"]).tofile(File)
+                File.truncate(Offset) # Streamed columns are filled with zeros until their parts arrive
+                Stored = {Column["Name"]: Column for Column in Directory["Columns"]}
+                Started = Streaming
+                for First, Part in Parts:
+                    for Name, Values in Part.items():
+                        File.seek(Stored[Name]["Offset"] + First * Columns[Name].dtype.itemsize)
+                        np.ascontiguousarray(Values, dtype=Stored[Name]["Type"]).tofile(File)
+        except BaseException as Error:
+            os.remove(TempPath)
+            # The next location would get the remaining parts only
+            if Started or not isinstance(Error, OSError): raise
+            continue
+        for Name in SidecarNames(SidecarPath):
+            try:
+                os.replace(TempPath, Name)
+                return True
+            except OSError: # Still mapped on Windows, the next name is taken
+                continue
+        os.remove(TempPath)
+        return False
+    return False
@@ -0,0 +1,122 @@
+// Settings conversion leak test by Ezodox
+// Converts settings maps with every type of SettingValue to Python again and again and moves the
+// results through PyRef, then checks that the total reference count (debug builds of Python) and
+// the memory of the process stay flat. Counterpart of leak_test.py, which checks the plots.
+//
+// Build next to the EzPlot sources, e.g. with MSVC:
+//   cl /std:c++20 /EHsc /I.. /I<python>\include leak_driver.cpp ..\SettingValue.cpp ..\PyUtils.cpp /link /LIBPATH:<python>\libs
+// or with GCC:
+//   g++ -std=c++20 -I.. $(python3-config --includes) leak_driver.cpp ../SettingValue.cpp ../PyUtils.cpp $(python3-config --ldflags --embed)
+//
+// Usage: leak_driver [conversions, default 100000]
+
+#include "PyUtils.h"
+#include "SettingValue.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+static const int WarmUp = 1000; // Conversions before the first measurement
+static const double MaxGrowthMB = 5; // Allowed growth of the resident memory over all conversions
+
+// Resident memory of the process:
+static double ResidentMB() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS Counters;
+	if (not GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters))) { return 0; }
+	return Counters.WorkingSetSize / 1048576.0;
+#else
+	std::ifstream Statm("/proc/self/statm");
+	long Pages = 0, Resident = 0;
+	Statm >> Pages >> Resident;
+	return Resident * sysconf(_SC_PAGE_SIZE) / 1048576.0;
+#endif
+}
+
+// sys.gettotalrefcount(), -1 if Python is no debug build:
+static long TotalRefs() {
+	PyObject* Count = PySys_GetObject("gettotalrefcount");
+	if (!Count) { return -1; }
+	PyRef Result(PyObject_CallObject(Count, NULL));
+	return Result ? PyLong_AsLong(Result.Get()) : -1;
+}
+
+static SettingsMap AllTypes() {
+	SettingsMap Settings;
+	Settings["None"] = std::monostate();
+	Settings["Bool"] = true;
+	Settings["Int"] = 3;
+	Settings["Long"] = 4L;
+	Settings["Double"] = 0.5;
+	Settings["String"] = std::string("x");
+	Settings["WString"] = std::wstring(L"y");
+	Settings["Range"] = std::make_tuple(1.0, 2.0);
+	Settings["Array"] = NumericArray(std::make_shared<const std::vector<double>>(1000, 1.5));
+	Settings["Bools"] = std::vector<bool>{ true, false };
+	Settings["Longs"] = std::vector<long>{ 1, 2 };
+	Settings["Doubles"] = std::vector<double>{ 1, 2, 3 };
+	Settings["Strings"] = std::vector<std::string>{ "a", "b" };
+	Settings["WStrings"] = std::vector<std::wstring>{ L"a", L"b" };
+	Settings["Ranges"] = std::vector<std::tuple<double, double>>{ { 1, 2 }, { 3, 4 } };
+	Settings["Limits"] = std::vector<std::tuple<std::optional<double>, std::optional<double>>>{ { 1.0, std::nullopt } };
+	Settings["Pairs"] = std::vector<std::tuple<std::string, std::string>>{ { "a", "b" } };
+	Settings["Matrix"] = std::vector<std::vector<double>>{ { 1, 2 }, { 3 } };
+	Settings["Areas"] = std::vector<std::vector<std::tuple<double, double>>>{ { { 1, 2 } } };
+	Settings["Cube"] = std::vector<std::vector<std::vector<double>>>{ { { 1 } } };
+	Settings["Map"] = std::unordered_map<std::wstring, std::wstring>{ { L"a", L"b" } };
+	Settings["Lists"] = std::unordered_map<std::wstring, std::vector<std::wstring>>{ { L"a", { L"b", L"c" } } };
+	return Settings;
+}
+
+// One conversion, the result goes through every way a PyRef hands on its reference:
+static bool Convert(const SettingsMap& Settings) {
+	PyRef Dict(SettingsToPy(Settings));
+	if (!Dict) { return false; }
+	PyRef Moved(std::move(Dict));
+	PyRef Assigned;
+	Assigned = std::move(Moved);
+	PyRef Borrowed = PyRef::Borrow(PyDict_GetItemString(Assigned.Get(), "Array"));
+	PyRef Stolen(PyTuple_New(1));
+	if (!Stolen) { return false; }
+	PyTuple_SET_ITEM(Stolen.Get(), 0, Assigned.Release());
+	Borrowed.Reset(PyLong_FromLong(1));
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	int Conversions = argc > 1 ? std::atoi(argv[1]) : 100000;
+	Py_Initialize();
+	int Result = 0;
+	{
+		PyLock Lock;
+		SettingsMap Settings = AllTypes();
+		for (int i = 0; i < WarmUp; i++) { Convert(Settings); }
+		double Memory = ResidentMB();
+		long Refs = TotalRefs();
+		for (int i = 0; i < Conversions; i++) {
+			if (not Convert(Settings)) {
+				PyErr_Print();
+				return 1;
+			}
+		}
+		double Growth = ResidentMB() - Memory;
+		std::printf("Resident memory grew by %.1f MB over %d conversions\n", Growth, Conversions);
+		if (Growth > MaxGrowthMB) { Result = 1; }
+		if (Refs < 0) { std::printf("No reference count, Python is no debug build\n"); }
+		else {
+			long RefGrowth = TotalRefs() - Refs;
+			std::printf("Total reference count grew by %ld over %d conversions\n", RefGrowth, Conversions);
+			if (RefGrowth > 100) { Result = 1; }
+		}
+	}
+	if (Result) { std::printf("Leak found\n"); }
+	Py_Finalize();
+	return Result;
+}
@@ -0,0 +1,106 @@
+# Plot leak test by Ezodox
+# Draws the same plot with fits again and again with the Agg backend (no window) and checks that
+# the memory of the process and, on debug builds of Python, the total reference count stay flat.
+# The fit cache is cleared before every plot, so every plot fits and prints the residuals again.
+# Exits with an error if neither the memory nor the reference count can be read.
+# Counterpart of leak_driver.cpp, which checks the conversion of the settings in C++.
+#
+# Usage: python leak_test.py [plots, default 1000]
+
+import os
+import sys
+import gc
+import tempfile
+import numpy as np
+import matplotlib
+matplotlib.use("Agg")
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+Directory = tempfile.mkdtemp()
+os.environ["LOCALAPPDATA"] = Directory # plot.png and the parameter files of CPlot go there
+from python_modules import plot
+from python_modules import fit_cache
+
+WarmUp = 50 # Plots before the first measurement, caches and fonts fill up until then
+MaxGrowthMB = 20 # Allowed growth of the resident memory over all measured plots
+MaxRefsPerPlot = 1 # Allowed growth of the total reference count per plot (debug builds)
+
+def ResidentMB():
+    # Resident memory of the process, None if it cannot be read here
+    try:
+        import psutil
+        return psutil.Process().memory_info().rss / 1024**2
+    except ImportError:
+        pass
+    try:
+        with open("/proc/self/statm") as File: return int(File.read().split()[1]) * os.sysconf("SC_PAGE_SIZE") / 1024**2
+    except (OSError, ValueError, AttributeError):
+        return None
+
+def TotalRefs():
+    # Only debug builds of Python count the references
+    return sys.gettotalrefcount() if hasattr(sys, "gettotalrefcount") else None
+
+def WriteData(Path):
+    x = np.linspace(0, 10, 2000)
+    y = plot.GaussPDF(x, 3, 1, 5) + 0.1 * x + np.random.default_rng(1).normal(0, 0.01, x.size)
+    with open(Path, "w") as File:
+        File.write("x;y\n")
+        for Row in zip(x, y): File.write("{0};{1}\n".format(*Row))
+
+def Settings(Path):
+    DataInfos = {"Path": Path, "Seperator": ";", "Decimal": ".", "xColumns": "x", "yColumns": "y",
+                 "xErrorColumns": "[NULL]", "yErrorColumns": "[NULL]"}
+    PlotSettings = {Key: None for Key in ["FigWidth", "FigHeight", "Zoom", "ZoomHelpLines", "Projection",
+        "mColors", "mSizes", "mStyles", "mOrders", "mAlphas", "mConnects", "ErrWidths", "ErrCapsizes",
+        "xLimit", "yLimit", "LogScaleX", "LogScaleY", "LogScaleBaseX", "LogScaleBaseY", "SciStyleX",
+        "SciStyleY", "SciStyleXZoom", "SciStyleYZoom", "LabelSize", "TickLabelSize", "TickDirection",
+        "MajorTickLength", "MajorTickWidth", "MajorTicksPeriodX", "MajorTicksPeriodY", "MajorTicksPeriodXZoom",
+        "MajorTicksPeriodYZoom", "MinorTicksX", "MinorTicksY", "MinorTicksPeriodX", "MinorTicksPeriodY",
+        "MinorTickLength", "MinorTickWidth", "LegendRelX", "LegendRelY", "LegendFontsize",
+        "LegendHandlelength", "LegendMarkerscale"]}
+    PlotSettings.update(RemoveMajorXTicks=[], RemoveMajorYTicks=[], RemoveMinorXTicks=[], RemoveMinorYTicks=[],
+        LegendLabels=["Data", "Gauss", "Line"], LegendOrder=["Data 1", "Fit 1", "Fit 2"], LabelX="x", LabelY="y")
+    FitSettings = {"NumFits": 2, "sParams": [[3, 1, 5], [0.1, 0]], "Name": ["Gauss", "Line"],
+        "Area": [(None, None), (7.0, 10.0)], "Color": ["red", "blue"], "pRes": [True, False],
+        "LatexFuncs": {"GaussPDF": "g", "Linear": "l"}, "LatexParams": {"GaussPDF": ["A", "S", "E"], "Linear": ["A", "B"]}}
+    return DataInfos, PlotSettings, FitSettings
+
+def Plot(DataInfos, PlotSettings, FitSettings):
+    # Copies, CPlot adds the fit functions to the fit settings. Without cached results every fit
+    # runs the solver and the statistics again.
+    fit_cache.Clear()
+    with open(os.devnull, "w") as Null:
+        Stdout, sys.stdout = sys.stdout, Null
+        try: Result = plot.CPlot(dict(DataInfos), dict(PlotSettings), [plot.GaussPDF, plot.Linear], dict(FitSettings))
+        finally: sys.stdout = Stdout
+    plot.plt.close("all")
+    return Result
+
+def main():
+    Plots = int(sys.argv[1]) if len(sys.argv) > 1 else 1000
+    Path = os.path.join(Directory, "leak_test.csv")
+    WriteData(Path)
+    Args = Settings(Path)
+    for i in range(WarmUp): Plot(*Args)
+    gc.collect()
+    Memory, Refs = ResidentMB(), TotalRefs()
+    for i in range(Plots):
+        if Plot(*Args) != 1: sys.exit("Plot {0} failed".format(i))
+    gc.collect()
+    if Memory is None and Refs is None:
+        sys.exit("Neither the resident memory nor the reference count can be read here, install psutil")
+    Failed = False
+    if Memory is None: print("Resident memory cannot be read here, install psutil")
+    else:
+        Growth = ResidentMB() - Memory
+        print("Resident memory grew by {0:.1f} MB over {1} plots".format(Growth, Plots))
+        Failed |= Growth > MaxGrowthMB
+    if Refs is None: print("No reference count, Python is no debug build")
+    else:
+        Growth = TotalRefs() - Refs
+        print("Total reference count grew by {0} over {1} plots".format(Growth, Plots))
+        Failed |= Growth > MaxRefsPerPlot * Plots
+    sys.exit("Leak found" if Failed else 0)
+
+if __name__ == "__main__":
+    main()
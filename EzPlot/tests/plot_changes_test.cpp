@@ -0,0 +1,92 @@
+// Plot change classification test by Ezodox
+// Checks which settings changes ClassifyChanges lets plot the figure again, refit some fits,
+// draw it again with the last fit results or only restyle the open figure.
+//
+// Build next to the EzPlot sources, e.g. with MSVC:
+//   cl /std:c++20 /EHsc /I.. /I<python>\include plot_changes_test.cpp ..\PlotChanges.cpp ..\SettingValue.cpp ..\PyUtils.cpp /link /LIBPATH:<python>\libs
+// or with GCC:
+//   g++ -std=c++20 -I.. $(python3-config --includes) plot_changes_test.cpp ../PlotChanges.cpp ../SettingValue.cpp ../PyUtils.cpp $(python3-config --ldflags --embed)
+
+#include "PlotChanges.h"
+#include <cstdio>
+#include <string>
+
+static int Failures = 0;
+
+static void Check(const char* Name, const PlotChanges& Changes, PlotUpdate Update,
+	const std::vector<long>& Refits = {}) {
+	if (Changes.Update == Update and Changes.Refits == Refits) { return; }
+	std::printf("%s: update %d with %zu refits\n", Name, static_cast<int>(Changes.Update), Changes.Refits.size());
+	Failures++;
+}
+
+static PlotState Plot() {
+	PlotState State;
+	State.DataInfos["Path"] = std::wstring(L"data.csv");
+	State.DataInfos["yColumns"] = std::string("y");
+	State.PlotSettings["SinglePrecision"] = false;
+	State.PlotSettings["LabelX"] = std::string("x");
+	State.PlotSettings["LegendRelX"] = 0.5;
+	State.PlotSettings["LegendLabels"] = std::vector<std::string>{ "Data", "Gauss", "Line" };
+	State.FitSettings["NumFits"] = 2L;
+	State.FitSettings["sParams"] = std::vector<std::vector<double>>{ { 3, 1, 5 }, { 0.1, 0 } };
+	State.FitSettings["Area"] = std::vector<std::tuple<double, double>>{ { 0, 5 }, { 7, 10 } };
+	State.FitSettings["Color"] = std::vector<std::string>{ "red", "blue" };
+	State.FitSettings["Line"] = std::vector<std::string>{ "-", "--" };
+	State.FitSettings["Name"] = std::vector<std::string>{ "Gauss", "Line" };
+	State.FitSettings["MaxIter"] = 1000L;
+	State.FitFunctions = { "GaussPDF", "Linear" };
+	return State;
+}
+
+int main() {
+	const PlotState Last = Plot();
+
+	Check("No last plot", ClassifyChanges(PlotState(), Last), PlotUpdate::Full);
+	Check("Unchanged", ClassifyChanges(Last, Last), PlotUpdate::Restyle);
+
+	PlotState Next = Plot();
+	Next.DataInfos["yColumns"] = std::string("z");
+	Check("Other data", ClassifyChanges(Last, Next), PlotUpdate::Full);
+
+	Next = Plot();
+	Next.PlotSettings["SinglePrecision"] = true;
+	Check("Precision", ClassifyChanges(Last, Next), PlotUpdate::Full);
+
+	Next = Plot();
+	Next.FitSettings["MaxIter"] = 2000L;
+	Check("Setting of all fits", ClassifyChanges(Last, Next), PlotUpdate::Full);
+
+	Next = Plot();
+	Next.FitSettings["Area"] = std::vector<std::tuple<double, double>>{ { 0, 5 }, { 6, 10 } };
+	Check("Fit area", ClassifyChanges(Last, Next), PlotUpdate::Refit, { 1 });
+
+	Next = Plot();
+	Next.FitFunctions = { "Linear", "Linear" };
+	Next.FitSettings["sParams"] = std::vector<std::vector<double>>{ { 3, 1, 5 }, { 0.2, 0 } };
+	Next.FitSettings["Color"] = std::vector<std::string>{ "red", "green" };
+	Check("Function and parameters", ClassifyChanges(Last, Next), PlotUpdate::Refit, { 0, 1 });
+
+	Next = Plot();
+	Next.FitSettings["Name"] = std::vector<std::string>{ "Gauss", "Background" };
+	Check("Fit name", ClassifyChanges(Last, Next), PlotUpdate::Redraw);
+
+	Next = Plot();
+	Next.PlotSettings["LabelX"] = std::string("Time");
+	Check("Axis label", ClassifyChanges(Last, Next), PlotUpdate::Redraw);
+
+	Next = Plot();
+	Next.FitSettings["Color"] = std::vector<std::string>{ "red", "green" };
+	Next.FitSettings["Line"] = std::vector<std::string>{ ":", "--" };
+	Next.FitSettings["FitLinewidth"] = 5L;
+	Check("Fit line style", ClassifyChanges(Last, Next), PlotUpdate::Restyle);
+
+	Next = Plot();
+	Next.PlotSettings["LegendRelX"] = 0.1;
+	Next.PlotSettings["LegendLabels"] = std::vector<std::string>{ "Data", "Peak", "Line" };
+	Check("Legend", ClassifyChanges(Last, Next), PlotUpdate::Restyle);
+
+	if (Failures) { std::printf("%d checks failed\n", Failures); }
+	else { std::printf("All checks passed\n"); }
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+# Redraw output test by Ezodox
+# Plots with fits and printed residuals, then draws the plot again with the last fit results (all
+# or only some fits reused) and checks that the console output stays the same. The residuals are
+# not stored with the results, they have to be printed again from the parameters.
+#
+# Usage: python redraw_output_test.py
+
+import io
+import os
+import sys
+import contextlib
+from leak_test import plot, Directory, Settings, WriteData
+
+def Output(DataInfos, PlotSettings, FitSettings, Refits):
+    Printed = io.StringIO()
+    with contextlib.redirect_stdout(Printed):
+        Result = plot.CPlot(dict(DataInfos), dict(PlotSettings), [plot.GaussPDF, plot.Linear], dict(FitSettings), Refits)
+    plot.plt.close("all")
+    if Result != 1: sys.exit("Plot failed:\n" + Printed.getvalue())
+    return Printed.getvalue()
+
+def main():
+    Path = os.path.join(Directory, "redraw_output_test.csv")
+    WriteData(Path)
+    DataInfos, PlotSettings, FitSettings = Settings(Path)
+    FitSettings["pRes"] = [True, True]
+    Fitted = Output(DataInfos, PlotSettings, FitSettings, None)
+    if Fitted.count("Residuals") != 2: sys.exit("The residuals of the fits are missing")
+    Failed = False
+    for Name, Refits in [("Redraw", []), ("Refit of fit 2", [1]), ("Fit again", None)]:
+        Printed = Output(DataInfos, PlotSettings, FitSettings, Refits)
+        print("{0}: {1} of {2} characters printed".format(Name, len(Printed), len(Fitted)))
+        Failed |= Printed != Fitted
+    sys.exit("Output changed" if Failed else 0)
+
+if __name__ == "__main__":
+    main()